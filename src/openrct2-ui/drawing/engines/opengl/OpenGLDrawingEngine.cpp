@@ -33,6 +33,7 @@
 #    include <openrct2/drawing/IDrawingEngine.h>
 #    include <openrct2/drawing/LightFX.h>
 #    include <openrct2/drawing/Rain.h>
+#    include <openrct2/drawing/SpriteCache.h>
 #    include <openrct2/interface/Screenshot.h>
 #    include <openrct2/ui/UiContext.h>
 #    include <unordered_map>
@@ -378,6 +379,7 @@ public:
     void InvalidateImage(uint32_t image) override
     {
         _drawingContext->GetTextureCache()->InvalidateImage(image);
+        SpriteCache::Get().Invalidate(image);
     }
 
     rct_drawpixelinfo* GetDPI()
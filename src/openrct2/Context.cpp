@@ -20,6 +20,7 @@
 #include "Input.h"
 #include "Intro.h"
 #include "OpenRCT2.h"
+#include "ParkFile.h"
 #include "ParkImporter.h"
 #include "PlatformEnvironment.h"
 #include "ReplayManager.h"
@@ -34,6 +35,7 @@
 #include "core/FileStream.hpp"
 #include "core/Guard.hpp"
 #include "core/Http.h"
+#include "core/MemoryMappedFile.h"
 #include "core/MemoryStream.h"
 #include "core/Path.hpp"
 #include "core/String.hpp"
@@ -64,6 +66,7 @@
 #include "ui/WindowManager.h"
 #include "util/Util.h"
 #include "world/Park.h"
+#include "world/Sprite.h"
 
 #include <algorithm>
 #include <cmath>
@@ -158,6 +161,7 @@ namespace OpenRCT2
             GameActions::ClearQueue();
             network_close();
             window_close_all();
+            game_autosave_wait();
 
             // Unload objects after closing all windows, this is to overcome windows like
             // the object selection window which loads objects when closed.
@@ -541,6 +545,14 @@ namespace OpenRCT2
             log_verbose("Context::LoadParkFromFile(%s)", path.c_str());
             try
             {
+                if (ParkFileReader::IsParkFile(path))
+                {
+                    // Park files are read in place from a mapping of the file
+                    auto mappedFile = MemoryMappedFile(path);
+                    auto ms = MemoryStream(mappedFile.GetData(), mappedFile.GetLength());
+                    return LoadParkFromStream(&ms, path, loadTitleScreenOnFail);
+                }
+
                 auto fs = FileStream(path, FILE_MODE_OPEN);
                 return LoadParkFromStream(&fs, path, loadTitleScreenOnFail);
             }
@@ -576,6 +588,8 @@ namespace OpenRCT2
                             stream, info.Type == FILE_TYPE::SCENARIO, false, path.c_str());
                         _objectManager->LoadObjects(result.RequiredObjects.data(), result.RequiredObjects.size());
                         parkImporter->Import();
+                        // Parks loaded by the player (or a server) may use more sprites than they were saved with.
+                        sprite_set_limit(gConfigGeneral.sprite_limit);
                         gScenarioSavePath = path;
                         gCurrentLoadedPath = path;
                         gFirstTimeSaving = true;
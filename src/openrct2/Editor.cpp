@@ -15,6 +15,7 @@
 #include "Game.h"
 #include "GameState.h"
 #include "OpenRCT2.h"
+#include "ParkFile.h"
 #include "ParkImporter.h"
 #include "actions/LandBuyRightsAction.hpp"
 #include "actions/LandSetRightsAction.hpp"
@@ -221,6 +222,7 @@ namespace Editor
         {
             case FILE_EXTENSION_SC6:
             case FILE_EXTENSION_SV6:
+            case FILE_EXTENSION_PARK:
                 return ReadS6(path);
             case FILE_EXTENSION_SC4:
                 return LoadLandscapeFromSC4(path);
@@ -270,10 +272,22 @@ namespace Editor
     static bool ReadS6(const char* path)
     {
         auto extension = path_get_extension(path);
+        ClassifiedFileInfo info;
         if (_stricmp(extension, ".sc6") == 0)
         {
             load_from_sc6(path);
         }
+        else if (ParkFile::ExtensionIsParkFile(extension) && TryClassifyFile(path, &info))
+        {
+            if (info.Type == FILE_TYPE::SCENARIO)
+            {
+                load_from_sc6(path);
+            }
+            else
+            {
+                load_from_sv6(path);
+            }
+        }
         else if (_stricmp(extension, ".sv6") == 0 || _stricmp(extension, ".sv7") == 0)
         {
             load_from_sv6(path);
@@ -307,7 +321,7 @@ namespace Editor
         ride_init_all();
 
         //
-        for (int32_t i = 0; i < MAX_SPRITES; i++)
+        for (int32_t i = 0; i < sprite_get_capacity(); i++)
         {
             auto peep = GetEntity<Peep>(i);
             if (peep != nullptr)
@@ -9,6 +9,7 @@
 
 #include "FileClassifier.h"
 
+#include "ParkFile.h"
 #include "core/Console.hpp"
 #include "core/FileStream.hpp"
 #include "core/Path.hpp"
@@ -16,6 +17,7 @@
 #include "scenario/Scenario.h"
 #include "util/SawyerCoding.h"
 
+static bool TryClassifyAsPark(IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsS6(IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsS4(IStream* stream, ClassifiedFileInfo* result);
 static bool TryClassifyAsTD4_TD6(IStream* stream, ClassifiedFileInfo* result);
@@ -40,6 +42,12 @@ bool TryClassifyFile(IStream* stream, ClassifiedFileInfo* result)
     //      between them is to decode it. Decoding however is currently not protected
     //      against invalid compression data for that decoding algorithm and will crash.
 
+    // Park file detection
+    if (TryClassifyAsPark(stream, result))
+    {
+        return true;
+    }
+
     // S6 detection
     if (TryClassifyAsS6(stream, result))
     {
@@ -61,6 +69,32 @@ bool TryClassifyFile(IStream* stream, ClassifiedFileInfo* result)
     return false;
 }
 
+static bool TryClassifyAsPark(IStream* stream, ClassifiedFileInfo* result)
+{
+    if (!ParkFileReader::IsParkFile(stream))
+    {
+        return false;
+    }
+
+    bool success = false;
+    uint64_t originalPosition = stream->GetPosition();
+    try
+    {
+        rct_s6_header s6Header;
+        auto reader = ParkFileReader(stream);
+        reader.ReadSection(ParkFileSection::S6Header, &s6Header, sizeof(s6Header));
+        result->Type = s6Header.type == S6_TYPE_SCENARIO ? FILE_TYPE::SCENARIO : FILE_TYPE::SAVED_GAME;
+        result->Version = s6Header.version;
+        success = true;
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose(e.what());
+    }
+    stream->SetPosition(originalPosition);
+    return success;
+}
+
 static bool TryClassifyAsS6(IStream* stream, ClassifiedFileInfo* result)
 {
     bool success = false;
@@ -181,5 +215,7 @@ uint32_t get_file_extension_type(const utf8* path)
         return FILE_EXTENSION_SV6;
     if (String::Equals(extension, ".td6", true))
         return FILE_EXTENSION_TD6;
+    if (String::Equals(extension, PARK_FILE_EXTENSION, true))
+        return FILE_EXTENSION_PARK;
     return FILE_EXTENSION_UNKNOWN;
 }
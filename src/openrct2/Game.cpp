@@ -40,6 +40,7 @@
 #include "peep/Staff.h"
 #include "platform/Platform2.h"
 #include "rct1/RCT1.h"
+#include "rct2/S6Exporter.h"
 #include "ride/Ride.h"
 #include "ride/RideRatings.h"
 #include "ride/Station.h"
@@ -67,9 +68,13 @@
 #include "world/Water.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <string>
 
 uint16_t gCurrentDeltaTime;
 uint8_t gGamePaused = 0;
@@ -615,7 +620,7 @@ void game_unload_scripts()
  */
 void reset_all_sprite_quadrant_placements()
 {
-    for (size_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < sprite_get_capacity(); i++)
     {
         auto* spr = GetEntity(i);
         if (spr->sprite_identifier != SPRITE_IDENTIFIER_NULL)
@@ -753,8 +758,44 @@ static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processL
     }
 }
 
+// The autosave that is being written in the background and its progress in percent, -1 when there is none.
+static std::future<void> _autosaveTask;
+static std::atomic<int32_t> _autosaveProgress = { -1 };
+
+bool game_autosave_is_in_progress()
+{
+    return _autosaveTask.valid() && _autosaveTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+int32_t game_autosave_get_progress()
+{
+    return _autosaveProgress;
+}
+
+/**
+ * Blocks until the autosave that is being written has finished.
+ */
+void game_autosave_wait()
+{
+    if (_autosaveTask.valid())
+    {
+        _autosaveTask.wait();
+    }
+}
+
+/**
+ * Takes a snapshot of the game state and writes it to a new autosave on a background thread. Encoding the park is
+ * most of the time a save takes, so the game only stalls for the snapshot. Autosaves are skipped while the previous
+ * one is still being written.
+ */
 void game_autosave()
 {
+    if (game_autosave_is_in_progress())
+    {
+        log_warning("Skipping autosave, the previous autosave is still being written.");
+        return;
+    }
+
     const char* subDirectory = "save";
     const char* fileExtension = ".sv6";
     uint32_t saveFlags = 0x80000000;
@@ -775,7 +816,7 @@ void game_autosave()
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
-    limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
+    bool isLandscape = (gScreenFlags & SCREEN_FLAGS_EDITOR) != 0;
 
     utf8 path[MAX_PATH];
     utf8 backupPath[MAX_PATH];
@@ -788,13 +829,45 @@ void game_autosave()
     safe_strcat(backupPath, fileExtension, sizeof(backupPath));
     safe_strcat(backupPath, ".bak", sizeof(backupPath));
 
-    if (Platform::FileExists(path))
+    std::shared_ptr<S6Exporter> exporter = scenario_save_snapshot(saveFlags);
+    if (exporter == nullptr)
     {
-        platform_file_copy(path, backupPath, true);
+        std::fprintf(stderr, "Could not autosave the scenario. Is the save folder writeable?\n");
+        return;
     }
 
-    if (!scenario_save(path, saveFlags))
-        std::fprintf(stderr, "Could not autosave the scenario. Is the save folder writeable?\n");
+    _autosaveProgress = 0;
+    _autosaveTask = std::async(
+        std::launch::async,
+        [exporter, path = std::string(path), backupPath = std::string(backupPath), autosavesToKeep, isLandscape]() {
+            limit_autosave_count(autosavesToKeep - 1, isLandscape);
+            if (Platform::FileExists(path))
+            {
+                platform_file_copy(path.c_str(), backupPath.c_str(), true);
+            }
+
+            exporter->OnSaveProgress = [](size_t written, size_t total) {
+                _autosaveProgress = static_cast<int32_t>((written * 100) / total);
+            };
+            try
+            {
+                if (isLandscape)
+                {
+                    exporter->SaveScenario(path.c_str());
+                }
+                else
+                {
+                    exporter->SaveGame(path.c_str());
+                }
+                log_verbose("Autosaved to '%s'", path.c_str());
+            }
+            catch (const std::exception& e)
+            {
+                log_error("Unable to save park: '%s'", e.what());
+                std::fprintf(stderr, "Could not autosave the scenario. Is the save folder writeable?\n");
+            }
+            _autosaveProgress = -1;
+        });
 }
 
 static void game_load_or_quit_no_save_prompt_callback(int32_t result, const utf8* path)
@@ -168,6 +168,9 @@ void save_game_as();
 void save_game_cmd(const utf8* name = nullptr);
 void save_game_with_name(const utf8* name);
 void game_autosave();
+bool game_autosave_is_in_progress();
+int32_t game_autosave_get_progress();
+void game_autosave_wait();
 void game_convert_strings_to_utf8();
 void game_convert_news_items_to_utf8();
 void game_convert_strings_to_rct2(rct_s6_data* s6);
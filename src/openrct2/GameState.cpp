@@ -18,6 +18,7 @@
 #include "ReplayManager.h"
 #include "actions/GameAction.h"
 #include "config/Config.h"
+#include "core/Profiler.h"
 #include "interface/Screenshot.h"
 #include "localisation/Date.h"
 #include "localisation/Localisation.h"
@@ -35,8 +36,10 @@
 #include "world/MapAnimation.h"
 #include "world/Park.h"
 #include "world/Scenery.h"
+#include "world/Sprite.h"
 
 #include <algorithm>
+#include <iterator>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
@@ -59,6 +62,7 @@ void GameState::InitAll(int32_t mapSize)
     banner_init();
     ride_init_all();
     reset_sprite_list();
+    sprite_set_limit(gConfigGeneral.sprite_limit);
     staff_reset_modes();
     date_reset();
     climate_reset(CLIMATE_COOL_AND_WET);
@@ -225,15 +229,51 @@ void GameState::Update()
     gInUpdateCode = false;
 }
 
+void GameState::SetStageTimingEnabled(bool enabled)
+{
+    _stageTimingEnabled = enabled;
+    _stageTimes.fill({});
+}
+
+template<typename TFunc> void GameState::UpdateStage(GameUpdateStage stage, TFunc&& func)
+{
+#ifndef DISABLE_PROFILER
+    static constexpr Profiling::ProfileSection StageSections[] = {
+        Profiling::ProfileSection::Network,  Profiling::ProfileSection::MapTiles,    Profiling::ProfileSection::Peeps,
+        Profiling::ProfileSection::Vehicles, Profiling::ProfileSection::MiscSprites, Profiling::ProfileSection::Rides,
+        Profiling::ProfileSection::Park,     Profiling::ProfileSection::RideRatings, Profiling::ProfileSection::GameActions,
+    };
+    static_assert(std::size(StageSections) == static_cast<size_t>(GameUpdateStage::Count));
+    Profiling::ScopedTimer profileTimer(StageSections[static_cast<size_t>(stage)]);
+#endif
+
+    if (!_stageTimingEnabled)
+    {
+        func();
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    func();
+    _stageTimes[static_cast<size_t>(stage)] = std::chrono::steady_clock::now() - startTime;
+}
+
 void GameState::UpdateLogic()
 {
+    PROFILE_SCOPE(Tick);
+
+    if (_stageTimingEnabled)
+    {
+        _stageTimes.fill({});
+    }
+
     gScreenAge++;
     if (gScreenAge == 0)
         gScreenAge--;
 
     GetContext()->GetReplayManager()->Update();
 
-    network_update();
+    UpdateStage(GameUpdateStage::Network, network_update);
 
     if (network_get_mode() == NETWORK_MODE_SERVER)
     {
@@ -280,23 +320,25 @@ void GameState::UpdateLogic()
 
     scenario_update();
     climate_update();
-    map_update_tiles();
+    UpdateStage(GameUpdateStage::MapTiles, map_update_tiles);
     // Temporarily remove provisional paths to prevent peep from interacting with them
     map_remove_provisional_elements();
     map_update_path_wide_flags();
-    peep_update_all();
+    // No sprite lists are being iterated between updates, safe to drop the holes left by removed sprites.
+    sprite_compact_list_index();
+    UpdateStage(GameUpdateStage::Peeps, peep_update_all);
     map_restore_provisional_elements();
-    vehicle_update_all();
-    sprite_misc_update_all();
-    Ride::UpdateAll();
+    UpdateStage(GameUpdateStage::Vehicles, vehicle_update_all);
+    UpdateStage(GameUpdateStage::MiscSprites, sprite_misc_update_all);
+    UpdateStage(GameUpdateStage::Rides, Ride::UpdateAll);
 
     if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
     {
-        _park->Update(_date);
+        UpdateStage(GameUpdateStage::Park, [this]() { _park->Update(_date); });
     }
 
     research_update();
-    ride_ratings_update_all();
+    UpdateStage(GameUpdateStage::RideRatings, ride_ratings_update_all);
     ride_measurements_update();
     news_item_update_current();
 
@@ -315,7 +357,7 @@ void GameState::UpdateLogic()
         gLastAutoSaveUpdate = Platform::GetTicks();
     }
 
-    GameActions::ProcessQueue();
+    UpdateStage(GameUpdateStage::GameActions, GameActions::ProcessQueue);
 
     network_process_pending();
     network_flush();
@@ -11,12 +11,31 @@
 
 #include "Date.h"
 
+#include <array>
+#include <chrono>
 #include <memory>
 
 namespace OpenRCT2
 {
     class Park;
 
+    /**
+     * Stages of UpdateLogic that are timed separately when stage timing is enabled.
+     */
+    enum class GameUpdateStage : uint8_t
+    {
+        Network,
+        MapTiles,
+        Peeps,
+        Vehicles,
+        MiscSprites,
+        Rides,
+        Park,
+        RideRatings,
+        GameActions,
+        Count,
+    };
+
     /**
      * Class to update the state of the map and park.
      */
@@ -25,6 +44,8 @@ namespace OpenRCT2
     private:
         std::unique_ptr<Park> _park;
         Date _date;
+        bool _stageTimingEnabled = false;
+        std::array<std::chrono::nanoseconds, static_cast<size_t>(GameUpdateStage::Count)> _stageTimes{};
 
     public:
         GameState();
@@ -43,7 +64,21 @@ namespace OpenRCT2
         void Update();
         void UpdateLogic();
 
+        /**
+         * Enables measuring the time spent in each GameUpdateStage, off by default to keep the clock out of ticks.
+         */
+        void SetStageTimingEnabled(bool enabled);
+
+        /**
+         * Time spent in the given stage by the last call of UpdateLogic, zero when stage timing is disabled.
+         */
+        std::chrono::nanoseconds GetStageTime(GameUpdateStage stage) const
+        {
+            return _stageTimes[static_cast<size_t>(stage)];
+        }
+
     private:
         void CreateStateSnapshot();
+        template<typename TFunc> void UpdateStage(GameUpdateStage stage, TFunc&& func);
     };
 } // namespace OpenRCT2
@@ -9,29 +9,93 @@
 
 #include "GameStateSnapshots.h"
 
-#include "core/CircularBuffer.h"
+#include "config/Config.h"
 #include "peep/Peep.h"
 #include "world/Sprite.h"
 
-static constexpr size_t MaximumGameStateSnapshots = 32;
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
+static constexpr int32_t DefaultGameStateSnapshotHistory = 32;
 
-struct GameStateSnapshot_t
+// A full snapshot is captured every so many ticks, the ticks in between only store what changed.
+static constexpr uint32_t SnapshotKeyframeInterval = 16;
+
+// Upper limit of snapshots a received delta chain may be made of.
+static constexpr uint32_t MaximumSnapshotChainLength = 1024;
+
+// Changed byte ranges of a sprite that are closer than this are stored as a single range.
+static constexpr size_t SpriteDeltaMergeDistance = 8;
+
+enum class SpriteDeltaType : uint8_t
+{
+    Removed,
+    Replaced,
+    Patched,
+};
+
+/*
+ * Returns the number of bytes of the sprite that are part of the snapshot, sprites with a size of 0 are only
+ * stored by their identifier.
+ */
+static size_t GetSnapshotSpriteSize(const rct_sprite& sprite)
 {
-    GameStateSnapshot_t& operator=(GameStateSnapshot_t&& mv) noexcept
+    switch (sprite.generic.sprite_identifier)
     {
-        tick = mv.tick;
-        storedSprites = std::move(mv.storedSprites);
-        return *this;
+        case SPRITE_IDENTIFIER_VEHICLE:
+            return sizeof(Vehicle);
+        case SPRITE_IDENTIFIER_PEEP:
+            return sizeof(Peep);
+        case SPRITE_IDENTIFIER_LITTER:
+            return sizeof(Litter);
+        case SPRITE_IDENTIFIER_MISC:
+            switch (sprite.generic.type)
+            {
+                case SPRITE_MISC_MONEY_EFFECT:
+                    return sizeof(MoneyEffect);
+                case SPRITE_MISC_BALLOON:
+                    return sizeof(Balloon);
+                case SPRITE_MISC_DUCK:
+                    return sizeof(Duck);
+                case SPRITE_MISC_JUMPING_FOUNTAIN_WATER:
+                    return sizeof(JumpingFountain);
+                case SPRITE_MISC_STEAM_PARTICLE:
+                    return sizeof(SteamParticle);
+            }
+            break;
     }
+    return 0;
+}
 
+static bool IsSameSpriteKind(const rct_sprite& a, const rct_sprite& b)
+{
+    if (a.generic.sprite_identifier != b.generic.sprite_identifier)
+        return false;
+    return a.generic.sprite_identifier != SPRITE_IDENTIFIER_MISC || a.generic.type == b.generic.type;
+}
+
+struct GameStateSnapshot_t
+{
     uint32_t tick = InvalidTick;
     uint32_t srand0 = 0;
 
+    // The full state of all sprites for keyframes, otherwise the sprite changes since the previous snapshot.
     MemoryStream storedSprites;
     MemoryStream parkParameters;
 
-    void SerialiseSprites(rct_sprite* sprites, const size_t numSprites, bool saving)
+    // The snapshot this one is a delta of, null for keyframes.
+    std::shared_ptr<const GameStateSnapshot_t> previous;
+
+    bool IsKeyframe() const
+    {
+        return previous == nullptr;
+    }
+
+    void SerialiseSprites(const std::function<rct_sprite*(const size_t)>& getEntity, const size_t numSprites, bool saving)
     {
         const bool loading = !saving;
 
@@ -47,7 +111,7 @@ struct GameStateSnapshot_t
         {
             for (size_t i = 0; i < numSprites; i++)
             {
-                if (sprites[i].generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+                if (getEntity(i)->generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
                     continue;
                 indexTable.push_back(static_cast<uint32_t>(i));
             }
@@ -66,7 +130,7 @@ struct GameStateSnapshot_t
             ds << indexTable[i];
 
             const uint32_t spriteIdx = indexTable[i];
-            rct_sprite& sprite = sprites[spriteIdx];
+            rct_sprite& sprite = *getEntity(spriteIdx);
 
             ds << sprite.generic.sprite_identifier;
 
@@ -107,6 +171,191 @@ struct GameStateSnapshot_t
             }
         }
     }
+
+    /*
+     * Stores the changes between the previously captured sprites and the current ones, the previous sprites are
+     * updated to the current state.
+     */
+    void WriteSpriteDelta(
+        const std::function<const rct_sprite*(const size_t)>& getEntity, std::vector<rct_sprite>& previousSprites)
+    {
+        storedSprites.SetPosition(0);
+        DataSerialiser ds(true, storedSprites);
+        IStream& stream = ds.GetStream();
+
+        uint32_t numChanges = 0;
+        ds << numChanges;
+
+        std::vector<std::pair<uint16_t, uint16_t>> ranges;
+        for (size_t i = 0; i < previousSprites.size(); i++)
+        {
+            const rct_sprite& sprite = *getEntity(i);
+            rct_sprite& previousSprite = previousSprites[i];
+
+            const size_t size = GetSnapshotSpriteSize(sprite);
+            const auto* data = reinterpret_cast<const uint8_t*>(&sprite);
+            const auto* previousData = reinterpret_cast<const uint8_t*>(&previousSprite);
+
+            uint32_t spriteIdx = static_cast<uint32_t>(i);
+            if (IsSameSpriteKind(sprite, previousSprite))
+            {
+                if (size == 0 || std::memcmp(data, previousData, size) == 0)
+                    continue;
+
+                ranges.clear();
+                for (size_t offset = 0; offset < size; offset++)
+                {
+                    if (data[offset] == previousData[offset])
+                        continue;
+                    if (!ranges.empty() && offset - (ranges.back().first + ranges.back().second) < SpriteDeltaMergeDistance)
+                    {
+                        ranges.back().second = static_cast<uint16_t>(offset + 1 - ranges.back().first);
+                    }
+                    else
+                    {
+                        ranges.emplace_back(static_cast<uint16_t>(offset), static_cast<uint16_t>(1));
+                    }
+                }
+
+                auto numRanges = static_cast<uint16_t>(ranges.size());
+                ds << spriteIdx << static_cast<uint8_t>(SpriteDeltaType::Patched) << numRanges;
+                for (auto& range : ranges)
+                {
+                    ds << range.first << range.second;
+                    stream.Write(data + range.first, range.second);
+                }
+            }
+            else if (sprite.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
+            {
+                ds << spriteIdx << static_cast<uint8_t>(SpriteDeltaType::Removed);
+            }
+            else
+            {
+                auto spriteSize = static_cast<uint16_t>(size);
+                ds << spriteIdx << static_cast<uint8_t>(SpriteDeltaType::Replaced) << sprite.generic.sprite_identifier << sprite.generic.type
+                   << spriteSize;
+                stream.Write(data, size);
+            }
+
+            previousSprite = sprite;
+            numChanges++;
+        }
+
+        const uint64_t endPosition = storedSprites.GetPosition();
+        storedSprites.SetPosition(0);
+        ds << numChanges;
+        storedSprites.SetPosition(endPosition);
+    }
+
+    /*
+     * Applies the sprite changes of a delta snapshot to the sprites of the previous snapshot.
+     */
+    void ReadSpriteDelta(const std::function<rct_sprite*(const size_t)>& getEntity) const
+    {
+        MemoryStream deltaStream(storedSprites.GetData(), storedSprites.GetLength());
+        DataSerialiser ds(false, deltaStream);
+
+        uint32_t numChanges = 0;
+        ds << numChanges;
+        for (uint32_t i = 0; i < numChanges; i++)
+        {
+            uint32_t spriteIdx = 0;
+            uint8_t type = 0;
+            ds << spriteIdx << type;
+
+            rct_sprite& sprite = *getEntity(spriteIdx);
+            auto* data = reinterpret_cast<uint8_t*>(&sprite);
+            switch (static_cast<SpriteDeltaType>(type))
+            {
+                case SpriteDeltaType::Removed:
+                    sprite = rct_sprite();
+                    sprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
+                    break;
+                case SpriteDeltaType::Replaced:
+                {
+                    uint16_t size = 0;
+                    sprite = rct_sprite();
+                    ds << sprite.generic.sprite_identifier << sprite.generic.type << size;
+                    if (size > sizeof(rct_sprite))
+                    {
+                        throw std::out_of_range("Invalid sprite size in game state snapshot.");
+                    }
+                    deltaStream.Read(data, size);
+                    break;
+                }
+                case SpriteDeltaType::Patched:
+                {
+                    uint16_t numRanges = 0;
+                    ds << numRanges;
+                    for (uint16_t j = 0; j < numRanges; j++)
+                    {
+                        uint16_t offset = 0;
+                        uint16_t length = 0;
+                        ds << offset << length;
+                        if (static_cast<size_t>(offset) + length > sizeof(rct_sprite))
+                        {
+                            throw std::out_of_range("Invalid sprite range in game state snapshot.");
+                        }
+                        deltaStream.Read(data + offset, length);
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Invalid sprite delta in game state snapshot.");
+            }
+        }
+    }
+
+    /*
+     * Adds the indices of the sprites a delta snapshot changes to spriteIndices, without reading the sprite data.
+     */
+    void GetSpriteDeltaIndices(std::vector<uint32_t>& spriteIndices) const
+    {
+        MemoryStream deltaStream(storedSprites.GetData(), storedSprites.GetLength());
+        DataSerialiser ds(false, deltaStream);
+
+        uint32_t numChanges = 0;
+        ds << numChanges;
+        for (uint32_t i = 0; i < numChanges; i++)
+        {
+            uint32_t spriteIdx = 0;
+            uint8_t type = 0;
+            ds << spriteIdx << type;
+            spriteIndices.push_back(spriteIdx);
+
+            uint64_t skipLength = 0;
+            switch (static_cast<SpriteDeltaType>(type))
+            {
+                case SpriteDeltaType::Removed:
+                    break;
+                case SpriteDeltaType::Replaced:
+                {
+                    uint8_t spriteIdentifier = 0;
+                    uint8_t miscType = 0;
+                    uint16_t size = 0;
+                    ds << spriteIdentifier << miscType << size;
+                    skipLength = size;
+                    break;
+                }
+                case SpriteDeltaType::Patched:
+                {
+                    uint16_t numRanges = 0;
+                    ds << numRanges;
+                    for (uint16_t j = 0; j < numRanges; j++)
+                    {
+                        uint16_t offset = 0;
+                        uint16_t length = 0;
+                        ds << offset << length;
+                        deltaStream.SetPosition(deltaStream.GetPosition() + length);
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Invalid sprite delta in game state snapshot.");
+            }
+            deltaStream.SetPosition(deltaStream.GetPosition() + skipLength);
+        }
+    }
 };
 
 struct GameStateSnapshots final : public IGameStateSnapshots
@@ -114,13 +363,21 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     virtual void Reset() override final
     {
         _snapshots.clear();
+        _lastCaptured = nullptr;
+        _capturedSprites.clear();
+        _numCapturedDeltas = 0;
     }
 
     virtual GameStateSnapshot_t& CreateSnapshot() override final
     {
-        auto snapshot = std::make_unique<GameStateSnapshot_t>();
-        _snapshots.push_back(std::move(snapshot));
+        // Evicted snapshots stay alive as long as a newer delta still refers to them.
+        const size_t historyLength = GetHistoryLength();
+        while (_snapshots.size() >= historyLength)
+        {
+            _snapshots.pop_front();
+        }
 
+        _snapshots.push_back(std::make_shared<GameStateSnapshot_t>());
         return *_snapshots.back();
     }
 
@@ -132,8 +389,33 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual void Capture(GameStateSnapshot_t& snapshot) override final
     {
-        // TODO refactor to not use this as a proxy for getting a pointer to the sprite array
-        snapshot.SerialiseSprites(get_sprite(0), MAX_SPRITES, true);
+        const size_t numSprites = sprite_get_capacity();
+
+        auto it = std::find_if(_snapshots.rbegin(), _snapshots.rend(), [&snapshot](const auto& s) {
+            return s.get() == &snapshot;
+        });
+        std::shared_ptr<GameStateSnapshot_t> capturedSnapshot = it != _snapshots.rend() ? *it : nullptr;
+
+        snapshot.previous = nullptr;
+        if (_lastCaptured != nullptr && capturedSnapshot != nullptr && _numCapturedDeltas < SnapshotKeyframeInterval
+            && _capturedSprites.size() == numSprites)
+        {
+            snapshot.WriteSpriteDelta([](const size_t index) { return get_sprite(index); }, _capturedSprites);
+            snapshot.previous = _lastCaptured;
+            _numCapturedDeltas++;
+        }
+        else
+        {
+            snapshot.SerialiseSprites([](const size_t index) { return get_sprite(index); }, numSprites, true);
+
+            _capturedSprites.resize(numSprites);
+            for (size_t i = 0; i < numSprites; i++)
+            {
+                _capturedSprites[i] = *get_sprite(i);
+            }
+            _numCapturedDeltas = 0;
+        }
+        _lastCaptured = capturedSnapshot;
 
         // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
     }
@@ -150,28 +432,144 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual void SerialiseSnapshot(GameStateSnapshot_t& snapshot, DataSerialiser& ds) const override final
     {
+        if (ds.IsSaving() && !snapshot.IsKeyframe())
+        {
+            // Deltas are resolved so that the serialised snapshot stands on its own.
+            GameStateSnapshot_t keyframe;
+            StoreSpriteList(keyframe, BuildSpriteList(snapshot));
+            ds << snapshot.tick;
+            ds << snapshot.srand0;
+            ds << keyframe.storedSprites;
+            ds << snapshot.parkParameters;
+            return;
+        }
+
         ds << snapshot.tick;
         ds << snapshot.srand0;
         ds << snapshot.storedSprites;
         ds << snapshot.parkParameters;
     }
 
-    std::vector<rct_sprite> BuildSpriteList(GameStateSnapshot_t& snapshot) const
+    virtual void SerialiseSnapshotDeltas(GameStateSnapshot_t& snapshot, DataSerialiser& ds) const override final
     {
-        std::vector<rct_sprite> spriteList;
-        spriteList.resize(MAX_SPRITES);
+        ds << snapshot.tick;
+        ds << snapshot.srand0;
 
-        for (auto& sprite : spriteList)
+        if (ds.IsSaving())
         {
-            // By default they don't exist.
-            sprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
+            std::vector<const GameStateSnapshot_t*> chain = GetSnapshotChain(snapshot);
+
+            auto chainLength = static_cast<uint32_t>(chain.size());
+            ds << chainLength;
+            for (auto it = chain.rbegin(); it != chain.rend(); it++)
+            {
+                ds << (*it)->storedSprites;
+            }
         }
+        else
+        {
+            uint32_t chainLength = 0;
+            ds << chainLength;
+            if (chainLength == 0 || chainLength > MaximumSnapshotChainLength)
+            {
+                throw std::out_of_range("Invalid game state snapshot chain length.");
+            }
+
+            // Rebuild the chain and resolve it into a keyframe.
+            std::shared_ptr<GameStateSnapshot_t> previous;
+            for (uint32_t i = 0; i < chainLength; i++)
+            {
+                auto link = std::make_shared<GameStateSnapshot_t>();
+                ds << link->storedSprites;
+                link->previous = previous;
+                previous = link;
+            }
+            snapshot.previous = nullptr;
+            snapshot.storedSprites = MemoryStream();
+            StoreSpriteList(snapshot, BuildSpriteList(*previous));
+        }
+
+        ds << snapshot.parkParameters;
+    }
+
+    // Returns the snapshot followed by the ones it is a delta of, up to the keyframe or up to but excluding stopAt.
+    static std::vector<const GameStateSnapshot_t*> GetSnapshotChain(
+        const GameStateSnapshot_t& snapshot, const GameStateSnapshot_t* stopAt = nullptr)
+    {
+        std::vector<const GameStateSnapshot_t*> chain;
+        for (const GameStateSnapshot_t* link = &snapshot; link != nullptr && link != stopAt; link = link->previous.get())
+        {
+            chain.push_back(link);
+        }
+        return chain;
+    }
 
-        snapshot.SerialiseSprites(spriteList.data(), MAX_SPRITES, false);
+    // Returns the newest snapshot both chains are built on, null if they do not share a keyframe.
+    static const GameStateSnapshot_t* FindCommonSnapshot(const GameStateSnapshot_t& a, const GameStateSnapshot_t& b)
+    {
+        std::vector<const GameStateSnapshot_t*> chain = GetSnapshotChain(a);
+        for (const GameStateSnapshot_t* link = &b; link != nullptr; link = link->previous.get())
+        {
+            if (std::find(chain.begin(), chain.end(), link) != chain.end())
+                return link;
+        }
+        return nullptr;
+    }
+
+    // The sprite table of the snapshot may be larger than the current one, the list grows as sprites are read.
+    static rct_sprite* GetSpriteListEntry(std::vector<rct_sprite>& spriteList, const size_t index)
+    {
+        if (index >= MAX_SPRITES_LIMIT)
+        {
+            throw std::out_of_range("Invalid sprite index in game state snapshot.");
+        }
+        if (index >= spriteList.size())
+        {
+            ResizeSpriteList(spriteList, index + 1);
+        }
+        return &spriteList[index];
+    }
+
+    std::vector<rct_sprite> BuildSpriteList(const GameStateSnapshot_t& snapshot) const
+    {
+        std::vector<rct_sprite> spriteList;
+
+        // Start from the keyframe and apply the deltas up to the requested snapshot.
+        std::vector<const GameStateSnapshot_t*> chain = GetSnapshotChain(snapshot);
+        const_cast<GameStateSnapshot_t*>(chain.back())
+            ->SerialiseSprites(
+                [&spriteList](const size_t index) { return GetSpriteListEntry(spriteList, index); }, MAX_SPRITES_LIMIT,
+                false);
+        ApplySpriteDeltas(spriteList, snapshot, chain.back());
 
         return spriteList;
     }
 
+    // Applies the deltas from the snapshot after ancestor up to snapshot, ancestor has to be part of its chain.
+    static void ApplySpriteDeltas(
+        std::vector<rct_sprite>& spriteList, const GameStateSnapshot_t& snapshot, const GameStateSnapshot_t* ancestor)
+    {
+        std::vector<const GameStateSnapshot_t*> chain = GetSnapshotChain(snapshot, ancestor);
+        for (auto it = chain.rbegin(); it != chain.rend(); it++)
+        {
+            (*it)->ReadSpriteDelta([&spriteList](const size_t index) { return GetSpriteListEntry(spriteList, index); });
+        }
+    }
+
+    static void StoreSpriteList(GameStateSnapshot_t& snapshot, std::vector<rct_sprite>&& spriteList)
+    {
+        snapshot.SerialiseSprites(
+            [&spriteList](const size_t index) { return &spriteList[index]; }, spriteList.size(), true);
+    }
+
+    static void ResizeSpriteList(std::vector<rct_sprite>& spriteList, size_t size)
+    {
+        rct_sprite nullSprite;
+        // By default they don't exist.
+        nullSprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
+        spriteList.resize(size, nullSprite);
+    }
+
 #define COMPARE_FIELD(struc, field)                                                                                            \
     if (std::memcmp(&spriteBase.field, &spriteCmp.field, sizeof(struc::field)) != 0)                                           \
     {                                                                                                                          \
@@ -524,8 +922,44 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         res.srand0Left = base.srand0;
         res.srand0Right = cmp.srand0;
 
-        std::vector<rct_sprite> spritesBase = BuildSpriteList(const_cast<GameStateSnapshot_t&>(base));
-        std::vector<rct_sprite> spritesCmp = BuildSpriteList(const_cast<GameStateSnapshot_t&>(cmp));
+        std::vector<rct_sprite> spritesBase;
+        std::vector<rct_sprite> spritesCmp;
+
+        // Snapshots captured from the same keyframe are built from the newest snapshot they share, only the sprites
+        // the delta records since then touch can differ.
+        std::vector<bool> changedSprites;
+        const GameStateSnapshot_t* common = FindCommonSnapshot(base, cmp);
+        if (common != nullptr)
+        {
+            spritesBase = BuildSpriteList(*common);
+            spritesCmp = spritesBase;
+            ApplySpriteDeltas(spritesBase, base, common);
+            ApplySpriteDeltas(spritesCmp, cmp, common);
+
+            std::vector<uint32_t> changedIndices;
+            for (const auto& snapshot : { &base, &cmp })
+            {
+                for (const auto* link : GetSnapshotChain(*snapshot, common))
+                {
+                    link->GetSpriteDeltaIndices(changedIndices);
+                }
+            }
+            for (uint32_t spriteIdx : changedIndices)
+            {
+                if (spriteIdx >= changedSprites.size())
+                    changedSprites.resize(spriteIdx + 1);
+                changedSprites[spriteIdx] = true;
+            }
+        }
+        else
+        {
+            spritesBase = BuildSpriteList(base);
+            spritesCmp = BuildSpriteList(cmp);
+        }
+
+        const size_t numSprites = std::max(spritesBase.size(), spritesCmp.size());
+        ResizeSpriteList(spritesBase, numSprites);
+        ResizeSpriteList(spritesCmp, numSprites);
 
         for (uint32_t i = 0; i < static_cast<uint32_t>(spritesBase.size()); i++)
         {
@@ -538,7 +972,13 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             changeData.spriteIdentifier = spriteBase.generic.sprite_identifier;
             changeData.miscIdentifier = spriteBase.generic.type;
 
-            if (spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
+            if (common != nullptr && (i >= changedSprites.size() || !changedSprites[i]))
+            {
+                // Neither snapshot changed the sprite since the snapshot they share.
+                changeData.changeType = GameStateSpriteChange_t::EQUAL;
+            }
+            else if (
+                spriteBase.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
                 && spriteCmp.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL)
             {
                 // Sprite was added.
@@ -560,6 +1000,13 @@ struct GameStateSnapshots final : public IGameStateSnapshots
                 // Do nothing.
                 changeData.changeType = GameStateSpriteChange_t::EQUAL;
             }
+            else if (
+                IsSameSpriteKind(spriteBase, spriteCmp)
+                && std::memcmp(&spriteBase, &spriteCmp, GetSnapshotSpriteSize(spriteBase)) == 0)
+            {
+                // Stored bytes are identical, no need to compare the fields.
+                changeData.changeType = GameStateSpriteChange_t::EQUAL;
+            }
             else
             {
                 CompareSpriteData(spriteBase, spriteCmp, changeData);
@@ -678,7 +1125,20 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     }
 
 private:
-    CircularBuffer<std::unique_ptr<GameStateSnapshot_t>, MaximumGameStateSnapshots> _snapshots;
+    static size_t GetHistoryLength()
+    {
+        const int32_t historyLength = gConfigNetwork.desync_snapshot_history;
+        if (historyLength <= 0)
+            return DefaultGameStateSnapshotHistory;
+        return static_cast<size_t>(std::clamp(historyLength, 2, 1024));
+    }
+
+    std::deque<std::shared_ptr<GameStateSnapshot_t>> _snapshots;
+
+    // Sprites as they were when the last snapshot was captured, deltas are made against them.
+    std::shared_ptr<const GameStateSnapshot_t> _lastCaptured;
+    std::vector<rct_sprite> _capturedSprites;
+    uint32_t _numCapturedDeltas = 0;
 };
 
 std::unique_ptr<IGameStateSnapshots> CreateGameStateSnapshots()
@@ -55,10 +55,11 @@ struct GameStateCompareData_t
 };
 
 /*
- * Interface to create and capture game states. It only allows to have 32 active snapshots
- * the oldest snapshot will be removed from the buffer. Never store the snapshot pointer
- * as it may become invalid at any time when a snapshot is created, rather Link the snapshot
- * to a specific tick which can be obtained by that later again assuming its still valid.
+ * Interface to create and capture game states. The number of active snapshots is limited by the
+ * desync_snapshot_history setting, the oldest snapshot will be removed from the buffer. Never store
+ * the snapshot pointer as it may become invalid at any time when a snapshot is created, rather Link
+ * the snapshot to a specific tick which can be obtained by that later again assuming its still valid.
+ * Captured snapshots are stored as a periodic keyframe followed by the changes of each tick.
  */
 interface IGameStateSnapshots
 {
@@ -94,6 +95,12 @@ interface IGameStateSnapshots
      */
     virtual void SerialiseSnapshot(GameStateSnapshot_t & snapshot, DataSerialiser & serialiser) const = 0;
 
+    /*
+     * Serialisation of GameStateSnapshot_t as its keyframe followed by the deltas leading up to it, which is
+     * much smaller after compression. Loading resolves the deltas into a standalone snapshot.
+     */
+    virtual void SerialiseSnapshotDeltas(GameStateSnapshot_t & snapshot, DataSerialiser & serialiser) const = 0;
+
     /*
      * Compares two states resulting GameStateCompareData_t with all mismatches stored.
      */
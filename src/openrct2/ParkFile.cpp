@@ -0,0 +1,470 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ParkFile.h"
+
+#include "Context.h"
+#include "core/FileStream.hpp"
+#include "core/IStream.hpp"
+#include "core/JobPool.hpp"
+#include "core/MemoryMappedFile.h"
+#include "core/MemoryStream.h"
+#include "core/String.hpp"
+#include "object/ObjectRepository.h"
+#include "rct2/RCT2.h"
+#include "rct2/S6Exporter.h"
+#include "scenario/Scenario.h"
+#include "util/Util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <limits>
+
+// Best ratio deflate can reach, a section claiming to inflate to more than this is corrupt.
+static constexpr uint64_t PARK_FILE_MAX_COMPRESSION_RATIO = 1032;
+
+void ParkFileWriter::AddSection(ParkFileSection id, uint16_t version, const void* data, size_t length)
+{
+    _sections.push_back({ id, version, data, length, {} });
+}
+
+void ParkFileWriter::AddSection(ParkFileSection id, uint16_t version, std::vector<uint8_t>&& data)
+{
+    _sections.push_back({ id, version, nullptr, 0, std::move(data) });
+    auto& section = _sections.back();
+    section.Data = section.Buffer.data();
+    section.Length = section.Buffer.size();
+}
+
+size_t ParkFileWriter::GetUncompressedLength() const
+{
+    size_t length = 0;
+    for (const auto& section : _sections)
+    {
+        length += section.Length;
+    }
+    return length;
+}
+
+void ParkFileWriter::Write(IStream* stream, const std::function<void(size_t)>& reportFn)
+{
+    std::vector<ParkFileSectionEntry> entries(_sections.size());
+    std::vector<std::vector<uint8_t>> compressedSections(_sections.size());
+    std::atomic<size_t> compressedLength = { 0 };
+
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup group;
+    for (size_t i = 0; i < _sections.size(); i++)
+    {
+        auto* section = &_sections[i];
+        auto* entry = &entries[i];
+        auto* compressed = &compressedSections[i];
+        auto* progress = &compressedLength;
+        jobPool.AddTask(group, [section, entry, compressed, progress]() {
+            auto src = static_cast<const uint8_t*>(section->Data);
+            entry->Id = static_cast<uint32_t>(section->Id);
+            entry->Version = section->Version;
+            entry->Length = section->Length;
+            entry->Crc32 = util_crc32(src, section->Length);
+
+            // Sections that do not get smaller are stored as they are
+            auto deflated = util_zlib_deflate(src, section->Length);
+            if (deflated && deflated->size() < section->Length)
+            {
+                entry->Compression = static_cast<uint8_t>(ParkFileCompression::Zlib);
+                *compressed = std::move(*deflated);
+            }
+            else
+            {
+                entry->Compression = static_cast<uint8_t>(ParkFileCompression::None);
+                compressed->assign(src, src + section->Length);
+            }
+            entry->CompressedLength = compressed->size();
+            progress->fetch_add(section->Length, std::memory_order_relaxed);
+        });
+    }
+    if (reportFn)
+    {
+        jobPool.Join(group, [&reportFn, &compressedLength]() { reportFn(compressedLength.load(std::memory_order_relaxed)); });
+    }
+    else
+    {
+        jobPool.Join(group);
+    }
+
+    uint64_t offset = sizeof(ParkFileHeader) + entries.size() * sizeof(ParkFileSectionEntry);
+    for (auto& entry : entries)
+    {
+        entry.Offset = offset;
+        offset += entry.CompressedLength;
+    }
+
+    ParkFileHeader header{};
+    header.Magic = PARK_FILE_MAGIC;
+    header.Version = PARK_FILE_VERSION;
+    header.MinVersion = PARK_FILE_MIN_VERSION;
+    header.NumSections = static_cast<uint32_t>(entries.size());
+    header.Length = offset;
+    stream->WriteValue(header);
+    stream->Write(entries.data(), entries.size() * sizeof(ParkFileSectionEntry));
+    for (const auto& compressed : compressedSections)
+    {
+        stream->Write(compressed.data(), compressed.size());
+    }
+}
+
+ParkFileReader::ParkFileReader(const std::string& path)
+{
+    _mappedFile = std::make_unique<MemoryMappedFile>(path);
+    _data = _mappedFile->GetData();
+    _length = _mappedFile->GetLength();
+    ReadHeader();
+}
+
+ParkFileReader::ParkFileReader(IStream* stream)
+{
+    const uint64_t start = stream->GetPosition();
+    const uint64_t remaining = stream->GetLength() - start;
+    auto header = stream->ReadValue<ParkFileHeader>();
+    if (header.Magic != PARK_FILE_MAGIC || header.Length < sizeof(ParkFileHeader) || header.Length > remaining)
+    {
+        throw IOException("Invalid park file header.");
+    }
+
+    auto streamData = static_cast<const uint8_t*>(stream->GetData());
+    if (streamData != nullptr)
+    {
+        _data = streamData + start;
+    }
+    else
+    {
+        _buffer.resize(static_cast<size_t>(header.Length));
+        std::memcpy(_buffer.data(), &header, sizeof(header));
+        stream->Read(_buffer.data() + sizeof(header), _buffer.size() - sizeof(header));
+        _data = _buffer.data();
+    }
+    _length = static_cast<size_t>(header.Length);
+    stream->SetPosition(start + header.Length);
+    ReadHeader();
+}
+
+ParkFileReader::~ParkFileReader() = default;
+
+bool ParkFileReader::IsParkFile(IStream* stream)
+{
+    const uint64_t position = stream->GetPosition();
+    uint32_t magic = 0;
+    bool result = stream->TryRead(&magic, sizeof(magic)) == sizeof(magic) && magic == PARK_FILE_MAGIC;
+    stream->SetPosition(position);
+    return result;
+}
+
+bool ParkFileReader::IsParkFile(const std::string& path)
+{
+    try
+    {
+        auto fs = FileStream(path, FILE_MODE_OPEN);
+        return IsParkFile(&fs);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+void ParkFileReader::ReadHeader()
+{
+    if (_length < sizeof(ParkFileHeader))
+    {
+        throw IOException("Park file is too short.");
+    }
+    std::memcpy(&_header, _data, sizeof(_header));
+    if (_header.Magic != PARK_FILE_MAGIC)
+    {
+        throw IOException("Not a park file.");
+    }
+    if (_header.MinVersion > PARK_FILE_VERSION)
+    {
+        throw IOException(String::StdFormat("Park file version %u is not supported.", _header.Version));
+    }
+    if (_header.Length > _length)
+    {
+        throw IOException("Park file is truncated.");
+    }
+    _length = static_cast<size_t>(_header.Length);
+
+    const uint64_t tableEnd = sizeof(ParkFileHeader) + uint64_t(_header.NumSections) * sizeof(ParkFileSectionEntry);
+    if (tableEnd > _length)
+    {
+        throw IOException("Park file is truncated.");
+    }
+    _sections.resize(_header.NumSections);
+    std::memcpy(_sections.data(), _data + sizeof(ParkFileHeader), _sections.size() * sizeof(ParkFileSectionEntry));
+    for (const auto& entry : _sections)
+    {
+        if (entry.Offset < tableEnd || entry.Offset > _length || entry.CompressedLength > _length - entry.Offset)
+        {
+            throw IOException("Park file section is out of bounds.");
+        }
+    }
+}
+
+bool ParkFileReader::HasSection(ParkFileSection id) const
+{
+    return std::any_of(
+        _sections.begin(), _sections.end(), [id](const ParkFileSectionEntry& e) { return e.Id == static_cast<uint32_t>(id); });
+}
+
+uint16_t ParkFileReader::GetSectionVersion(ParkFileSection id) const
+{
+    return GetSectionEntry(id).Version;
+}
+
+const ParkFileSectionEntry& ParkFileReader::GetSectionEntry(ParkFileSection id) const
+{
+    auto it = std::find_if(
+        _sections.begin(), _sections.end(), [id](const ParkFileSectionEntry& e) { return e.Id == static_cast<uint32_t>(id); });
+    if (it == _sections.end())
+    {
+        throw IOException(String::StdFormat("Park file is missing section %u.", static_cast<uint32_t>(id)));
+    }
+    return *it;
+}
+
+size_t ParkFileReader::GetSectionLength(const ParkFileSectionEntry& entry) const
+{
+    if (entry.Offset > _length || entry.CompressedLength > _length - entry.Offset)
+    {
+        throw IOException("Park file section is out of bounds.");
+    }
+
+    uint64_t maxLength = entry.CompressedLength;
+    if (static_cast<ParkFileCompression>(entry.Compression) == ParkFileCompression::Zlib)
+    {
+        maxLength *= PARK_FILE_MAX_COMPRESSION_RATIO;
+    }
+    if (entry.Length > maxLength || entry.Length > std::numeric_limits<size_t>::max())
+    {
+        throw IOException("Park file section has an invalid length.");
+    }
+    return static_cast<size_t>(entry.Length);
+}
+
+void ParkFileReader::DecompressSection(const ParkFileSectionEntry& entry, uint8_t* dst) const
+{
+    const uint8_t* src = _data + entry.Offset;
+    const size_t length = static_cast<size_t>(entry.Length);
+    switch (static_cast<ParkFileCompression>(entry.Compression))
+    {
+        case ParkFileCompression::None:
+            if (entry.CompressedLength != entry.Length)
+            {
+                throw IOException("Park file section has an invalid length.");
+            }
+            std::memcpy(dst, src, length);
+            break;
+        case ParkFileCompression::Zlib:
+            if (!util_zlib_inflate(src, static_cast<size_t>(entry.CompressedLength), dst, length))
+            {
+                throw IOException("Unable to decompress park file section.");
+            }
+            break;
+        default:
+            throw IOException("Park file section uses an unsupported compression.");
+    }
+
+    if (util_crc32(dst, length) != entry.Crc32)
+    {
+        throw IOException("Park file section is corrupt.");
+    }
+}
+
+std::vector<uint8_t> ParkFileReader::ReadSection(ParkFileSection id) const
+{
+    const auto& entry = GetSectionEntry(id);
+    std::vector<uint8_t> result(GetSectionLength(entry));
+    DecompressSection(entry, result.data());
+    return result;
+}
+
+void ParkFileReader::ReadSection(ParkFileSection id, void* dst, size_t length) const
+{
+    const auto& entry = GetSectionEntry(id);
+    if (GetSectionLength(entry) != length)
+    {
+        throw IOException(String::StdFormat("Park file section %u has an invalid length.", static_cast<uint32_t>(id)));
+    }
+    DecompressSection(entry, static_cast<uint8_t*>(dst));
+}
+
+std::vector<std::vector<uint8_t>> ParkFileReader::ReadSections(const std::vector<ParkFileSection>& ids) const
+{
+    // Every section is checked before any of them is allocated.
+    std::vector<const ParkFileSectionEntry*> entries;
+    std::vector<size_t> lengths;
+    for (auto id : ids)
+    {
+        entries.push_back(&GetSectionEntry(id));
+        lengths.push_back(GetSectionLength(*entries.back()));
+    }
+
+    std::vector<std::vector<uint8_t>> results(ids.size());
+    std::vector<std::exception_ptr> errors(ids.size());
+
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup group;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        auto* entry = entries[i];
+        auto length = lengths[i];
+        auto* result = &results[i];
+        auto* error = &errors[i];
+        jobPool.AddTask(group, [this, entry, length, result, error]() {
+            try
+            {
+                result->resize(length);
+                DecompressSection(*entry, result->data());
+            }
+            catch (...)
+            {
+                *error = std::current_exception();
+            }
+        });
+    }
+    jobPool.Join(group);
+
+    for (const auto& error : errors)
+    {
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
+}
+
+ParkFileExporter::ParkFileExporter(S6Exporter& exporter)
+    : _exporter(exporter)
+{
+}
+
+void ParkFileExporter::SaveGame(const utf8* path)
+{
+    auto fs = FileStream(path, FILE_MODE_WRITE);
+    SaveGame(&fs);
+}
+
+void ParkFileExporter::SaveGame(IStream* stream)
+{
+    Save(stream, false);
+}
+
+void ParkFileExporter::SaveScenario(const utf8* path)
+{
+    auto fs = FileStream(path, FILE_MODE_WRITE);
+    SaveScenario(&fs);
+}
+
+void ParkFileExporter::SaveScenario(IStream* stream)
+{
+    Save(stream, true);
+}
+
+ParkFileWriter ParkFileExporter::PrepareGame()
+{
+    return Prepare(false);
+}
+
+void ParkFileExporter::Save(IStream* stream, bool isScenario)
+{
+    ParkFileWriter writer = Prepare(isScenario);
+    const size_t totalLength = writer.GetUncompressedLength();
+    writer.Write(stream, [this, totalLength](size_t length) {
+        if (OnSaveProgress != nullptr)
+        {
+            OnSaveProgress(length, totalLength);
+        }
+    });
+}
+
+ParkFileWriter ParkFileExporter::Prepare(bool isScenario)
+{
+    auto& s6 = _exporter._s6;
+    s6.header.type = isScenario ? S6_TYPE_SCENARIO : S6_TYPE_SAVEDGAME;
+    s6.header.classic_flag = 0;
+    s6.header.num_packed_objects = uint16_t(_exporter.ExportObjectsList.size());
+    s6.header.version = S6_RCT2_VERSION;
+    s6.header.magic_number = S6_MAGIC_NUMBER;
+    s6.game_version_number = 201028;
+
+    ParkFileWriter writer;
+    writer.AddSection(ParkFileSection::S6Header, 1, &s6.header, sizeof(s6.header));
+    if (isScenario)
+    {
+        writer.AddSection(ParkFileSection::ScenarioInfo, 1, &s6.info, sizeof(s6.info));
+    }
+    if (s6.header.num_packed_objects > 0)
+    {
+        auto ms = MemoryStream();
+        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
+        objRepo.WritePackedObjects(&ms, _exporter.ExportObjectsList);
+        auto data = static_cast<const uint8_t*>(ms.GetData());
+        writer.AddSection(ParkFileSection::PackedObjects, 1, std::vector<uint8_t>(data, data + ms.GetLength()));
+    }
+    writer.AddSection(ParkFileSection::Objects, 1, s6.objects, sizeof(s6.objects));
+
+    // Everything but the tile elements and sprites, in the order of rct_s6_data
+    std::vector<uint8_t> general;
+    auto appendRange = [&general](const void* begin, const void* end) {
+        general.insert(general.end(), static_cast<const uint8_t*>(begin), static_cast<const uint8_t*>(end));
+    };
+    appendRange(&s6.elapsed_months, &s6.tile_elements);
+    appendRange(&s6.next_free_tile_element_pointer_index, &s6.sprites);
+    appendRange(&s6.sprite_lists_head, &s6 + 1);
+    writer.AddSection(ParkFileSection::General, 1, std::move(general));
+
+    // Only the tile elements reached by walking every tile of the map are used, the rest is free space
+    size_t numTileElements = 0;
+    for (size_t tile = 0; tile < MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL; tile++)
+    {
+        while (numTileElements < RCT2_MAX_TILE_ELEMENTS)
+        {
+            if (s6.tile_elements[numTileElements++].IsLastForTile())
+                break;
+        }
+    }
+    writer.AddSection(ParkFileSection::TileElements, 1, s6.tile_elements, numTileElements * sizeof(RCT12TileElement));
+
+    // Free sprites only keep their list links
+    const auto& extensionSprites = _exporter._extensionSprites;
+    rct_s6_sprite_extension spriteHeader = _exporter._spriteExtension;
+    spriteHeader.num_sprites = static_cast<uint16_t>(RCT2_MAX_SPRITES + extensionSprites.size());
+    std::vector<uint8_t> sprites(reinterpret_cast<const uint8_t*>(&spriteHeader), reinterpret_cast<const uint8_t*>(&spriteHeader + 1));
+    for (size_t i = 0; i < spriteHeader.num_sprites; i++)
+    {
+        const auto& sprite = i < RCT2_MAX_SPRITES ? s6.sprites[i] : extensionSprites[i - RCT2_MAX_SPRITES];
+        const size_t length = sprite.unknown.sprite_identifier == SPRITE_IDENTIFIER_NULL ? sizeof(RCT12SpriteBase)
+                                                                                         : sizeof(RCT2Sprite);
+        const auto* spriteBytes = reinterpret_cast<const uint8_t*>(&sprite);
+        sprites.insert(sprites.end(), spriteBytes, spriteBytes + length);
+    }
+    writer.AddSection(ParkFileSection::Sprites, 1, std::move(sprites));
+    return writer;
+}
+
+namespace ParkFile
+{
+    bool ExtensionIsParkFile(const std::string& extension)
+    {
+        return String::Equals(extension, PARK_FILE_EXTENSION, true);
+    }
+} // namespace ParkFile
@@ -0,0 +1,203 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+interface IStream;
+class MemoryMappedFile;
+class S6Exporter;
+
+#define PARK_FILE_MAGIC 0x4B524150 // PARK
+#define PARK_FILE_EXTENSION ".park"
+
+// Version of the section layout written, readers refuse files with a minimum version above their own version.
+constexpr const uint32_t PARK_FILE_VERSION = 1;
+constexpr const uint32_t PARK_FILE_MIN_VERSION = 1;
+
+enum class ParkFileSection : uint32_t
+{
+    S6Header = 1,
+    ScenarioInfo = 2,
+    PackedObjects = 3,
+    Objects = 4,
+    General = 5,
+    TileElements = 6,
+    Sprites = 7,
+};
+
+enum class ParkFileCompression : uint8_t
+{
+    None,
+    Zlib,
+};
+
+#pragma pack(push, 1)
+/**
+ * Park file header, followed by one section entry per section.
+ */
+struct ParkFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t MinVersion;
+    uint32_t NumSections;
+    uint64_t Length; // Of the whole park file, including this header
+};
+assert_struct_size(ParkFileHeader, 24);
+
+struct ParkFileSectionEntry
+{
+    uint32_t Id;
+    uint16_t Version;
+    uint8_t Compression;
+    uint8_t Pad;
+    uint64_t Offset; // From the start of the park file
+    uint64_t CompressedLength;
+    uint64_t Length;
+    uint32_t Crc32; // Of the uncompressed data
+};
+assert_struct_size(ParkFileSectionEntry, 36);
+#pragma pack(pop)
+
+/**
+ * Writes a park file made of independently compressed sections. The sections are compressed concurrently.
+ */
+class ParkFileWriter final
+{
+private:
+    struct Section
+    {
+        ParkFileSection Id;
+        uint16_t Version;
+        const void* Data;
+        size_t Length;
+        std::vector<uint8_t> Buffer;
+    };
+
+    std::vector<Section> _sections;
+
+public:
+    /**
+     * Adds a section which refers to the given buffer, it has to stay valid until the file has been written.
+     */
+    void AddSection(ParkFileSection id, uint16_t version, const void* data, size_t length);
+    void AddSection(ParkFileSection id, uint16_t version, std::vector<uint8_t>&& data);
+
+    /**
+     * Compresses and writes all sections to the stream.
+     * @param reportFn Called periodically on the calling thread with the number of uncompressed bytes done so far.
+     */
+    void Write(IStream* stream, const std::function<void(size_t)>& reportFn = nullptr);
+
+    size_t GetUncompressedLength() const;
+};
+
+/**
+ * Reads the sections of a park file. Sections are only decompressed when they are read, so reading the header
+ * section of a large park is cheap.
+ */
+class ParkFileReader final
+{
+private:
+    std::unique_ptr<MemoryMappedFile> _mappedFile;
+    std::vector<uint8_t> _buffer;
+    const uint8_t* _data = nullptr;
+    size_t _length = 0;
+    ParkFileHeader _header{};
+    std::vector<ParkFileSectionEntry> _sections;
+
+public:
+    /**
+     * Maps the park file at the given path into memory.
+     */
+    explicit ParkFileReader(const std::string& path);
+
+    /**
+     * Reads the park file at the current position of the stream and leaves the stream positioned after it. Memory
+     * streams are read in place.
+     */
+    explicit ParkFileReader(IStream* stream);
+
+    ~ParkFileReader();
+
+    static bool IsParkFile(IStream* stream);
+    static bool IsParkFile(const std::string& path);
+
+    const ParkFileHeader& GetHeader() const
+    {
+        return _header;
+    }
+
+    bool HasSection(ParkFileSection id) const;
+    uint16_t GetSectionVersion(ParkFileSection id) const;
+
+    /**
+     * Decompresses a section, throws IOException if the section is missing or corrupt.
+     */
+    std::vector<uint8_t> ReadSection(ParkFileSection id) const;
+
+    /**
+     * Decompresses a section of a fixed size into the given buffer.
+     */
+    void ReadSection(ParkFileSection id, void* dst, size_t length) const;
+
+    /**
+     * Decompresses several sections concurrently, in the order of the given ids.
+     */
+    std::vector<std::vector<uint8_t>> ReadSections(const std::vector<ParkFileSection>& ids) const;
+
+private:
+    void ReadHeader();
+    const ParkFileSectionEntry& GetSectionEntry(ParkFileSection id) const;
+    size_t GetSectionLength(const ParkFileSectionEntry& entry) const;
+    void DecompressSection(const ParkFileSectionEntry& entry, uint8_t* dst) const;
+};
+
+/**
+ * Saves parks exported by S6Exporter in the park file format. Unlike SV6 files, the tile elements and sprites are
+ * only stored as far as they are used and each section is compressed with zlib.
+ */
+class ParkFileExporter final
+{
+private:
+    S6Exporter& _exporter;
+
+public:
+    // Called periodically with the uncompressed bytes written so far and in total.
+    std::function<void(size_t, size_t)> OnSaveProgress;
+
+    explicit ParkFileExporter(S6Exporter& exporter);
+
+    void SaveGame(const utf8* path);
+    void SaveGame(IStream* stream);
+    void SaveScenario(const utf8* path);
+    void SaveScenario(IStream* stream);
+
+    /**
+     * Collects the sections of a saved game without compressing them, so that they can be written on another
+     * thread. The writer refers to the data of the S6Exporter, which has to outlive it.
+     */
+    ParkFileWriter PrepareGame();
+
+private:
+    void Save(IStream* stream, bool isScenario);
+    ParkFileWriter Prepare(bool isScenario);
+};
+
+namespace ParkFile
+{
+    bool ExtensionIsParkFile(const std::string& extension);
+} // namespace ParkFile
@@ -11,6 +11,7 @@
 
 #include "Context.h"
 #include "Game.h"
+#include "GameState.h"
 #include "GameStateSnapshots.h"
 #include "OpenRCT2.h"
 #include "ParkImporter.h"
@@ -24,6 +25,7 @@
 #include "actions/TrackPlaceAction.hpp"
 #include "config/Config.h"
 #include "core/DataSerialiser.h"
+#include "core/File.h"
 #include "core/Path.hpp"
 #include "management/NewsItem.h"
 #include "object/ObjectManager.h"
@@ -32,7 +34,10 @@
 #include "world/Park.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <chrono>
+#include <future>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -75,6 +80,16 @@ namespace OpenRCT2
         MemoryStream data;
     };
 
+    // Full game state at a tick, playback can seek to it without simulating from the start of the replay.
+    struct ReplayKeyframe
+    {
+        uint32_t tick = 0;
+        uint32_t commandIndex = 0; // First command that has not been executed yet.
+        MemoryStream parkData;
+        MemoryStream parkParams;
+        MemoryStream cheatData;
+    };
+
     struct ReplayRecordData
     {
         uint32_t magic;
@@ -89,18 +104,45 @@ namespace OpenRCT2
         uint32_t tickStart;    // First tick of replay.
         uint32_t tickEnd;      // Last tick of replay.
         std::multiset<ReplayCommand> commands;
+        std::multiset<ReplayCommand>::iterator nextCommand;
         std::vector<std::pair<uint32_t, rct_sprite_checksum>> checksums;
         uint32_t checksumIndex;
         MemoryStream gameStateSnapshots;
+        std::vector<ReplayKeyframe> keyframes;
+        uint32_t numCommandsWritten = 0;
+        uint32_t numChecksumsWritten = 0;
+        uint32_t numKeyframesWritten = 0;
+    };
+
+    enum class ReplayBlockType : uint8_t
+    {
+        Header,
+        Data,
+        End,
+    };
+
+    struct ReplayBlockIndexEntry
+    {
+        uint64_t offset; // From the start of the file
+        uint8_t type;
+        uint32_t tick;
     };
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 4;
-        static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
+        static constexpr uint16_t ReplayVersion = 7;
+        static constexpr uint16_t ReplayMinCompatibleVersion = 4;
+        static constexpr uint16_t ReplayBlocksVersion = 6;        // First version that is written as a sequence of blocks.
+        static constexpr uint16_t ReplayBlockChecksumVersion = 7; // First version with the block sprite checksum.
+        static constexpr uint32_t ReplayMagic = 0x5243524F;      // ORCR.
+        static constexpr uint32_t ReplayIndexMagic = 0x4943524F; // ORCI.
         static constexpr int ReplayCompressionLevel = 9;
+        static constexpr uint32_t ReplayMaxBlockSize = 256 * 1024 * 1024;
+        static constexpr uint32_t ReplayMaxCompressionRatio = 1032; // Best ratio deflate can reach.
         static constexpr int NormalRecordingChecksumTicks = 1;
         static constexpr int SilentRecordingChecksumTicks = 40; // Same as network server
+        static constexpr uint32_t KeyframeTicks = 4000;
+        static constexpr uint32_t BlockTicks = 1000;
 
         enum class ReplayMode
         {
@@ -113,6 +155,8 @@ namespace OpenRCT2
     public:
         virtual ~ReplayManager()
         {
+            WaitForBlockWrite();
+            CloseRecordingFile();
         }
 
         virtual bool IsReplaying() const override
@@ -164,6 +208,20 @@ namespace OpenRCT2
                 _nextChecksumTick = gCurrentTicks + ChecksumTicksDelta();
             }
 
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks == _nextKeyframeTick)
+            {
+                AddKeyframe();
+
+                _nextKeyframeTick = gCurrentTicks + KeyframeTicks;
+            }
+
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks >= _nextBlockTick)
+            {
+                WriteDataBlock();
+
+                _nextBlockTick = gCurrentTicks + BlockTicks;
+            }
+
             if (_mode == ReplayMode::RECORDING)
             {
                 if (gCurrentTicks >= _currentRecording->tickEnd)
@@ -193,7 +251,7 @@ namespace OpenRCT2
                 ReplayCommands();
 
                 // If we run out of commands we can just stop
-                if (_currentReplay->commands.empty())
+                if (_currentReplay->nextCommand == _currentReplay->commands.end())
                 {
                     StopPlayback();
                     StopRecording();
@@ -259,12 +317,20 @@ namespace OpenRCT2
 
             TakeGameStateSnapshot(replayData->gameStateSnapshots);
 
+            // The recording is written as it goes, starting with everything needed to begin playback.
+            if (!BeginRecordingFile(*replayData))
+                return false;
+            replayData->parkData = MemoryStream();
+            replayData->gameStateSnapshots = MemoryStream();
+
             if (_mode != ReplayMode::NORMALISATION)
                 _mode = ReplayMode::RECORDING;
 
             _currentRecording = std::move(replayData);
             _recordType = rt;
             _nextChecksumTick = gCurrentTicks + 1;
+            _nextKeyframeTick = gCurrentTicks + KeyframeTicks;
+            _nextBlockTick = gCurrentTicks + BlockTicks;
 
             return true;
         }
@@ -276,6 +342,9 @@ namespace OpenRCT2
 
             if (discard)
             {
+                WaitForBlockWrite();
+                CloseRecordingFile();
+                File::Delete(_currentRecording->filePath);
                 _currentRecording.reset();
                 _mode = ReplayMode::NONE;
                 return true;
@@ -288,50 +357,19 @@ namespace OpenRCT2
                 AddChecksum(gCurrentTicks, std::move(checksum));
             }
 
-            TakeGameStateSnapshot(_currentRecording->gameStateSnapshots);
-
-            // Serialise Body.
-            DataSerialiser recSerialiser(true);
-            Serialise(recSerialiser, *_currentRecording);
-
-            const auto& stream = recSerialiser.GetStream();
-            unsigned long streamLength = static_cast<unsigned long>(stream.GetLength());
-            unsigned long compressLength = compressBound(streamLength);
+            WriteDataBlock();
+            WaitForBlockWrite();
 
-            MemoryStream data(compressLength);
+            MemoryStream endSnapshot;
+            TakeGameStateSnapshot(endSnapshot);
 
-            ReplayRecordFile file{ _currentRecording->magic, _currentRecording->version, streamLength, data };
+            DataSerialiser endSerialiser(true);
+            endSerialiser << _currentRecording->tickEnd;
+            endSerialiser << endSnapshot;
+            WriteBlock(ReplayBlockType::End, _currentRecording->tickEnd, endSerialiser.GetStream());
 
-            auto compressBuf = std::make_unique<unsigned char[]>(compressLength);
-            compress2(
-                compressBuf.get(), &compressLength, static_cast<const unsigned char*>(stream.GetData()), stream.GetLength(),
-                ReplayCompressionLevel);
-            file.data.Write(compressBuf.get(), compressLength);
-
-            DataSerialiser fileSerialiser(true);
-            fileSerialiser << file.magic;
-            fileSerialiser << file.version;
-            fileSerialiser << file.uncompressedSize;
-            fileSerialiser << file.data;
-
-            bool result = false;
-
-            const std::string& outFile = _currentRecording->filePath;
-
-            FILE* fp = fopen(outFile.c_str(), "wb");
-            if (fp)
-            {
-                const auto& fileStream = fileSerialiser.GetStream();
-                fwrite(fileStream.GetData(), 1, fileStream.GetLength(), fp);
-                fclose(fp);
-
-                result = true;
-            }
-            else
-            {
-                log_error("Unable to write to file '%s'", outFile.c_str());
-                result = false;
-            }
+            bool result = WriteBlockIndex();
+            CloseRecordingFile();
 
             // When normalizing the output we don't touch the mode.
             if (_mode != ReplayMode::NORMALISATION)
@@ -367,14 +405,19 @@ namespace OpenRCT2
                 info.Ticks = gCurrentTicks - data->tickStart;
             else if (_mode == ReplayMode::PLAYING)
                 info.Ticks = data->tickEnd - data->tickStart;
-            info.NumCommands = static_cast<uint32_t>(data->commands.size());
-            info.NumChecksums = static_cast<uint32_t>(data->checksums.size());
+            info.NumCommands = data->numCommandsWritten + static_cast<uint32_t>(data->commands.size());
+            info.NumChecksums = data->numChecksumsWritten + static_cast<uint32_t>(data->checksums.size());
+            info.NumKeyframes = data->numKeyframesWritten + static_cast<uint32_t>(data->keyframes.size());
 
             return true;
         }
 
         void LoadAndCompareSnapshot(MemoryStream& snapshotStream)
         {
+            // Recordings that were not stopped have no snapshot of their last tick.
+            if (snapshotStream.GetPosition() >= snapshotStream.GetLength())
+                return;
+
             DataSerialiser ds(false, snapshotStream);
 
             IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
@@ -425,7 +468,7 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!LoadReplayDataMap(*replayData))
+            if (!LoadReplayState(replayData->parkData, replayData->parkParams, replayData->cheatData))
             {
                 log_error("Unable to load map.");
                 return false;
@@ -436,6 +479,7 @@ namespace OpenRCT2
             LoadAndCompareSnapshot(replayData->gameStateSnapshots);
 
             _currentReplay = std::move(replayData);
+            _currentReplay->nextCommand = _currentReplay->commands.begin();
             _currentReplay->checksumIndex = 0;
             _faultyChecksumIndex = -1;
 
@@ -482,6 +526,70 @@ namespace OpenRCT2
             return true;
         }
 
+        virtual bool SeekPlayback(uint32_t replayTick) override
+        {
+            if (_mode != ReplayMode::PLAYING)
+                return false;
+
+            auto& replay = *_currentReplay;
+            uint32_t targetTick = replay.tickEnd;
+            if (replayTick < replay.tickEnd - replay.tickStart)
+                targetTick = replay.tickStart + replayTick;
+
+            // Keyframes are sorted by tick, find the last one at or before the target.
+            auto it = std::upper_bound(
+                replay.keyframes.begin(), replay.keyframes.end(), targetTick,
+                [](uint32_t tick, const ReplayKeyframe& keyframe) { return tick < keyframe.tick; });
+            ReplayKeyframe* keyframe = it != replay.keyframes.begin() ? &*std::prev(it) : nullptr;
+
+            if (targetTick < gCurrentTicks || (keyframe != nullptr && keyframe->tick > gCurrentTicks))
+            {
+                bool loaded;
+                if (keyframe != nullptr)
+                {
+                    auto& frame = *keyframe;
+                    loaded = LoadReplayState(frame.parkData, frame.parkParams, frame.cheatData);
+                    gCurrentTicks = frame.tick;
+                    replay.nextCommand = std::find_if(
+                        replay.commands.begin(), replay.commands.end(),
+                        [&frame](const ReplayCommand& command) { return command.commandIndex >= frame.commandIndex; });
+                }
+                else
+                {
+                    loaded = LoadReplayState(replay.parkData, replay.parkParams, replay.cheatData);
+                    gCurrentTicks = replay.tickStart;
+                    replay.nextCommand = replay.commands.begin();
+                }
+
+                if (!loaded)
+                {
+                    log_error("Unable to load replay state at tick %u.", gCurrentTicks);
+                    StopPlayback();
+                    return false;
+                }
+
+                auto checksumIt = std::lower_bound(
+                    replay.checksums.begin(), replay.checksums.end(), gCurrentTicks,
+                    [](const std::pair<uint32_t, rct_sprite_checksum>& checksum, uint32_t tick) {
+                        return checksum.first < tick;
+                    });
+                replay.checksumIndex = static_cast<uint32_t>(std::distance(replay.checksums.begin(), checksumIt));
+                _faultyChecksumIndex = -1;
+                gGamePaused = 0;
+            }
+
+            // Simulate the remaining ticks as fast as possible, the replay stops by itself at its last tick.
+            _seeking = true;
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks < targetTick)
+            {
+                gameState->UpdateLogic();
+            }
+            _seeking = false;
+
+            return true;
+        }
+
         virtual bool NormaliseReplay(const std::string& file, const std::string& outFile) override
         {
             _mode = ReplayMode::NORMALISATION;
@@ -515,17 +623,38 @@ namespace OpenRCT2
             }
         }
 
-        bool LoadReplayDataMap(ReplayRecordData& data)
+        void AddKeyframe()
+        {
+            ReplayKeyframe keyframe;
+            keyframe.tick = gCurrentTicks;
+            keyframe.commandIndex = _commandId;
+
+            auto s6exporter = std::make_unique<S6Exporter>();
+            s6exporter->Export();
+            s6exporter->SaveGame(&keyframe.parkData);
+
+            DataSerialiser parkParamsDs(true, keyframe.parkParams);
+            SerialiseParkParameters(parkParamsDs);
+
+            DataSerialiser cheatDataDs(true, keyframe.cheatData);
+            SerialiseCheats(cheatDataDs);
+
+            _currentRecording->keyframes.push_back(std::move(keyframe));
+        }
+
+        bool LoadReplayState(MemoryStream& parkData, MemoryStream& parkParams, MemoryStream& cheatData)
         {
             try
             {
-                data.parkData.SetPosition(0);
+                parkData.SetPosition(0);
+                parkParams.SetPosition(0);
+                cheatData.SetPosition(0);
 
                 auto context = GetContext();
                 auto& objManager = context->GetObjectManager();
                 auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
 
-                auto loadResult = importer->LoadFromStream(&data.parkData, false);
+                auto loadResult = importer->LoadFromStream(&parkData, false);
                 objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
 
                 importer->Import();
@@ -533,13 +662,13 @@ namespace OpenRCT2
                 sprite_position_tween_reset();
 
                 // Load all map global variables.
-                DataSerialiser parkParamsDs(false, data.parkParams);
+                DataSerialiser parkParamsDs(false, parkParams);
                 SerialiseParkParameters(parkParamsDs);
 
                 // New cheats might not be serialised, make sure they are using their defaults.
                 CheatsReset();
 
-                DataSerialiser cheatDataDs(false, data.cheatData);
+                DataSerialiser cheatDataDs(false, cheatData);
                 SerialiseCheats(cheatDataDs);
 
                 game_load_init();
@@ -633,14 +762,26 @@ namespace OpenRCT2
             if (!loaded)
                 return false;
 
-            if (!TryDecompress(stream))
-                return false;
-
             stream.SetPosition(0);
-            DataSerialiser serialiser(false, stream);
-            if (!Serialise(serialiser, data))
+            DataSerialiser fileSerialiser(false, stream);
+            fileSerialiser << data.magic;
+            fileSerialiser << data.version;
+            if (data.magic == ReplayMagic && data.version >= ReplayBlocksVersion && Compatible(data))
             {
-                return false;
+                if (!ReadReplayBlocks(stream, data))
+                    return false;
+            }
+            else
+            {
+                if (!TryDecompress(stream))
+                    return false;
+
+                stream.SetPosition(0);
+                DataSerialiser serialiser(false, stream);
+                if (!Serialise(serialiser, data))
+                {
+                    return false;
+                }
             }
 
             // Reset position of all streams.
@@ -708,7 +849,7 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            return data.version >= ReplayMinCompatibleVersion && data.version <= ReplayVersion;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -726,6 +867,22 @@ namespace OpenRCT2
                 return false;
             }
 
+            SerialiseHeader(serialiser, data);
+            serialiser << data.tickEnd;
+            SerialiseCommands(serialiser, data.commands);
+            SerialiseChecksums(serialiser, data.checksums);
+            serialiser << data.gameStateSnapshots;
+
+            // Version 4 replays have no keyframes and can only be played from the start.
+            if (data.version >= 5)
+            {
+                SerialiseKeyframes(serialiser, data.keyframes);
+            }
+            return true;
+        }
+
+        void SerialiseHeader(DataSerialiser& serialiser, ReplayRecordData& data)
+        {
             serialiser << data.networkId;
 #ifndef DISABLE_NETWORK
             // NOTE: This does not mean the replay will not function, only a warning.
@@ -743,14 +900,17 @@ namespace OpenRCT2
             serialiser << data.parkParams;
             serialiser << data.cheatData;
             serialiser << data.tickStart;
-            serialiser << data.tickEnd;
+        }
 
-            uint32_t countCommands = static_cast<uint32_t>(data.commands.size());
+        // When loading, the commands, checksums and keyframes are added to the ones already read.
+        void SerialiseCommands(DataSerialiser& serialiser, std::multiset<ReplayCommand>& commands)
+        {
+            uint32_t countCommands = static_cast<uint32_t>(commands.size());
             serialiser << countCommands;
 
             if (serialiser.IsSaving())
             {
-                for (auto& command : data.commands)
+                for (auto& command : commands)
                 {
                     SerialiseCommand(serialiser, const_cast<ReplayCommand&>(command));
                 }
@@ -762,25 +922,342 @@ namespace OpenRCT2
                     ReplayCommand command = {};
                     SerialiseCommand(serialiser, command);
 
-                    data.commands.emplace(std::move(command));
+                    commands.emplace(std::move(command));
                 }
             }
+        }
 
-            uint32_t countChecksums = static_cast<uint32_t>(data.checksums.size());
+        void SerialiseChecksums(DataSerialiser& serialiser, std::vector<std::pair<uint32_t, rct_sprite_checksum>>& checksums)
+        {
+            uint32_t countChecksums = static_cast<uint32_t>(checksums.size());
             serialiser << countChecksums;
 
+            size_t first = 0;
             if (serialiser.IsLoading())
             {
-                data.checksums.resize(countChecksums);
+                first = checksums.size();
+                checksums.resize(first + countChecksums);
             }
 
-            for (uint32_t i = 0; i < countChecksums; i++)
+            for (size_t i = first; i < checksums.size(); i++)
             {
-                serialiser << data.checksums[i].first;
-                serialiser << data.checksums[i].second.raw;
+                serialiser << checksums[i].first;
+                serialiser << checksums[i].second.raw;
             }
+        }
 
-            serialiser << data.gameStateSnapshots;
+        void SerialiseKeyframes(DataSerialiser& serialiser, std::vector<ReplayKeyframe>& keyframes)
+        {
+            uint32_t countKeyframes = static_cast<uint32_t>(keyframes.size());
+            serialiser << countKeyframes;
+
+            size_t first = 0;
+            if (serialiser.IsLoading())
+            {
+                first = keyframes.size();
+                keyframes.resize(first + countKeyframes);
+            }
+
+            for (size_t i = first; i < keyframes.size(); i++)
+            {
+                auto& keyframe = keyframes[i];
+                serialiser << keyframe.tick;
+                serialiser << keyframe.commandIndex;
+                serialiser << keyframe.parkData;
+                serialiser << keyframe.parkParams;
+                serialiser << keyframe.cheatData;
+            }
+        }
+
+        bool BeginRecordingFile(const ReplayRecordData& data)
+        {
+            _recordingFile = fopen(data.filePath.c_str(), "wb");
+            if (_recordingFile == nullptr)
+            {
+                log_error("Unable to write to file '%s'", data.filePath.c_str());
+                return false;
+            }
+            _recordingFileLength = 0;
+            _recordingIndex.clear();
+
+            DataSerialiser fileSerialiser(true);
+            fileSerialiser << data.magic;
+            fileSerialiser << data.version;
+
+            DataSerialiser headerSerialiser(true);
+            SerialiseHeader(headerSerialiser, const_cast<ReplayRecordData&>(data));
+            headerSerialiser << data.gameStateSnapshots;
+
+            if (!WriteToRecordingFile(fileSerialiser.GetStream())
+                || !WriteBlock(ReplayBlockType::Header, data.tickStart, headerSerialiser.GetStream()))
+            {
+                CloseRecordingFile();
+                return false;
+            }
+            return true;
+        }
+
+        void CloseRecordingFile()
+        {
+            if (_recordingFile != nullptr)
+            {
+                fclose(_recordingFile);
+                _recordingFile = nullptr;
+            }
+        }
+
+        bool WriteToRecordingFile(const IStream& stream)
+        {
+            if (_recordingFile == nullptr)
+                return false;
+
+            size_t length = static_cast<size_t>(stream.GetLength());
+            if (fwrite(stream.GetData(), 1, length, _recordingFile) != length || fflush(_recordingFile) != 0)
+            {
+                // Keep what was written so far, a replay without an index is read up to its last complete block.
+                log_error("Unable to write the replay recording.");
+                CloseRecordingFile();
+                return false;
+            }
+            _recordingFileLength += length;
+            return true;
+        }
+
+        bool WriteBlock(ReplayBlockType type, uint32_t tick, const IStream& body)
+        {
+            unsigned long bodyLength = static_cast<unsigned long>(body.GetLength());
+            unsigned long compressLength = compressBound(bodyLength);
+            auto compressBuf = std::make_unique<unsigned char[]>(compressLength);
+            compress2(
+                compressBuf.get(), &compressLength, static_cast<const unsigned char*>(body.GetData()), bodyLength,
+                ReplayCompressionLevel);
+
+            uint8_t blockType = static_cast<uint8_t>(type);
+            uint32_t uncompressedSize = static_cast<uint32_t>(bodyLength);
+            MemoryStream data(compressBuf.get(), compressLength);
+
+            DataSerialiser blockSerialiser(true);
+            blockSerialiser << blockType;
+            blockSerialiser << tick;
+            blockSerialiser << uncompressedSize;
+            blockSerialiser << data;
+
+            uint64_t offset = _recordingFileLength;
+            if (!WriteToRecordingFile(blockSerialiser.GetStream()))
+                return false;
+
+            _recordingIndex.push_back({ offset, blockType, tick });
+            return true;
+        }
+
+        void WaitForBlockWrite()
+        {
+            if (_blockWriteTask.valid())
+                _blockWriteTask.wait();
+        }
+
+        // Writes the commands, checksums and keyframes recorded since the last block and frees them. The block is
+        // compressed and written on a worker thread, the previous one has to be finished before the file is touched.
+        void WriteDataBlock()
+        {
+            auto& data = *_currentRecording;
+            WaitForBlockWrite();
+            if (_recordingFile != nullptr)
+            {
+                auto body = std::make_shared<MemoryStream>();
+                DataSerialiser blockSerialiser(true, *body);
+                SerialiseCommands(blockSerialiser, data.commands);
+                SerialiseChecksums(blockSerialiser, data.checksums);
+                SerialiseKeyframes(blockSerialiser, data.keyframes);
+
+                uint32_t tick = gCurrentTicks;
+                _blockWriteTask = std::async(
+                    std::launch::async, [this, body, tick]() { WriteBlock(ReplayBlockType::Data, tick, *body); });
+            }
+
+            data.numCommandsWritten += static_cast<uint32_t>(data.commands.size());
+            data.numChecksumsWritten += static_cast<uint32_t>(data.checksums.size());
+            data.numKeyframesWritten += static_cast<uint32_t>(data.keyframes.size());
+            data.commands.clear();
+            data.checksums.clear();
+            data.keyframes.clear();
+        }
+
+        // The index trailer lists the offset of each block and ends with its own offset followed by ReplayIndexMagic.
+        bool WriteBlockIndex()
+        {
+            uint64_t indexOffset = _recordingFileLength;
+            uint32_t countBlocks = static_cast<uint32_t>(_recordingIndex.size());
+
+            DataSerialiser indexSerialiser(true);
+            indexSerialiser << countBlocks;
+            for (const auto& entry : _recordingIndex)
+            {
+                indexSerialiser << entry.offset;
+                indexSerialiser << entry.type;
+                indexSerialiser << entry.tick;
+            }
+            indexSerialiser << indexOffset;
+            indexSerialiser << ReplayIndexMagic;
+            return WriteToRecordingFile(indexSerialiser.GetStream());
+        }
+
+        bool ReadBlockIndex(MemoryStream& stream, std::vector<ReplayBlockIndexEntry>& index)
+        {
+            constexpr uint64_t trailerLength = sizeof(uint64_t) + sizeof(uint32_t);
+            if (stream.GetLength() < trailerLength)
+                return false;
+
+            try
+            {
+                stream.SetPosition(stream.GetLength() - trailerLength);
+                DataSerialiser trailerSerialiser(false, stream);
+                uint64_t indexOffset = 0;
+                uint32_t indexMagic = 0;
+                trailerSerialiser << indexOffset;
+                trailerSerialiser << indexMagic;
+                if (indexMagic != ReplayIndexMagic || indexOffset >= stream.GetLength())
+                    return false;
+
+                stream.SetPosition(indexOffset);
+                uint32_t countBlocks = 0;
+                trailerSerialiser << countBlocks;
+
+                // A count or an offset that does not fit the file means the index is corrupt, the blocks are scanned.
+                constexpr uint64_t entryLength = sizeof(uint64_t) + sizeof(uint8_t) + sizeof(uint32_t);
+                uint64_t indexEnd = stream.GetLength() - trailerLength;
+                if (stream.GetPosition() > indexEnd || countBlocks > (indexEnd - stream.GetPosition()) / entryLength)
+                    return false;
+
+                index.resize(countBlocks);
+                for (auto& entry : index)
+                {
+                    trailerSerialiser << entry.offset;
+                    trailerSerialiser << entry.type;
+                    trailerSerialiser << entry.tick;
+                    if (entry.offset >= indexOffset)
+                    {
+                        index.clear();
+                        return false;
+                    }
+                }
+            }
+            catch (const IOException&)
+            {
+                index.clear();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * Reads and decompresses the block at the current position of the stream.
+         * Throws IOException if the block is incomplete or corrupt.
+         */
+        ReplayBlockType ReadBlock(MemoryStream& stream, uint32_t& tick, MemoryStream& body)
+        {
+            uint8_t blockType = 0;
+            uint32_t uncompressedSize = 0;
+            uint32_t compressedSize = 0;
+
+            DataSerialiser blockSerialiser(false, stream);
+            blockSerialiser << blockType;
+            blockSerialiser << tick;
+            blockSerialiser << uncompressedSize;
+            blockSerialiser << compressedSize;
+
+            // Check the sizes before allocating, they come straight from the file.
+            uint64_t position = stream.GetPosition();
+            if (compressedSize > stream.GetLength() - position)
+            {
+                throw IOException("Replay block is incomplete.");
+            }
+            if (uncompressedSize > ReplayMaxBlockSize
+                || uncompressedSize > static_cast<uint64_t>(compressedSize) * ReplayMaxCompressionRatio)
+            {
+                throw IOException("Replay block is too large.");
+            }
+
+            auto buff = std::make_unique<unsigned char[]>(uncompressedSize);
+            unsigned long outSize = uncompressedSize;
+            int status = uncompress(
+                buff.get(), &outSize, static_cast<const unsigned char*>(stream.GetData()) + position, compressedSize);
+            stream.SetPosition(position + compressedSize);
+            if (status != Z_OK || outSize != uncompressedSize)
+            {
+                throw IOException("Replay block is corrupt.");
+            }
+            body.Write(buff.get(), outSize);
+            body.SetPosition(0);
+            return static_cast<ReplayBlockType>(blockType);
+        }
+
+        bool ReadReplayBlocks(MemoryStream& stream, ReplayRecordData& data)
+        {
+            // Recordings that were never stopped have no index, their blocks are read until the first incomplete one.
+            std::vector<ReplayBlockIndexEntry> index;
+            bool hasIndex = ReadBlockIndex(stream, index);
+            uint64_t firstBlockOffset = sizeof(data.magic) + sizeof(data.version);
+
+            bool hasHeader = false;
+            bool hasEnd = false;
+            data.tickEnd = 0;
+            for (size_t i = 0; !hasEnd && (!hasIndex || i < index.size()); i++)
+            {
+                try
+                {
+                    if (hasIndex)
+                        stream.SetPosition(index[i].offset);
+                    else if (i == 0)
+                        stream.SetPosition(firstBlockOffset);
+                    else if (stream.GetPosition() >= stream.GetLength())
+                        break;
+
+                    uint32_t tick = 0;
+                    MemoryStream body;
+                    auto blockType = ReadBlock(stream, tick, body);
+
+                    DataSerialiser serialiser(false, body);
+                    switch (blockType)
+                    {
+                        case ReplayBlockType::Header:
+                            SerialiseHeader(serialiser, data);
+                            serialiser << data.gameStateSnapshots;
+                            data.tickEnd = data.tickStart;
+                            hasHeader = true;
+                            break;
+                        case ReplayBlockType::Data:
+                            SerialiseCommands(serialiser, data.commands);
+                            SerialiseChecksums(serialiser, data.checksums);
+                            SerialiseKeyframes(serialiser, data.keyframes);
+                            data.tickEnd = std::max(data.tickEnd, tick);
+                            break;
+                        case ReplayBlockType::End:
+                            serialiser << data.tickEnd;
+                            serialiser << data.gameStateSnapshots;
+                            hasEnd = true;
+                            break;
+                        default:
+                            log_warning("Unknown replay block type %u", static_cast<uint32_t>(blockType));
+                            break;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    log_warning("Replay block %u could not be read: %s", static_cast<uint32_t>(i), e.what());
+                    break;
+                }
+            }
+
+            if (!hasHeader)
+            {
+                log_error("Replay has no header block.");
+                return false;
+            }
+            if (!hasEnd)
+            {
+                log_warning("Replay recording was not stopped, it ends at tick %u.", data.tickEnd);
+            }
             return true;
         }
 
@@ -795,7 +1272,10 @@ namespace OpenRCT2
             const auto& savedChecksum = _currentReplay->checksums[checksumIndex];
             if (_currentReplay->checksums[checksumIndex].first == gCurrentTicks)
             {
-                rct_sprite_checksum checksum = sprite_checksum();
+                auto checksumVersion = _currentReplay->version >= ReplayBlockChecksumVersion
+                    ? SpriteChecksumVersion::Blocks
+                    : SpriteChecksumVersion::Flat;
+                rct_sprite_checksum checksum = sprite_checksum(checksumVersion);
                 if (savedChecksum.second.raw != checksum.raw)
                 {
                     uint32_t replayTick = gCurrentTicks - _currentReplay->tickStart;
@@ -822,10 +1302,11 @@ namespace OpenRCT2
         void ReplayCommands()
         {
             auto& replayQueue = _currentReplay->commands;
+            auto& nextCommand = _currentReplay->nextCommand;
 
-            while (replayQueue.begin() != replayQueue.end())
+            while (nextCommand != replayQueue.end())
             {
-                const ReplayCommand& command = (*replayQueue.begin());
+                const ReplayCommand& command = *nextCommand;
 
                 if (_mode == ReplayMode::PLAYING)
                 {
@@ -853,15 +1334,15 @@ namespace OpenRCT2
                     isPositionValid = true;
                 }
 
-                // Focus camera on event.
-                if (isPositionValid && !result->Position.isNull())
+                // Focus camera on event, unless the events are skipped over.
+                if (isPositionValid && !_seeking && !result->Position.isNull())
                 {
                     auto* mainWindow = window_get_main();
                     if (mainWindow != nullptr)
                         window_scroll_to_location(mainWindow, result->Position.x, result->Position.y, result->Position.z);
                 }
 
-                replayQueue.erase(replayQueue.begin());
+                nextCommand++;
             }
         }
 
@@ -873,6 +1354,14 @@ namespace OpenRCT2
         uint32_t _commandId = 0;
         uint32_t _nextChecksumTick = 0;
         uint32_t _nextReplayTick = 0;
+        uint32_t _nextKeyframeTick = 0;
+        uint32_t _nextBlockTick = 0;
+        FILE* _recordingFile = nullptr;
+        uint64_t _recordingFileLength = 0;
+        std::vector<ReplayBlockIndexEntry> _recordingIndex;
+        // Declared after the recording file so it is finished before the file state is destroyed
+        std::future<void> _blockWriteTask;
+        bool _seeking = false;
         RecordType _recordType = RecordType::NORMAL;
     };
 
@@ -28,6 +28,7 @@ namespace OpenRCT2
         uint64_t TimeRecorded;
         uint32_t NumCommands;
         uint32_t NumChecksums;
+        uint32_t NumKeyframes;
         std::string Name;
         std::string FilePath;
     };
@@ -62,6 +63,12 @@ namespace OpenRCT2
         virtual bool IsPlaybackStateMismatching() const = 0;
         virtual bool StopPlayback() = 0;
 
+        /**
+         * Moves the playback to the given tick, relative to the start of the replay. The nearest keyframe before the
+         * tick is loaded unless the tick is reached quicker by simulating from the current tick.
+         */
+        virtual bool SeekPlayback(uint32_t replayTick) = 0;
+
         virtual bool NormaliseReplay(const std::string& inputFile, const std::string& outputFile) = 0;
     };
 
@@ -10,6 +10,7 @@
 
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/TrackData.h"
 #include "GameAction.h"
 
@@ -191,6 +192,7 @@ public:
         {
             tileElement->SetGhost(true);
         }
+        ride_footprint_update_tile(startLoc);
 
         map_invalidate_tile_full(startLoc);
 
@@ -15,6 +15,7 @@
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../world/Footpath.h"
@@ -232,6 +233,7 @@ public:
             {
                 tileElement->SetGhost(true);
             }
+            ride_footprint_update_tile(startLoc);
 
             map_invalidate_tile_full(startLoc);
 
@@ -337,6 +339,7 @@ public:
         if ((tileElement->AsTrack()->GetMazeEntry() & 0x8888) == 0x8888)
         {
             tile_element_remove(tileElement);
+            ride_footprint_update_tile(_loc);
             sub_6CB945(ride);
             ride->maze_tiles--;
         }
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "../management/Finance.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/RideGroupManager.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -622,6 +623,7 @@ public:
             {
                 tileElement->SetGhost(true);
             }
+            ride_footprint_update_tile(mapLoc);
 
             switch (_trackType)
             {
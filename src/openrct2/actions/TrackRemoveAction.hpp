@@ -10,6 +10,7 @@
 #pragma once
 
 #include "../management/Finance.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/RideGroupManager.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -448,6 +449,7 @@ public:
                 footpath_remove_edges_at(mapLoc, tileElement);
             }
             tile_element_remove(tileElement);
+            ride_footprint_update_tile(mapLoc);
             sub_6CB945(ride);
             if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
             {
@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../ParkImporter.h"
+#    include "../core/Console.hpp"
+#    include "../core/FileScanner.h"
+#    include "../core/MemoryStream.h"
+#    include "../core/Path.hpp"
+#    include "../object/ObjectRepository.h"
+#    include "../platform/Platform2.h"
+#    include "../rct2/S6Exporter.h"
+
+#    include <benchmark/benchmark.h>
+#    include <memory>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// Parks used when no park is passed, relative to the root of the source tree.
+static constexpr const char* DEFAULT_PARK_PATTERN = "test/tests/testdata/parks/*.sv6";
+
+/**
+ * Encodes the loaded park as a saved game, which is the part of saving that runs off the game thread.
+ */
+static void BM_save(benchmark::State& state, S6Exporter* snapshot)
+{
+    size_t savedLength = 0;
+    for (auto _ : state)
+    {
+        MemoryStream ms;
+        snapshot->SaveGame(&ms);
+        savedLength = static_cast<size_t>(ms.GetLength());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * savedLength);
+}
+
+/**
+ * Decodes the chunks of a saved game, without importing it into the game state.
+ */
+static void BM_load(benchmark::State& state, IContext* context, const std::vector<uint8_t>* savedGame)
+{
+    for (auto _ : state)
+    {
+        MemoryStream ms(savedGame->data(), savedGame->size());
+        auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+        importer->LoadFromStream(&ms, false);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * savedGame->size());
+}
+
+static std::vector<std::string> GetDefaultParks()
+{
+    std::vector<std::string> parks;
+    auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(DEFAULT_PARK_PATTERN, false));
+    while (scanner->Next())
+    {
+        parks.push_back(scanner->GetPath());
+    }
+    return parks;
+}
+
+static int cmdline_for_bench_save_load(int argc, const char** argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    std::vector<std::string> parks;
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            parks.push_back(argv[i]);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+
+    if (parks.empty())
+    {
+        parks = GetDefaultParks();
+    }
+    if (parks.empty())
+    {
+        Console::Error::WriteLine("No parks to save, pass park files or run from the root of the source tree.");
+        return -1;
+    }
+
+    core_init();
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return -1;
+    }
+
+    // Each park is loaded once up front, the benchmarks then encode and decode that snapshot.
+    std::vector<std::unique_ptr<S6Exporter>> snapshots;
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> savedGames;
+    for (const auto& park : parks)
+    {
+        if (!context->LoadParkFromFile(park))
+        {
+            Console::Error::WriteLine("Failed to load park '%s'.", park.c_str());
+            return -1;
+        }
+
+        auto snapshot = std::make_unique<S6Exporter>();
+        snapshot->RemoveTracklessRides = true;
+        snapshot->Export();
+
+        // Keep the encoded park to benchmark loading it
+        MemoryStream ms;
+        snapshot->SaveGame(&ms);
+        auto data = static_cast<const uint8_t*>(ms.GetData());
+        auto savedGame = std::make_unique<std::vector<uint8_t>>(data, data + ms.GetLength());
+
+        const auto name = Path::GetFileName(park);
+        benchmark::RegisterBenchmark((name + "/save").c_str(), BM_save, snapshot.get())->UseRealTime();
+        benchmark::RegisterBenchmark((name + "/load").c_str(), BM_load, context.get(), savedGame.get())->UseRealTime();
+        snapshots.push_back(std::move(snapshot));
+        savedGames.push_back(std::move(savedGame));
+    }
+
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchSaveLoad(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_save_load(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchSaveLoad(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSaveLoadCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[<file>]... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchSaveLoad),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchSaveLoad), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,200 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../Game.h"
+#    include "../GameState.h"
+#    include "../OpenRCT2.h"
+#    include "../core/Console.hpp"
+#    include "../core/FileScanner.h"
+#    include "../core/Path.hpp"
+#    include "../core/String.hpp"
+#    include "../platform/Platform2.h"
+#    include "../world/Sprite.h"
+
+#    include <benchmark/benchmark.h>
+#    include <chrono>
+#    include <iterator>
+#    include <memory>
+#    include <optional>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// Parks used when no park is passed, relative to the root of the source tree.
+static constexpr const char* DEFAULT_PARK_PATTERN = "test/tests/testdata/parks/*.sv6";
+
+static constexpr const char* GameUpdateStageNames[] = {
+    "network_update",
+    "map_update_tiles",
+    "peep_update_all",
+    "vehicle_update_all",
+    "sprite_misc_update_all",
+    "Ride::UpdateAll",
+    "Park::Update",
+    "ride_ratings_update_all",
+    "GameActions::ProcessQueue",
+};
+static_assert(std::size(GameUpdateStageNames) == static_cast<size_t>(GameUpdateStage::Count));
+
+/**
+ * Times whole ticks when no stage is given, otherwise only the time spent in the given stage of each tick is reported.
+ * The park is loaded again for every run so that every build simulates the same ticks.
+ */
+static void BM_update_logic(
+    benchmark::State& state, IContext* context, const std::string& parkPath, std::optional<GameUpdateStage> stage)
+{
+    if (!context->LoadParkFromFile(parkPath))
+    {
+        state.SkipWithError("Failed to load park");
+        return;
+    }
+
+    auto* gameState = context->GetGameState();
+    gameState->SetStageTimingEnabled(stage.has_value());
+    for (auto _ : state)
+    {
+        gameState->UpdateLogic();
+        if (stage)
+        {
+            state.SetIterationTime(std::chrono::duration<double>(gameState->GetStageTime(*stage)).count());
+        }
+    }
+    gameState->SetStageTimingEnabled(false);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["sprites"] = sprite_get_capacity() - gSpriteListCount[SPRITE_LIST_FREE];
+}
+
+static std::vector<std::string> GetDefaultParks()
+{
+    std::vector<std::string> parks;
+    auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(DEFAULT_PARK_PATTERN, false));
+    while (scanner->Next())
+    {
+        parks.push_back(scanner->GetPath());
+    }
+    return parks;
+}
+
+static int cmdline_for_bench_simulate(int argc, const char** argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    std::vector<std::string> parks;
+    bool hasFormat = false;
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            parks.push_back(argv[i]);
+        }
+        else
+        {
+            hasFormat |= String::StartsWith(argv[i], "--benchmark_format");
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+
+    // Results are meant to be compared across builds, so default to JSON rather than the console table.
+    static char jsonFormat[] = "--benchmark_format=json";
+    if (!hasFormat)
+    {
+        argv_for_benchmark.push_back(jsonFormat);
+    }
+
+    if (parks.empty())
+    {
+        parks = GetDefaultParks();
+    }
+    if (parks.empty())
+    {
+        Console::Error::WriteLine("No parks to simulate, pass park files or run from the root of the source tree.");
+        return -1;
+    }
+
+    core_init();
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return -1;
+    }
+
+    for (const auto& park : parks)
+    {
+        const auto name = Path::GetFileName(park);
+        benchmark::RegisterBenchmark((name + "/tick").c_str(), BM_update_logic, context.get(), park, std::nullopt)
+            ->UseRealTime();
+        for (size_t i = 0; i < static_cast<size_t>(GameUpdateStage::Count); i++)
+        {
+            benchmark::RegisterBenchmark(
+                (name + "/" + GameUpdateStageNames[i]).c_str(), BM_update_logic, context.get(), park,
+                static_cast<GameUpdateStage>(i))
+                ->UseManualTime();
+        }
+    }
+
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchSimulate(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_simulate(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchSimulate(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSimulateCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[<file>]... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchSimulate),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchSimulate), CommandTableEnd
+#endif // USE_BENCHMARK
+};
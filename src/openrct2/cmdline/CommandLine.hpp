@@ -118,7 +118,11 @@ namespace CommandLine
     extern const CommandLineCommand SpriteCommands[];
     extern const CommandLineCommand BenchGfxCommands[];
     extern const CommandLineCommand BenchSpriteSortCommands[];
+    extern const CommandLineCommand BenchSimulateCommands[];
+    extern const CommandLineCommand BenchSaveLoadCommands[];
     extern const CommandLineCommand SimulateCommands[];
+    extern const CommandLineCommand ReplayCommands[];
+    extern const CommandLineCommand ReplayVerifyCommands[];
 
     extern const CommandLineExample RootExamples[];
 
@@ -9,6 +9,7 @@
 
 #include "../FileClassifier.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../common.h"
 #include "../core/Console.hpp"
@@ -55,18 +56,36 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
     uint32_t destinationFileType = get_file_extension_type(destinationPath);
 
     // Validate target type
-    if (destinationFileType != FILE_EXTENSION_SC6 && destinationFileType != FILE_EXTENSION_SV6)
+    if (destinationFileType != FILE_EXTENSION_SC6 && destinationFileType != FILE_EXTENSION_SV6
+        && destinationFileType != FILE_EXTENSION_PARK)
     {
-        Console::Error::WriteLine("Only conversion to .SC6 or .SV4 is supported.");
+        Console::Error::WriteLine("Only conversion to .SC6, .SV6 or .PARK is supported.");
         return EXITCODE_FAIL;
     }
 
     // Validate the source type
+    bool sourceIsScenario = sourceFileType == FILE_EXTENSION_SC4 || sourceFileType == FILE_EXTENSION_SC6;
     switch (sourceFileType)
     {
         case FILE_EXTENSION_SC4:
         case FILE_EXTENSION_SV4:
             break;
+        case FILE_EXTENSION_PARK:
+        {
+            if (destinationFileType == FILE_EXTENSION_PARK)
+            {
+                Console::Error::WriteLine("File is already a park file.");
+                return EXITCODE_FAIL;
+            }
+            ClassifiedFileInfo info;
+            if (!TryClassifyFile(sourcePath, &info))
+            {
+                Console::Error::WriteLine("Unable to read the park file.");
+                return EXITCODE_FAIL;
+            }
+            sourceIsScenario = info.Type == FILE_TYPE::SCENARIO;
+            break;
+        }
         case FILE_EXTENSION_SC6:
             if (destinationFileType == FILE_EXTENSION_SC6)
             {
@@ -82,7 +101,7 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
             }
             break;
         default:
-            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6 or .SV6 is supported.");
+            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6, .SV6 or .PARK is supported.");
             return EXITCODE_FAIL;
     }
 
@@ -108,7 +127,7 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
         return EXITCODE_FAIL;
     }
 
-    if (sourceFileType == FILE_EXTENSION_SC4 || sourceFileType == FILE_EXTENSION_SC6)
+    if (sourceIsScenario)
     {
         // We are converting a scenario, so reset the park
         scenario_begin();
@@ -123,7 +142,19 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
         window_close_by_class(WC_MAIN_WINDOW);
 
         exporter->Export();
-        if (destinationFileType == FILE_EXTENSION_SC6)
+        if (destinationFileType == FILE_EXTENSION_PARK)
+        {
+            auto parkFileExporter = ParkFileExporter(*exporter);
+            if (sourceIsScenario)
+            {
+                parkFileExporter.SaveScenario(destinationPath);
+            }
+            else
+            {
+                parkFileExporter.SaveGame(destinationPath);
+            }
+        }
+        else if (destinationFileType == FILE_EXTENSION_SC6)
         {
             exporter->SaveScenario(destinationPath);
         }
@@ -162,6 +193,8 @@ static const utf8* GetFileTypeFriendlyName(uint32_t fileType)
             return "RollerCoaster Tycoon 2 scenario";
         case FILE_EXTENSION_SV6:
             return "RollerCoaster Tycoon 2 saved game";
+        case FILE_EXTENSION_PARK:
+            return "OpenRCT2 park file";
     }
 
     assert(false);
@@ -0,0 +1,232 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../GameState.h"
+#include "../OpenRCT2.h"
+#include "../ReplayManager.h"
+#include "../core/Console.hpp"
+#include "../core/FileScanner.h"
+#include "../core/Path.hpp"
+#include "../platform/Platform2.h"
+#include "../platform/platform.h"
+#include "CommandLine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// Last line printed by the replay command, read by replay-verify from the output of each replay process.
+static constexpr const char* ReplayResultFormat = "Replay result: ticks=%u seconds=%lf mismatch_tick=%d";
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleReplayVerify(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::ReplayCommands[]{
+    // Main commands
+    DefineCommand("", "<replay-file> [<from-tick>]", nullptr, HandleReplay), CommandTableEnd
+};
+
+const CommandLineCommand CommandLine::ReplayVerifyCommands[]{
+    // Main commands
+    DefineCommand("", "<directory> [<jobs>]", nullptr, HandleReplayVerify), CommandTableEnd
+};
+
+/**
+ * Plays a replay headless and as fast as possible, the exit code tells whether the game state matched the recording.
+ */
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 1)
+    {
+        Console::Error::WriteLine("Missing arguments <replay-file> [<from-tick>].");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* inputPath = argv[0];
+    uint32_t fromTick = argc >= 2 ? static_cast<uint32_t>(atol(argv[1])) : 0;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    auto* replayManager = context->GetReplayManager();
+    if (!replayManager->StartPlayback(inputPath))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", inputPath);
+        return EXITCODE_FAIL;
+    }
+
+    ReplayRecordInfo info;
+    replayManager->GetCurrentReplayInfo(info);
+    Console::WriteLine("Playing %u ticks from tick %u...", info.Ticks, fromTick);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    if (fromTick != 0 && !replayManager->SeekPlayback(fromTick))
+    {
+        Console::Error::WriteLine("Unable to move the replay to tick %u.", fromTick);
+        return EXITCODE_FAIL;
+    }
+
+    // The state is checked at the start of each tick, before it is simulated.
+    uint32_t replayTick = fromTick;
+    bool mismatching = replayManager->IsPlaybackStateMismatching();
+    auto* gameState = context->GetGameState();
+    while (replayManager->IsReplaying() && !mismatching)
+    {
+        gameState->UpdateLogic();
+        mismatching = replayManager->IsPlaybackStateMismatching();
+        if (!mismatching)
+            replayTick++;
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+
+    Console::WriteLine("Completed in %.2f seconds (%.0f ticks/s)", duration.count(), info.Ticks / duration.count());
+    Console::WriteLine(
+        ReplayResultFormat, std::min(replayTick, info.Ticks), duration.count(),
+        mismatching ? static_cast<int32_t>(replayTick) : -1);
+    if (mismatching)
+    {
+        Console::Error::WriteLine("Game state does not match the replay at tick %u.", replayTick);
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+struct ReplayVerifyResult
+{
+    int32_t ExitCode = -1;
+    bool HasResult = false;
+    uint32_t Ticks = 0;
+    double Seconds = 0;
+    int32_t MismatchTick = -1;
+};
+
+static ReplayVerifyResult RunReplayProcess(const std::string& exePath, const std::string& replayPath)
+{
+    ReplayVerifyResult result;
+    std::string output;
+    result.ExitCode = Platform::Execute(exePath, { "replay", replayPath }, &output);
+
+    // Only the result line matters, everything else the process printed is ignored.
+    const char* prefix = "Replay result:";
+    auto pos = output.rfind(prefix);
+    if (pos != std::string::npos)
+    {
+        result.HasResult = std::sscanf(
+                               output.c_str() + pos, ReplayResultFormat, &result.Ticks, &result.Seconds,
+                               &result.MismatchTick)
+            == 3;
+    }
+    return result;
+}
+
+/**
+ * Plays all replays in a directory, each in its own headless process so that they can run in parallel.
+ */
+static exitcode_t HandleReplayVerify(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 1)
+    {
+        Console::Error::WriteLine("Missing arguments <directory> [<jobs>].");
+        return EXITCODE_FAIL;
+    }
+
+    std::vector<std::string> replayPaths;
+    auto pattern = Path::Combine(argv[0], "*.sv6r");
+    std::unique_ptr<IFileScanner> scanner(Path::ScanDirectory(pattern, true));
+    while (scanner->Next())
+    {
+        replayPaths.push_back(scanner->GetPath());
+    }
+    std::sort(replayPaths.begin(), replayPaths.end());
+    if (replayPaths.empty())
+    {
+        Console::Error::WriteLine("No replays found in '%s'.", argv[0]);
+        return EXITCODE_FAIL;
+    }
+
+    size_t numJobs = std::max(1u, std::thread::hardware_concurrency());
+    if (argc >= 2 && atoi(argv[1]) > 0)
+    {
+        numJobs = static_cast<size_t>(atoi(argv[1]));
+    }
+    numJobs = std::min(numJobs, replayPaths.size());
+
+    auto exePath = Platform::GetCurrentExecutablePath();
+    Console::WriteLine("Verifying %zu replays using %zu processes...", replayPaths.size(), numJobs);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<ReplayVerifyResult> results(replayPaths.size());
+    std::atomic<size_t> nextReplay{ 0 };
+    std::mutex consoleMutex;
+    auto worker = [&]() {
+        for (size_t i = nextReplay++; i < replayPaths.size(); i = nextReplay++)
+        {
+            auto& result = results[i];
+            result = RunReplayProcess(exePath, replayPaths[i]);
+
+            auto name = Path::GetFileName(replayPaths[i]);
+            std::lock_guard<std::mutex> lock(consoleMutex);
+            if (!result.HasResult)
+            {
+                Console::WriteLine("ERROR %s (exit code %d)", name.c_str(), result.ExitCode);
+            }
+            else if (result.MismatchTick != -1 || result.ExitCode != EXITCODE_OK)
+            {
+                Console::WriteLine("FAIL  %s (mismatch at tick %d)", name.c_str(), result.MismatchTick);
+            }
+            else
+            {
+                Console::WriteLine(
+                    "PASS  %s (%u ticks, %.0f ticks/s)", name.c_str(), result.Ticks, result.Ticks / result.Seconds);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numJobs; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+
+    size_t numPassed = std::count_if(results.begin(), results.end(), [](const ReplayVerifyResult& result) {
+        return result.HasResult && result.MismatchTick == -1 && result.ExitCode == EXITCODE_OK;
+    });
+    Console::WriteLine("%zu of %zu replays passed in %.1f seconds.", numPassed, results.size(), duration.count());
+    return numPassed == results.size() ? EXITCODE_OK : EXITCODE_FAIL;
+}
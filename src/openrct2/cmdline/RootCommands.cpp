@@ -140,7 +140,11 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("sprite",          CommandLine::SpriteCommands           ),
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
+    DefineSubCommand("benchsimulate",   CommandLine::BenchSimulateCommands    ),
+    DefineSubCommand("benchsaveload",   CommandLine::BenchSaveLoadCommands    ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
+    DefineSubCommand("replay",          CommandLine::ReplayCommands           ),
+    DefineSubCommand("replay-verify",   CommandLine::ReplayVerifyCommands     ),
     CommandTableEnd
 };
 
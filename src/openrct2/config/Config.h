@@ -72,6 +72,7 @@ struct GeneralConfiguration
     bool play_intro;
     int32_t window_snap_proximity;
     bool allow_loading_with_incorrect_checksum;
+    int32_t sprite_limit;
     bool save_plugin_data;
     bool debugging_tools;
     int32_t autosave_frequency;
@@ -150,6 +151,7 @@ struct NetworkConfiguration
     bool log_server_actions;
     bool pause_server_if_no_clients;
     bool desync_debugging;
+    int32_t desync_snapshot_history;
 };
 
 struct NotificationConfiguration
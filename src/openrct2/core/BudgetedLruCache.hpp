@@ -0,0 +1,220 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#ifndef __MACOSX__
+#    include <shared_mutex>
+#endif
+#include <unordered_map>
+#include <unordered_set>
+
+namespace OpenRCT2
+{
+    struct CacheStats
+    {
+        uint64_t Hits{};
+        uint64_t Misses{};
+        uint64_t Evictions{};
+        size_t Entries{};
+        size_t MemoryUsage{};
+        size_t MemoryBudget{};
+    };
+
+    /**
+     * Cache of immutable values that are shared with the callers, limited by the memory usage the values report through
+     * GetMemoryUsage(). A key is only admitted once it has missed twice, so values that are only used once do not push
+     * out the ones used all the time.
+     *
+     * Lookups only take a shared lock and mark the entry as used. Entries are evicted in least recently inserted order,
+     * giving entries that have been used since a second chance. Whether a value is still valid for what is looked up is
+     * left to the caller, which reports the outcome with CountHit or CountMiss.
+     */
+    template<typename TKey, typename TValue, typename THash = std::hash<TKey>> class BudgetedLruCache final
+    {
+    private:
+        static constexpr size_t MaxRecentMisses = 4096;
+
+        struct Entry
+        {
+            TKey Key;
+            std::shared_ptr<const TValue> Value;
+            // Set by lookups, cleared when the entry gets its second chance
+            mutable std::atomic_bool Referenced = { false };
+
+            Entry(const TKey& key, std::shared_ptr<const TValue> value)
+                : Key(key)
+                , Value(std::move(value))
+            {
+            }
+        };
+
+#ifndef __MACOSX__
+        mutable std::shared_mutex _mutex;
+        using shared_lock = std::shared_lock<std::shared_mutex>;
+        using unique_lock = std::unique_lock<std::shared_mutex>;
+#else
+        mutable std::mutex _mutex;
+        using shared_lock = std::unique_lock<std::mutex>;
+        using unique_lock = std::unique_lock<std::mutex>;
+#endif
+        // Front is the most recently inserted entry
+        std::list<Entry> _entries;
+        std::unordered_map<TKey, typename std::list<Entry>::iterator, THash> _index;
+        std::unordered_set<TKey, THash> _recentMisses;
+        size_t _memoryUsage{};
+        size_t _memoryBudget;
+        CacheStats _stats;
+        // Hits are counted without the exclusive lock
+        std::atomic<uint64_t> _hits{};
+
+    public:
+        explicit BudgetedLruCache(size_t memoryBudget)
+            : _memoryBudget(memoryBudget)
+        {
+        }
+
+        /**
+         * Gets the value of the key and marks it as used, or nullptr if the key is not cached.
+         */
+        std::shared_ptr<const TValue> Find(const TKey& key) const
+        {
+            shared_lock lock(_mutex);
+            auto it = _index.find(key);
+            if (it == _index.end())
+                return nullptr;
+            it->second->Referenced.store(true, std::memory_order_relaxed);
+            return it->second->Value;
+        }
+
+        void CountHit()
+        {
+            _hits.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Counts a miss of the key, dropping the stale value found for it unless it has been replaced meanwhile.
+         * @return true if the key has missed before, a value should then be created and inserted.
+         */
+        bool CountMiss(const TKey& key, const std::shared_ptr<const TValue>& staleValue = nullptr)
+        {
+            unique_lock lock(_mutex);
+            if (staleValue != nullptr)
+            {
+                auto it = _index.find(key);
+                if (it != _index.end() && it->second->Value == staleValue)
+                {
+                    RemoveEntry(it->second);
+                }
+            }
+
+            _stats.Misses++;
+            if (_recentMisses.size() >= MaxRecentMisses)
+            {
+                _recentMisses.clear();
+            }
+            if (_recentMisses.insert(key).second)
+            {
+                return false;
+            }
+            _recentMisses.erase(key);
+            return true;
+        }
+
+        /**
+         * Adds the value of the key, replacing the value another thread may have inserted first.
+         */
+        void Insert(const TKey& key, std::shared_ptr<const TValue> value)
+        {
+            unique_lock lock(_mutex);
+            auto it = _index.find(key);
+            if (it != _index.end())
+            {
+                RemoveEntry(it->second);
+            }
+
+            _memoryUsage += value->GetMemoryUsage();
+            _entries.emplace_front(key, std::move(value));
+            _index[key] = _entries.begin();
+            Trim();
+        }
+
+        /**
+         * Removes the value of the key, the key has to miss twice again before it is cached.
+         */
+        void Remove(const TKey& key)
+        {
+            unique_lock lock(_mutex);
+            auto it = _index.find(key);
+            if (it != _index.end())
+            {
+                RemoveEntry(it->second);
+            }
+            _recentMisses.erase(key);
+        }
+
+        void Clear()
+        {
+            unique_lock lock(_mutex);
+            _entries.clear();
+            _index.clear();
+            _recentMisses.clear();
+            _memoryUsage = 0;
+        }
+
+        void SetMemoryBudget(size_t memoryBudget)
+        {
+            unique_lock lock(_mutex);
+            _memoryBudget = memoryBudget;
+            Trim();
+        }
+
+        CacheStats GetStats() const
+        {
+            unique_lock lock(_mutex);
+            auto stats = _stats;
+            stats.Hits = _hits;
+            stats.Entries = _entries.size();
+            stats.MemoryUsage = _memoryUsage;
+            stats.MemoryBudget = _memoryBudget;
+            return stats;
+        }
+
+    private:
+        void RemoveEntry(typename std::list<Entry>::iterator it)
+        {
+            _memoryUsage -= it->Value->GetMemoryUsage();
+            _index.erase(it->Key);
+            _entries.erase(it);
+        }
+
+        void Trim()
+        {
+            while (_memoryUsage > _memoryBudget && !_entries.empty())
+            {
+                auto oldest = std::prev(_entries.end());
+                if (oldest->Referenced.exchange(false, std::memory_order_relaxed) && oldest != _entries.begin())
+                {
+                    _entries.splice(_entries.begin(), _entries, oldest);
+                    continue;
+                }
+                RemoveEntry(oldest);
+                _stats.Evictions++;
+            }
+        }
+    };
+} // namespace OpenRCT2
@@ -205,7 +205,8 @@ private:
         const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
-            JobPool jobPool;
+            auto& jobPool = JobPool::Get();
+            JobPool::TaskGroup jobs;
             std::mutex printLock; // For verbose prints.
 
             std::list<std::vector<TItem>> containers;
@@ -228,14 +229,15 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                const size_t rangeEnd = rangeStart + stepSize;
+                jobPool.AddTask(jobs, [this, language, &scanResult, rangeStart, rangeEnd, &items, &processed, &printLock]() {
+                    BuildRange(language, scanResult, rangeStart, rangeEnd, items, processed, printLock);
+                });
 
                 reportProgress();
             }
 
-            jobPool.Join(reportProgress);
+            jobPool.Join(jobs, reportProgress);
 
             for (auto&& itr : containers)
             {
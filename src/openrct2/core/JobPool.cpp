@@ -0,0 +1,258 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "JobPool.hpp"
+
+#include <cassert>
+
+// Index of the queue owned by the current thread, threads outside of any pool use the shared queue at index 0.
+static thread_local const JobPool* _currentPool = nullptr;
+static thread_local size_t _currentQueueIndex = 0;
+
+bool JobPool::TaskQueue::Push(const Task& task)
+{
+    std::lock_guard<SpinLock> lock(Lock);
+    if (Count == QueueCapacity)
+    {
+        return false;
+    }
+    Tasks[(Head + Count) % QueueCapacity] = task;
+    Count++;
+    return true;
+}
+
+bool JobPool::TaskQueue::PopBack(Task& task)
+{
+    std::lock_guard<SpinLock> lock(Lock);
+    if (Count == 0)
+    {
+        return false;
+    }
+    Count--;
+    task = Tasks[(Head + Count) % QueueCapacity];
+    return true;
+}
+
+bool JobPool::TaskQueue::PopFront(Task& task)
+{
+    std::lock_guard<SpinLock> lock(Lock);
+    if (Count == 0)
+    {
+        return false;
+    }
+    task = Tasks[Head];
+    Head = (Head + 1) % QueueCapacity;
+    Count--;
+    return true;
+}
+
+bool JobPool::TaskQueue::PopGroup(Task& task, const TaskGroup& group, bool fromBack)
+{
+    std::lock_guard<SpinLock> lock(Lock);
+    if (Count == 0)
+    {
+        return false;
+    }
+
+    const size_t position = (Head + (fromBack ? Count - 1 : 0)) % QueueCapacity;
+    if (Tasks[position].Group != &group)
+    {
+        return false;
+    }
+
+    task = Tasks[position];
+    if (!fromBack)
+    {
+        Head = (Head + 1) % QueueCapacity;
+    }
+    Count--;
+    return true;
+}
+
+JobPool::JobPool(size_t numWorkers)
+{
+    // Queue 0 is shared by all threads that are not part of the pool.
+    for (size_t n = 0; n < numWorkers + 1; n++)
+    {
+        _queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t n = 0; n < numWorkers; n++)
+    {
+        _threads.emplace_back(&JobPool::ProcessQueue, this, n + 1);
+    }
+}
+
+JobPool::~JobPool()
+{
+    {
+        unique_lock lock(_mutex);
+        _shouldStop = true;
+        _condPending.notify_all();
+    }
+
+    for (auto&& th : _threads)
+    {
+        assert(th.joinable() != false);
+        th.join();
+    }
+}
+
+JobPool& JobPool::Get()
+{
+    // The thread joining a group also executes tasks, so one less worker than hardware threads is needed.
+    static JobPool instance([]() -> size_t {
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }());
+    return instance;
+}
+
+void JobPool::Join(TaskGroup& group, const std::function<void()>& reportFn)
+{
+    auto lastReport = std::chrono::steady_clock::now();
+    while (group.GetPending() != 0)
+    {
+        const size_t submitted = _submitted.load();
+        // Without workers nobody else runs the tasks that are in front of the tasks of the group.
+        Task task;
+        if (TryGetGroupTask(task, group) || (_threads.empty() && TryGetTask(task)))
+        {
+            Execute(task);
+        }
+        else
+        {
+            // Nothing left to help with, wait for the remaining tasks to be completed by the workers. Tasks of the
+            // group may still be added from within its running tasks, so wake up for new tasks as well.
+            unique_lock lock(_mutex);
+            _waitingJoins.fetch_add(1);
+            _condComplete.wait_for(lock, std::chrono::milliseconds(100), [this, &group, submitted]() {
+                return group.GetPending() == 0 || _submitted.load() != submitted;
+            });
+            _waitingJoins.fetch_sub(1);
+        }
+
+        if (reportFn)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= std::chrono::milliseconds(100))
+            {
+                reportFn();
+                lastReport = now;
+            }
+        }
+    }
+
+    if (reportFn)
+    {
+        reportFn();
+    }
+}
+
+void JobPool::Submit(const Task& task)
+{
+    size_t queueIndex = _currentPool == this ? _currentQueueIndex : 0;
+    _queued.fetch_add(1);
+    if (!_queues[queueIndex]->Push(task))
+    {
+        // Queue is full, run the task right away rather than allocating more space.
+        _queued.fetch_sub(1);
+        Task overflowTask = task;
+        Execute(overflowTask);
+        return;
+    }
+
+    _submitted.fetch_add(1);
+    if (_sleeping.load() != 0 || _waitingJoins.load() != 0)
+    {
+        unique_lock lock(_mutex);
+        _condPending.notify_one();
+        _condComplete.notify_all();
+    }
+}
+
+bool JobPool::TryGetTask(Task& task)
+{
+    if (_queued.load() == 0)
+    {
+        return false;
+    }
+
+    // Own work first, newest task first for cache locality.
+    size_t ownIndex = _currentPool == this ? _currentQueueIndex : 0;
+    bool found = _queues[ownIndex]->PopBack(task);
+
+    // Otherwise steal the oldest task of another queue.
+    const size_t numQueues = _queues.size();
+    for (size_t n = 1; !found && n < numQueues; n++)
+    {
+        found = _queues[(ownIndex + n) % numQueues]->PopFront(task);
+    }
+
+    if (found)
+    {
+        _queued.fetch_sub(1);
+    }
+    return found;
+}
+
+bool JobPool::TryGetGroupTask(Task& task, const TaskGroup& group)
+{
+    if (_queued.load() == 0)
+    {
+        return false;
+    }
+
+    // Same order as TryGetTask, but other groups are skipped.
+    size_t ownIndex = _currentPool == this ? _currentQueueIndex : 0;
+    bool found = _queues[ownIndex]->PopGroup(task, group, true);
+    const size_t numQueues = _queues.size();
+    for (size_t n = 1; !found && n < numQueues; n++)
+    {
+        found = _queues[(ownIndex + n) % numQueues]->PopGroup(task, group, false);
+    }
+
+    if (found)
+    {
+        _queued.fetch_sub(1);
+    }
+    return found;
+}
+
+void JobPool::Execute(Task& task)
+{
+    auto* group = task.Group;
+    task.Invoke(task);
+    if (group->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        unique_lock lock(_mutex);
+        _condComplete.notify_all();
+    }
+}
+
+void JobPool::ProcessQueue(size_t queueIndex)
+{
+    _currentPool = this;
+    _currentQueueIndex = queueIndex;
+
+    while (!_shouldStop)
+    {
+        Task task;
+        if (TryGetTask(task))
+        {
+            Execute(task);
+            continue;
+        }
+
+        // Wait for work or cancelation.
+        unique_lock lock(_mutex);
+        _sleeping.fetch_add(1);
+        _condPending.wait(lock, [this]() { return _shouldStop || _queued.load() != 0; });
+        _sleeping.fetch_sub(1);
+    }
+}
@@ -1,5 +1,5 @@
 /*****************************************************************************
- * Copyright (c) 2014-2019 OpenRCT2 developers
+ * Copyright (c) 2014-2020 OpenRCT2 developers
  *
  * For a complete list of all authors, please refer to contributors.md
  * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
@@ -11,145 +11,201 @@
 
 #include <algorithm>
 #include <atomic>
-#include <cassert>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+/**
+ * Work-stealing task scheduler. Every worker thread owns a queue which it pushes to and pops from at the back, idle
+ * workers steal from the front of other queues. Threads that are not part of the pool submit to a shared queue.
+ *
+ * Tasks are stored inline in the queues, so submitting a task never allocates. Waiting for a task group executes
+ * pending tasks of that group on the calling thread, which makes it safe to wait from within a task. Tasks of other
+ * groups are left to the workers, so waiting for a short group never runs a long task someone else submitted.
+ *
+ * Use JobPool::Get() for the process-wide instance rather than creating pools.
+ */
 class JobPool
 {
-private:
-    struct TaskData
+public:
+    /**
+     * Tracks a set of tasks so that they can be waited on with Join.
+     */
+    class TaskGroup
     {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
+        friend class JobPool;
+
+    private:
+        std::atomic<size_t> _pending = { 0 };
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-            : WorkFn(workFn)
-            , CompletionFn(completionFn)
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        size_t GetPending() const
         {
+            return _pending.load(std::memory_order_acquire);
         }
     };
 
-    std::atomic_bool _shouldStop = { false };
-    std::atomic<size_t> _processing = { 0 };
-    std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
-    std::condition_variable _condPending;
-    std::condition_variable _condComplete;
-    std::mutex _mutex;
-
-    using unique_lock = std::unique_lock<std::mutex>;
+private:
+    static constexpr size_t TaskStorageSize = 64;
+    static constexpr size_t QueueCapacity = 1024;
 
-public:
-    JobPool(size_t maxThreads = 255)
+    struct Task
     {
-        maxThreads = std::min<size_t>(maxThreads, std::thread::hardware_concurrency());
-        for (size_t n = 0; n < maxThreads; n++)
-        {
-            _threads.emplace_back(&JobPool::ProcessQueue, this);
-        }
-    }
+        void (*Invoke)(Task& task) = nullptr;
+        TaskGroup* Group = nullptr;
+        alignas(std::max_align_t) unsigned char Storage[TaskStorageSize]{};
+    };
 
-    ~JobPool()
+    class SpinLock
     {
+    private:
+        std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+
+    public:
+        void lock()
         {
-            unique_lock lock(_mutex);
-            _shouldStop = true;
-            _condPending.notify_all();
+            while (_flag.test_and_set(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
         }
 
-        for (auto&& th : _threads)
+        void unlock()
         {
-            assert(th.joinable() != false);
-            th.join();
+            _flag.clear(std::memory_order_release);
         }
-    }
-
-    void AddTask(std::function<void()> workFn, std::function<void()> completionFn = nullptr)
-    {
-        unique_lock lock(_mutex);
-        _pending.emplace_back(workFn, completionFn);
-        _condPending.notify_one();
-    }
+    };
 
-    void Join(std::function<void()> reportFn = nullptr)
+    /**
+     * Fixed capacity ring buffer of tasks. The owner uses the back, thieves use the front.
+     */
+    struct TaskQueue
     {
-        unique_lock lock(_mutex);
-        while (true)
-        {
-            // Wait for the queue to become empty or having completed tasks.
-            _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
-
-            // Dispatch all completion callbacks if there are any.
-            while (!_completed.empty())
-            {
-                auto taskData = _completed.front();
-                _completed.pop_front();
-
-                if (taskData.CompletionFn)
-                {
-                    lock.unlock();
-
-                    taskData.CompletionFn();
-
-                    lock.lock();
-                }
-            }
-
-            if (reportFn)
-            {
-                lock.unlock();
+        SpinLock Lock;
+        size_t Head = 0;
+        size_t Count = 0;
+        Task Tasks[QueueCapacity];
+
+        bool Push(const Task& task);
+        bool PopBack(Task& task);
+        bool PopFront(Task& task);
+        // Takes the task at the back or front only if it belongs to the given group
+        bool PopGroup(Task& task, const TaskGroup& group, bool fromBack);
+    };
 
-                reportFn();
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::atomic_bool _shouldStop = { false };
+    std::atomic<size_t> _queued = { 0 };
+    std::atomic<size_t> _sleeping = { 0 };
+    std::atomic<size_t> _submitted = { 0 };
+    std::atomic<size_t> _waitingJoins = { 0 };
+    std::mutex _mutex;
+    std::condition_variable _condPending;
+    std::condition_variable _condComplete;
 
-                lock.lock();
-            }
+    using unique_lock = std::unique_lock<std::mutex>;
 
-            // If everything is empty and no more work has to be done we can stop waiting.
-            if (_completed.empty() && _pending.empty() && _processing == 0)
-            {
-                break;
-            }
-        }
+public:
+    /**
+     * Creates a pool with the given number of worker threads, a pool without workers runs tasks when they are joined.
+     */
+    explicit JobPool(size_t numWorkers);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    /**
+     * Gets the process-wide job pool, created on first use.
+     */
+    static JobPool& Get();
+
+    /**
+     * Number of threads which execute tasks, including the thread that waits on a group.
+     */
+    size_t GetConcurrency() const
+    {
+        return _threads.size() + 1;
     }
 
-    size_t CountPending()
+    /**
+     * Queues a task in the given group. The function object is stored inline so it must be trivially copyable and
+     * fit in TaskStorageSize, capture pointers or references to larger state.
+     */
+    template<typename TFunc> void AddTask(TaskGroup& group, TFunc&& func)
     {
-        return _pending.size();
+        using TFuncType = std::decay_t<TFunc>;
+        static_assert(std::is_trivially_copyable_v<TFuncType>, "Task functions must be trivially copyable.");
+        static_assert(sizeof(TFuncType) <= TaskStorageSize, "Task function is too large, capture by reference.");
+        static_assert(alignof(TFuncType) <= alignof(std::max_align_t), "Task function alignment is not supported.");
+
+        Task task;
+        task.Group = &group;
+        task.Invoke = [](Task& t) { (*std::launder(reinterpret_cast<TFuncType*>(t.Storage)))(); };
+        new (task.Storage) TFuncType(std::forward<TFunc>(func));
+
+        group._pending.fetch_add(1, std::memory_order_relaxed);
+        Submit(task);
     }
 
-private:
-    void ProcessQueue()
+    /**
+     * Waits until every task of the group has completed, executing pending tasks of the group on the calling thread
+     * meanwhile. The optional report function is called periodically while waiting.
+     */
+    void Join(TaskGroup& group, const std::function<void()>& reportFn = nullptr);
+
+    /**
+     * Calls func(index) for every index in [begin, end), split into tasks of at most grain indices.
+     * Returns when all indices have been processed.
+     */
+    template<typename TFunc> void ParallelFor(size_t begin, size_t end, size_t grain, TFunc&& func)
     {
-        unique_lock lock(_mutex);
-        do
+        if (begin >= end)
         {
-            // Wait for work or cancelation.
-            _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
+            return;
+        }
 
-            if (!_pending.empty())
+        grain = std::max<size_t>(grain, 1);
+        if (_threads.empty() || end - begin <= grain)
+        {
+            for (size_t i = begin; i < end; i++)
             {
-                _processing++;
-
-                auto taskData = _pending.front();
-                _pending.pop_front();
-
-                lock.unlock();
-
-                taskData.WorkFn();
-
-                lock.lock();
-
-                _completed.push_back(taskData);
-
-                _processing--;
-                _condComplete.notify_one();
+                func(i);
             }
-        } while (!_shouldStop);
+            return;
+        }
+
+        auto* fn = &func;
+        TaskGroup group;
+        for (size_t rangeStart = begin; rangeStart < end; rangeStart += grain)
+        {
+            const size_t rangeEnd = std::min(end, rangeStart + grain);
+            AddTask(group, [fn, rangeStart, rangeEnd]() {
+                for (size_t i = rangeStart; i < rangeEnd; i++)
+                {
+                    (*fn)(i);
+                }
+            });
+        }
+        Join(group);
     }
+
+private:
+    void Submit(const Task& task);
+    bool TryGetTask(Task& task);
+    bool TryGetGroupTask(Task& task, const TaskGroup& group);
+    void Execute(Task& task);
+    void ProcessQueue(size_t queueIndex);
 };
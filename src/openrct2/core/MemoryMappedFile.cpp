@@ -0,0 +1,124 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "IStream.hpp"
+#include "MemoryMappedFile.h"
+#include "String.hpp"
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+{
+#ifdef _WIN32
+    auto pathW = String::ToWideChar(path);
+    auto hFile = CreateFileW(
+        pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        throw IOException("Unable to open '" + path + "'");
+    }
+    _file = hFile;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize))
+    {
+        Close();
+        throw IOException("Unable to get the size of '" + path + "'");
+    }
+    _length = static_cast<size_t>(fileSize.QuadPart);
+    if (_length == 0)
+    {
+        return;
+    }
+
+    _mapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping == nullptr)
+    {
+        Close();
+        throw IOException("Unable to map '" + path + "'");
+    }
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        Close();
+        throw IOException("Unable to map '" + path + "'");
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw IOException("Unable to open '" + path + "'");
+    }
+
+    struct stat fileStat
+    {
+    };
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        close(fd);
+        throw IOException("Unable to open '" + path + "'");
+    }
+    _length = static_cast<size_t>(fileStat.st_size);
+    if (_length == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    void* data = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        _length = 0;
+        throw IOException("Unable to map '" + path + "'");
+    }
+    _data = static_cast<const uint8_t*>(data);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
+
+void MemoryMappedFile::Close()
+{
+#ifdef _WIN32
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr)
+    {
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if (_file != nullptr)
+    {
+        CloseHandle(_file);
+        _file = nullptr;
+    }
+#else
+    if (_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(_data), _length);
+    }
+#endif
+    _data = nullptr;
+    _length = 0;
+}
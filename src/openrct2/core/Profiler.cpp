@@ -0,0 +1,272 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Profiler.h"
+
+#include "File.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace OpenRCT2::Profiling
+{
+    static constexpr size_t MaxTraceEvents = 1 << 16;
+
+    static constexpr const char* SectionNames[] = {
+        "Tick",
+        "Network",
+        "Map tiles",
+        "Peeps",
+        "Vehicles",
+        "Misc sprites",
+        "Rides",
+        "Park",
+        "Ride ratings",
+        "Game actions",
+        "Paint",
+        "Viewport paint",
+        "Draw dirty blocks",
+    };
+    static_assert(std::size(SectionNames) == static_cast<size_t>(ProfileSection::Count));
+
+    static constexpr const char* CounterNames[] = {
+        "Sprite cache hits",
+        "Sprite cache misses",
+        "Tile paint cache hits",
+        "Tile paint cache misses",
+    };
+    static_assert(std::size(CounterNames) == static_cast<size_t>(ProfileCounter::Count));
+
+    struct SectionData
+    {
+        std::mutex Mutex;
+        std::array<int64_t, WindowSize> Samples{};
+        size_t Head{};
+        size_t Count{};
+        std::array<uint32_t, HistogramBuckets> Histogram{};
+    };
+
+    struct TraceEvent
+    {
+        ProfileSection Section;
+        uint32_t ThreadId;
+        int64_t Start;
+        int64_t Duration;
+    };
+
+    static std::atomic_bool _enabled = { true };
+    static std::atomic_bool _overlayVisible = { false };
+    static std::atomic<uint32_t> _nextThreadId = { 0 };
+    static const Clock::time_point _epoch = Clock::now();
+
+    static std::array<SectionData, static_cast<size_t>(ProfileSection::Count)> _sections;
+    static std::array<std::atomic<uint64_t>, static_cast<size_t>(ProfileCounter::Count)> _counters{};
+
+    static std::mutex _traceMutex;
+    static std::vector<TraceEvent> _traceEvents;
+    static size_t _traceHead;
+
+    static size_t GetHistogramBucket(int64_t durationNs)
+    {
+        auto us = static_cast<uint64_t>(durationNs / 1000);
+        size_t bucket = 0;
+        while (us != 0 && bucket < HistogramBuckets - 1)
+        {
+            us >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    static uint32_t GetThreadId()
+    {
+        static thread_local uint32_t threadId = _nextThreadId.fetch_add(1);
+        return threadId;
+    }
+
+    bool IsEnabled()
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enabled)
+    {
+        _enabled = enabled;
+    }
+
+    bool IsOverlayVisible()
+    {
+        return _overlayVisible.load(std::memory_order_relaxed);
+    }
+
+    void SetOverlayVisible(bool visible)
+    {
+        _overlayVisible = visible;
+    }
+
+    const char* GetSectionName(ProfileSection section)
+    {
+        return SectionNames[static_cast<size_t>(section)];
+    }
+
+    void Record(ProfileSection section, Clock::time_point start, Clock::time_point end)
+    {
+        const int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        {
+            auto& data = _sections[static_cast<size_t>(section)];
+            std::lock_guard<std::mutex> lock(data.Mutex);
+
+            // Replace the oldest sample once the window is full.
+            if (data.Count == WindowSize)
+            {
+                data.Histogram[GetHistogramBucket(data.Samples[data.Head])]--;
+            }
+            else
+            {
+                data.Count++;
+            }
+            data.Samples[data.Head] = duration;
+            data.Head = (data.Head + 1) % WindowSize;
+            data.Histogram[GetHistogramBucket(duration)]++;
+        }
+
+        TraceEvent traceEvent{ section, GetThreadId(),
+                               std::chrono::duration_cast<std::chrono::nanoseconds>(start - _epoch).count(), duration };
+        std::lock_guard<std::mutex> lock(_traceMutex);
+        if (_traceEvents.size() < MaxTraceEvents)
+        {
+            _traceEvents.push_back(traceEvent);
+        }
+        else
+        {
+            _traceEvents[_traceHead] = traceEvent;
+            _traceHead = (_traceHead + 1) % MaxTraceEvents;
+        }
+    }
+
+    SectionStats GetStats(ProfileSection section)
+    {
+        SectionStats stats;
+        stats.Name = GetSectionName(section);
+
+        std::vector<int64_t> samples;
+        {
+            auto& data = _sections[static_cast<size_t>(section)];
+            std::lock_guard<std::mutex> lock(data.Mutex);
+            if (data.Count == 0)
+            {
+                return stats;
+            }
+            samples.assign(data.Samples.begin(), data.Samples.begin() + data.Count);
+            stats.Last = data.Samples[(data.Head + WindowSize - 1) % WindowSize] / 1000000.0;
+            stats.Histogram = data.Histogram;
+        }
+
+        int64_t total = 0;
+        for (auto sample : samples)
+        {
+            total += sample;
+        }
+        stats.Samples = static_cast<uint32_t>(samples.size());
+        stats.Mean = (total / static_cast<double>(samples.size())) / 1000000.0;
+        stats.Max = *std::max_element(samples.begin(), samples.end()) / 1000000.0;
+
+        auto getPercentile = [&samples](size_t percentile) {
+            auto it = samples.begin() + (samples.size() - 1) * percentile / 100;
+            std::nth_element(samples.begin(), it, samples.end());
+            return *it / 1000000.0;
+        };
+        stats.P50 = getPercentile(50);
+        stats.P95 = getPercentile(95);
+        return stats;
+    }
+
+    const char* GetCounterName(ProfileCounter counter)
+    {
+        return CounterNames[static_cast<size_t>(counter)];
+    }
+
+    void IncrementCounter(ProfileCounter counter, uint64_t amount)
+    {
+        if (IsEnabled())
+        {
+            _counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t GetCounter(ProfileCounter counter)
+    {
+        return _counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    void Reset()
+    {
+        for (auto& counter : _counters)
+        {
+            counter = 0;
+        }
+        for (auto& data : _sections)
+        {
+            std::lock_guard<std::mutex> lock(data.Mutex);
+            data.Head = 0;
+            data.Count = 0;
+            data.Histogram.fill(0);
+        }
+
+        std::lock_guard<std::mutex> lock(_traceMutex);
+        _traceEvents.clear();
+        _traceHead = 0;
+    }
+
+    std::string GetTraceJson()
+    {
+        std::vector<TraceEvent> events;
+        {
+            std::lock_guard<std::mutex> lock(_traceMutex);
+            // Oldest event first.
+            events.assign(_traceEvents.begin() + _traceHead, _traceEvents.end());
+            events.insert(events.end(), _traceEvents.begin(), _traceEvents.begin() + _traceHead);
+        }
+
+        std::string json = "{\"traceEvents\":[";
+        char buffer[256];
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            const auto& ev = events[i];
+            const char* category = ev.Section >= ProfileSection::Paint ? "render" : "game";
+            snprintf(
+                buffer, sizeof(buffer),
+                "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                i == 0 ? "" : ",", GetSectionName(ev.Section), category, ev.Start / 1000.0, ev.Duration / 1000.0,
+                ev.ThreadId);
+            json += buffer;
+        }
+        json += "],\"displayTimeUnit\":\"ms\"}";
+        return json;
+    }
+
+    bool ExportTrace(const std::string& path)
+    {
+        try
+        {
+            auto json = GetTraceJson();
+            File::WriteAllBytes(path, json.data(), json.size());
+            return true;
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+} // namespace OpenRCT2::Profiling
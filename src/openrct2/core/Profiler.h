@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace OpenRCT2::Profiling
+{
+    /**
+     * Code sections that are timed by the profiler. Every section keeps a rolling window of its most recent samples.
+     */
+    enum class ProfileSection : uint8_t
+    {
+        Tick,
+        Network,
+        MapTiles,
+        Peeps,
+        Vehicles,
+        MiscSprites,
+        Rides,
+        Park,
+        RideRatings,
+        GameActions,
+        Paint,
+        ViewportPaint,
+        DrawDirtyBlocks,
+        Count,
+    };
+
+    /**
+     * Events that are counted by the profiler, counters only go up until the profiler is reset.
+     */
+    enum class ProfileCounter : uint8_t
+    {
+        SpriteCacheHits,
+        SpriteCacheMisses,
+        TilePaintCacheHits,
+        TilePaintCacheMisses,
+        Count,
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t WindowSize = 512;
+    constexpr size_t HistogramBuckets = 24;
+
+    /**
+     * Statistics over the rolling window of a section, times are in milliseconds. Histogram bucket n counts the
+     * samples that took less than 2^n microseconds, but not less than 2^(n - 1).
+     */
+    struct SectionStats
+    {
+        const char* Name{};
+        uint32_t Samples{};
+        double Last{};
+        double Mean{};
+        double P50{};
+        double P95{};
+        double Max{};
+        std::array<uint32_t, HistogramBuckets> Histogram{};
+    };
+
+    bool IsEnabled();
+    void SetEnabled(bool enabled);
+    bool IsOverlayVisible();
+    void SetOverlayVisible(bool visible);
+
+    const char* GetSectionName(ProfileSection section);
+    void Record(ProfileSection section, Clock::time_point start, Clock::time_point end);
+    SectionStats GetStats(ProfileSection section);
+
+    const char* GetCounterName(ProfileCounter counter);
+    void IncrementCounter(ProfileCounter counter, uint64_t amount = 1);
+    uint64_t GetCounter(ProfileCounter counter);
+    void Reset();
+
+    /**
+     * Writes the most recent timings as Chrome trace event JSON, viewable in chrome://tracing or Perfetto.
+     */
+    std::string GetTraceJson();
+    bool ExportTrace(const std::string& path);
+
+    /**
+     * Times the enclosing scope, use PROFILE_SCOPE so that timers are removed when the profiler is compiled out.
+     */
+    class ScopedTimer
+    {
+    private:
+        ProfileSection _section;
+        bool _active;
+        Clock::time_point _start;
+
+    public:
+        explicit ScopedTimer(ProfileSection section)
+            : _section(section)
+            , _active(IsEnabled())
+        {
+            if (_active)
+            {
+                _start = Clock::now();
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if (_active)
+            {
+                Record(_section, _start, Clock::now());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+} // namespace OpenRCT2::Profiling
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef DISABLE_PROFILER
+#    define PROFILE_SCOPE(section)
+#else
+#    define PROFILE_SCOPE(section)                                                                                             \
+        OpenRCT2::Profiling::ScopedTimer PROFILE_CONCAT(_profileScope, __LINE__)(OpenRCT2::Profiling::ProfileSection::section)
+#endif
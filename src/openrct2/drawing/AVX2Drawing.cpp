@@ -42,6 +42,35 @@ void mask_avx2(
     }
 }
 
+void remap_span_avx2(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map)
+{
+    // Each colour is gathered as part of the aligned dword holding it, so that the gather never reads past the end
+    // of the map, and then shifted down into place.
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i offsetMask = _mm256_set1_epi32(3);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int32_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i remapped[4];
+        for (int32_t k = 0; k < 4; k++)
+        {
+            const __m256i colour = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i + k * 8)));
+            const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(colour, offsetMask), 3);
+            const __m256i base = _mm256_andnot_si256(offsetMask, colour);
+            const __m256i dwords = _mm256_i32gather_epi32(reinterpret_cast<const int*>(map), base, 1);
+            remapped[k] = _mm256_and_si256(_mm256_srlv_epi32(dwords, shift), byteMask);
+        }
+
+        // Packing works per 128-bit lane, so the dwords of the result have to be put back in order.
+        const __m256i words0 = _mm256_packus_epi32(remapped[0], remapped[1]);
+        const __m256i words1 = _mm256_packus_epi32(remapped[2], remapped[3]);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words0, words1), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+    }
+    remap_span_scalar(src + i, dst + i, length - i, map);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +84,9 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void remap_span_avx2(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
@@ -10,12 +10,99 @@
 #pragma warning(disable : 4127) // conditional expression is constant
 
 #include "Drawing.h"
+#include "SpriteCache.h"
 
+#include <algorithm>
 #include <cstring>
 
-template<int32_t image_type, int32_t zoom_level> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
+using namespace OpenRCT2::Drawing;
+
+template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
 {
-    // TODO
+    auto dpi = args.DPI;
+    auto source_bits_pointer = args.SourceImage.offset;
+    auto dest_bits_pointer = args.DestinationBits;
+    auto source_x_start = args.SrcX;
+    auto source_y_start = args.SrcY;
+    auto width = args.Width;
+    auto height = args.Height;
+    [[maybe_unused]] auto& paletteMap = args.PalMap;
+
+    // We draw the image at 2^zoom_level scale, every source pixel becomes a square of zoom_amount pixels.
+    int32_t zoom_amount = 1 << zoom_level;
+
+    // Width of one screen line in the dest buffer
+    int32_t line_width = (dpi->width << zoom_level) + dpi->pitch;
+
+    // For every line in the image
+    for (int32_t i = 0; i < height; i++)
+    {
+        int32_t y = source_y_start + i;
+
+        const uint16_t lineOffset = source_bits_pointer[y * 2] | (source_bits_pointer[y * 2 + 1] << 8);
+        const uint8_t* lineData = source_bits_pointer + lineOffset;
+        uint8_t* loop_dest_pointer = dest_bits_pointer + line_width * (i << zoom_level);
+
+        uint8_t isEndOfLine = 0;
+
+        // For every data chunk in the line
+        while (!isEndOfLine)
+        {
+            const uint8_t* copySrc = lineData;
+
+            uint8_t dataSize = *copySrc++;
+            uint8_t firstPixelX = *copySrc++;
+
+            isEndOfLine = dataSize & 0x80;
+            dataSize &= 0x7F;
+
+            lineData = copySrc + dataSize;
+
+            int32_t x_start = firstPixelX - source_x_start;
+            int32_t numPixels = dataSize;
+
+            if (x_start < 0)
+            {
+                copySrc -= x_start;
+                numPixels += x_start;
+                x_start = 0;
+            }
+            if (x_start + numPixels > width)
+                numPixels = width - x_start;
+            if (numPixels <= 0)
+                continue;
+
+            // Repeat the chunk on every dest line covered by this source line
+            uint8_t* copyDest = loop_dest_pointer + (x_start << zoom_level);
+            for (int32_t row = 0; row < zoom_amount; row++, copyDest += line_width)
+            {
+                uint8_t* rowDest = copyDest;
+                for (int32_t j = 0; j < numPixels; j++)
+                {
+                    uint8_t colour = copySrc[j];
+                    if constexpr ((TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) == 0)
+                    {
+                        colour = paletteMap[colour];
+                    }
+                    for (int32_t k = 0; k < zoom_amount; k++, rowDest++)
+                    {
+                        if constexpr ((TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) != 0)
+                        {
+                            *rowDest = paletteMap.Blend(colour, *rowDest);
+                        }
+                        else if constexpr ((TBlendOp & BLEND_DST) != 0)
+                        {
+                            *rowDest = paletteMap[*rowDest];
+                        }
+                        else
+                        {
+                            *rowDest = colour;
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
 
 template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLESpriteMinify(DrawSpriteArgs& args)
@@ -29,6 +116,9 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
     auto height = args.Height;
     [[maybe_unused]] auto& paletteMap = args.PalMap;
 
+    // Unzoomed spans are remapped by the vectorised kernel, which needs a map covering every colour.
+    [[maybe_unused]] const uint8_t* remapTable = zoom_level == 0 ? paletteMap.GetTable(256) : nullptr;
+
     // The distance between two samples in the source image.
     // We draw the image at 1 / (2^zoom_level) scale.
     int32_t zoom_amount = 1 << zoom_level;
@@ -108,13 +198,21 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
             // If the image type is not a basic one we require to mix the pixels
             if constexpr ((TBlendOp & BLEND_SRC) != 0) // palette controlled images
             {
-                for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
+                if constexpr ((TBlendOp & BLEND_DST) != 0)
                 {
-                    if ((TBlendOp & BLEND_DST) != 0)
+                    for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
                     {
                         *copyDest = paletteMap.Blend(*copySrc, *copyDest);
                     }
-                    else
+                }
+                else if (remapTable != nullptr)
+                {
+                    if (numPixels > 0)
+                        remap_span_fn(copySrc, copyDest, numPixels, remapTable);
+                }
+                else
+                {
+                    for (int j = 0; j < numPixels; j += zoom_amount, copySrc += zoom_amount, copyDest++)
                     {
                         *copyDest = paletteMap[*copySrc];
                     }
@@ -122,9 +220,17 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
             }
             else if constexpr ((TBlendOp & BLEND_DST) != 0) // single alpha blended color (used for glass)
             {
-                for (int j = 0; j < numPixels; j += zoom_amount, copyDest++)
+                if (remapTable != nullptr)
                 {
-                    *copyDest = paletteMap[*copyDest];
+                    if (numPixels > 0)
+                        remap_span_fn(copyDest, copyDest, numPixels, remapTable);
+                }
+                else
+                {
+                    for (int j = 0; j < numPixels; j += zoom_amount, copyDest++)
+                    {
+                        *copyDest = paletteMap[*copyDest];
+                    }
                 }
             }
             else // standard opaque image
@@ -145,9 +251,148 @@ template<DrawBlendOp TBlendOp, int32_t zoom_level> static void FASTCALL DrawRLES
     }
 }
 
+template<DrawBlendOp TBlendOp>
+static void DrawCachedSpriteRow(
+    const uint8_t* src, const uint8_t* mask, uint8_t* dst, int32_t numPixels, bool solid, const PaletteMap& paletteMap,
+    const uint8_t* remapTable)
+{
+    if constexpr ((TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) != 0)
+    {
+        for (int32_t x = 0; x < numPixels; x++)
+        {
+            if (mask[x] != 0)
+                dst[x] = paletteMap.Blend(src[x], dst[x]);
+        }
+    }
+    else if constexpr ((TBlendOp & BLEND_SRC) != 0 || (TBlendOp & BLEND_DST) != 0)
+    {
+        // Remapped images read the source pixel, glass the dest pixel
+        const uint8_t* remapSrc = (TBlendOp & BLEND_SRC) != 0 ? src : dst;
+        if (remapTable == nullptr)
+        {
+            for (int32_t x = 0; x < numPixels; x++)
+            {
+                if (mask[x] != 0)
+                    dst[x] = paletteMap[remapSrc[x]];
+            }
+        }
+        else if (solid)
+        {
+            remap_span_fn(remapSrc, dst, numPixels, remapTable);
+        }
+        else
+        {
+            for (int32_t x = 0; x < numPixels; x++)
+            {
+                uint8_t remapped = remapTable[remapSrc[x]];
+                dst[x] = (remapped & mask[x]) | (dst[x] & ~mask[x]);
+            }
+        }
+    }
+    else
+    {
+        if (solid)
+        {
+            std::memcpy(dst, src, numPixels);
+        }
+        else
+        {
+            for (int32_t x = 0; x < numPixels; x++)
+            {
+                dst[x] = (src[x] & mask[x]) | (dst[x] & ~mask[x]);
+            }
+        }
+    }
+}
+
+/**
+ * Draws an image from its decoded form in the sprite cache, sampling the same pixels as DrawRLESpriteMinify.
+ */
+template<DrawBlendOp TBlendOp, int32_t zoom_level>
+static void FASTCALL DrawCachedSprite(DrawSpriteArgs& args, const CachedSprite& sprite)
+{
+    auto dpi = args.DPI;
+    auto dest_bits_pointer = args.DestinationBits;
+    auto source_x_start = args.SrcX;
+    auto source_y_start = args.SrcY;
+    auto width = args.Width;
+    auto height = args.Height;
+    auto& paletteMap = args.PalMap;
+    const uint8_t* remapTable = paletteMap.GetTable(256);
+
+    int32_t zoom_amount = 1 << zoom_level;
+    int32_t line_width = (dpi->width >> zoom_level) + dpi->pitch;
+
+    if (source_y_start < 0)
+    {
+        source_y_start += zoom_amount;
+        height -= zoom_amount;
+        dest_bits_pointer += line_width;
+    }
+
+    for (int32_t i = 0; i < height; i += zoom_amount)
+    {
+        int32_t y = source_y_start + i;
+        if (y < 0 || y >= sprite.Height)
+            continue;
+
+        // Skip the uncovered ends of the row, at higher zoom levels only every zoom_amount pixel is drawn
+        const auto& row = sprite.Rows[y];
+        int32_t x_begin = std::max(row.Begin - source_x_start, 0);
+        int32_t x_end = std::min(row.End - source_x_start, width);
+        x_begin = (x_begin + zoom_amount - 1) & ~(zoom_amount - 1);
+        if (x_begin >= x_end)
+            continue;
+
+        const size_t rowOffset = static_cast<size_t>(y) * sprite.Stride + source_x_start;
+        const uint8_t* src = sprite.Pixels.data() + rowOffset;
+        const uint8_t* mask = sprite.Mask.data() + rowOffset;
+        uint8_t* dst = dest_bits_pointer + line_width * (i >> zoom_level);
+        if constexpr (zoom_level == 0)
+        {
+            DrawCachedSpriteRow<TBlendOp>(
+                src + x_begin, mask + x_begin, dst + x_begin, x_end - x_begin, row.Solid, paletteMap, remapTable);
+        }
+        else
+        {
+            for (int32_t x = x_begin; x < x_end; x += zoom_amount)
+            {
+                if (mask[x] != 0)
+                {
+                    DrawCachedSpriteRow<TBlendOp>(src + x, mask + x, dst + (x >> zoom_level), 1, true, paletteMap, nullptr);
+                }
+            }
+        }
+    }
+}
+
 template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs& args)
 {
     auto zoom_level = static_cast<int8_t>(args.DPI->zoom_level);
+    if (zoom_level >= 0 && zoom_level <= 3 && args.Image.HasValue())
+    {
+        auto sprite = SpriteCache::Get().GetOrAdd(args.Image.GetIndex(), args.SourceImage);
+        if (sprite != nullptr)
+        {
+            switch (zoom_level)
+            {
+                case 0:
+                    DrawCachedSprite<TBlendOp, 0>(args, *sprite);
+                    break;
+                case 1:
+                    DrawCachedSprite<TBlendOp, 1>(args, *sprite);
+                    break;
+                case 2:
+                    DrawCachedSprite<TBlendOp, 2>(args, *sprite);
+                    break;
+                case 3:
+                    DrawCachedSprite<TBlendOp, 3>(args, *sprite);
+                    break;
+            }
+            return;
+        }
+    }
+
     switch (zoom_level)
     {
         case -2:
@@ -12,12 +12,15 @@
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
+#include "../core/MemoryMappedFile.h"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../platform/platform.h"
 #include "../sprites.h"
 #include "../ui/UiContext.h"
 #include "../util/Util.h"
 #include "Drawing.h"
+#include "SpriteCache.h"
 
 #include <algorithm>
 #include <memory>
@@ -177,15 +180,45 @@ void mask_scalar(
     }
 }
 
+void remap_span_scalar(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map)
+{
+    for (int32_t i = 0; i < length; i++)
+    {
+        dst[i] = map[src[i]];
+    }
+}
+
 static rct_gx _g1 = {};
 static rct_gx _g2 = {};
 static rct_gx _csg = {};
+static std::unique_ptr<MemoryMappedFile> _g1File;
+static std::unique_ptr<MemoryMappedFile> _g2File;
+static std::unique_ptr<MemoryMappedFile> _csgFile;
 static bool _csgLoaded = false;
 
 static rct_g1_element _g1Temp = {};
 static std::vector<rct_g1_element> _imageListElements;
 bool gTinyFontAntiAliased = false;
 
+/**
+ * Points the elements of a graphics file at the element data in its mapping. The data itself is not touched, so it
+ * is only read from disk when an image is drawn.
+ */
+static void gfx_map_element_data(rct_gx& gx, const MemoryMappedFile& file, size_t dataOffset)
+{
+    if (dataOffset > file.GetLength() || file.GetLength() - dataOffset < gx.header.total_size)
+    {
+        throw std::runtime_error("Graphics data is truncated");
+    }
+
+    // The mapping is read-only, images are never written to in place
+    gx.data = const_cast<uint8_t*>(file.GetData() + dataOffset);
+    for (auto& element : gx.elements)
+    {
+        element.offset += reinterpret_cast<uintptr_t>(gx.data);
+    }
+}
+
 /**
  *
  *  rct2: 0x00678998
@@ -196,8 +229,9 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     try
     {
         auto path = Path::Combine(env.GetDirectoryPath(DIRBASE::RCT2, DIRID::DATA), "g1.dat");
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g1.header = fs.ReadValue<rct_g1_header>();
+        _g1File = std::make_unique<MemoryMappedFile>(path);
+        auto ms = MemoryStream(_g1File->GetData(), _g1File->GetLength());
+        _g1.header = ms.ReadValue<rct_g1_header>();
 
         log_verbose("g1.dat, number of entries: %u", _g1.header.num_entries);
 
@@ -209,23 +243,18 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
         // Read element headers
         bool is_rctc = _g1.header.num_entries == SPR_RCTC_G1_END;
         _g1.elements.resize(_g1.header.num_entries);
-        read_and_convert_gxdat(&fs, _g1.header.num_entries, is_rctc, _g1.elements.data());
+        read_and_convert_gxdat(&ms, _g1.header.num_entries, is_rctc, _g1.elements.data());
         gTinyFontAntiAliased = is_rctc;
 
-        // Read element data
-        _g1.data = fs.ReadArray<uint8_t>(_g1.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g1.header.num_entries; i++)
-        {
-            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(_g1.data);
-        }
+        gfx_map_element_data(_g1, *_g1File, ms.GetPosition());
         return true;
     }
     catch (const std::exception&)
     {
         _g1.elements.clear();
         _g1.elements.shrink_to_fit();
+        _g1.data = nullptr;
+        _g1File = nullptr;
 
         log_fatal("Unable to load g1 graphics");
         if (!gOpenRCT2Headless)
@@ -239,23 +268,29 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
-    SafeFree(_g1.data);
+    OpenRCT2::Drawing::SpriteCache::Get().Clear();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
+    _g1.data = nullptr;
+    _g1File = nullptr;
 }
 
 void gfx_unload_g2()
 {
-    SafeFree(_g2.data);
+    OpenRCT2::Drawing::SpriteCache::Get().Clear();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
+    _g2.data = nullptr;
+    _g2File = nullptr;
 }
 
 void gfx_unload_csg()
 {
-    SafeFree(_csg.data);
+    OpenRCT2::Drawing::SpriteCache::Get().Clear();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
+    _csg.data = nullptr;
+    _csgFile = nullptr;
 }
 
 bool gfx_load_g2()
@@ -268,27 +303,23 @@ bool gfx_load_g2()
     safe_strcat_path(path, "g2.dat", MAX_PATH);
     try
     {
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g2.header = fs.ReadValue<rct_g1_header>();
+        _g2File = std::make_unique<MemoryMappedFile>(path);
+        auto ms = MemoryStream(_g2File->GetData(), _g2File->GetLength());
+        _g2.header = ms.ReadValue<rct_g1_header>();
 
         // Read element headers
         _g2.elements.resize(_g2.header.num_entries);
-        read_and_convert_gxdat(&fs, _g2.header.num_entries, false, _g2.elements.data());
-
-        // Read element data
-        _g2.data = fs.ReadArray<uint8_t>(_g2.header.total_size);
+        read_and_convert_gxdat(&ms, _g2.header.num_entries, false, _g2.elements.data());
 
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g2.header.num_entries; i++)
-        {
-            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(_g2.data);
-        }
+        gfx_map_element_data(_g2, *_g2File, ms.GetPosition());
         return true;
     }
     catch (const std::exception&)
     {
         _g2.elements.clear();
         _g2.elements.shrink_to_fit();
+        _g2.data = nullptr;
+        _g2File = nullptr;
 
         log_fatal("Unable to load g2 graphics");
         if (!gOpenRCT2Headless)
@@ -315,9 +346,9 @@ bool gfx_load_csg()
     try
     {
         auto fileHeader = FileStream(pathHeaderPath, FILE_MODE_OPEN);
-        auto fileData = FileStream(pathDataPath, FILE_MODE_OPEN);
+        _csgFile = std::make_unique<MemoryMappedFile>(pathDataPath);
         size_t fileHeaderSize = fileHeader.GetLength();
-        size_t fileDataSize = fileData.GetLength();
+        size_t fileDataSize = _csgFile->GetLength();
 
         _csg.header.num_entries = static_cast<uint32_t>(fileHeaderSize / sizeof(rct_g1_element_32bit));
         _csg.header.total_size = static_cast<uint32_t>(fileDataSize);
@@ -325,6 +356,7 @@ bool gfx_load_csg()
         if (!CsgIsUsable(_csg))
         {
             log_warning("Cannot load CSG1.DAT, it has too few entries. Only CSG1.DAT from Loopy Landscapes will work.");
+            _csgFile = nullptr;
             return false;
         }
 
@@ -332,13 +364,9 @@ bool gfx_load_csg()
         _csg.elements.resize(_csg.header.num_entries);
         read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.elements.data());
 
-        // Read element data
-        _csg.data = fileData.ReadArray<uint8_t>(_csg.header.total_size);
-
-        // Fix entry data offsets
+        gfx_map_element_data(_csg, *_csgFile, 0);
         for (uint32_t i = 0; i < _csg.header.num_entries; i++)
         {
-            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(_csg.data);
             // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
             if (_csg.elements[i].flags & G1_FLAG_HAS_ZOOM_SPRITE)
             {
@@ -352,6 +380,8 @@ bool gfx_load_csg()
     {
         _csg.elements.clear();
         _csg.elements.shrink_to_fit();
+        _csg.data = nullptr;
+        _csgFile = nullptr;
 
         log_error("Unable to load csg graphics");
         return false;
@@ -371,10 +401,16 @@ static std::optional<PaletteMap> FASTCALL gfx_draw_sprite_get_palette(ImageId im
     }
     else
     {
-        auto paletteMap = PaletteMap(gPeepPalette);
-        if (imageId.HasTertiary())
+        // Remap into a per thread buffer rather than the shared palettes, sprites may be drawn concurrently.
+        thread_local uint8_t remapPalette[256];
+        auto paletteMap = PaletteMap(remapPalette);
+        if (!imageId.HasTertiary())
+        {
+            std::copy(std::begin(gPeepPalette), std::end(gPeepPalette), std::begin(remapPalette));
+        }
+        else
         {
-            paletteMap = PaletteMap(gOtherPalette);
+            std::copy(std::begin(gOtherPalette), std::end(gOtherPalette), std::begin(remapPalette));
             auto tertiaryPaletteMap = GetPaletteMapForColour(imageId.GetTertiary());
             if (tertiaryPaletteMap)
             {
@@ -24,16 +24,14 @@
 
 const PaletteMap& PaletteMap::GetDefault()
 {
-    static bool initialised = false;
     static uint8_t data[256];
-    static PaletteMap defaultMap(data);
-    if (!initialised)
-    {
+    static PaletteMap defaultMap = []() {
         for (size_t i = 0; i < sizeof(data); i++)
         {
             data[i] = static_cast<uint8_t>(i);
         }
-    }
+        return PaletteMap(data);
+    }();
     return defaultMap;
 }
 
@@ -578,6 +576,22 @@ void mask_init()
     }
 }
 
+void (*remap_span_fn)(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map) = nullptr;
+
+void remap_span_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 remap function");
+        remap_span_fn = remap_span_avx2;
+    }
+    else
+    {
+        log_verbose("registering scalar remap function");
+        remap_span_fn = remap_span_scalar;
+    }
+}
+
 void gfx_draw_pixel(rct_drawpixelinfo* dpi, const ScreenCoordsXY& coords, int32_t colour)
 {
     gfx_fill_rect(dpi, coords.x, coords.y, coords.x, coords.y, colour);
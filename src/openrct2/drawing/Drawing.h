@@ -514,6 +514,14 @@ public:
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
+
+    /**
+     * Gets the map data for lookups without bounds checks, or nullptr if the map is shorter than the given length.
+     */
+    const uint8_t* GetTable(size_t length) const
+    {
+        return length <= _dataLength ? _data : nullptr;
+    }
 };
 
 struct DrawSpriteArgs
@@ -716,6 +724,13 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+// Remaps a span of pixels through a 256 entry palette map, src and dst may be the same span.
+void remap_span_scalar(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map);
+void remap_span_avx2(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map);
+void remap_span_init();
+
+extern void (*remap_span_fn)(const uint8_t* src, uint8_t* dst, int32_t length, const uint8_t* RESTRICT map);
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
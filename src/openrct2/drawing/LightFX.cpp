@@ -67,6 +67,8 @@ static lightlist_entry* _LightListFront;
 static uint32_t LightListCurrentCountBack;
 static uint32_t LightListCurrentCountFront;
 
+static thread_local std::vector<lightfx_deferred_light>* _deferredLights = nullptr;
+
 static int16_t _current_view_x_front = 0;
 static int16_t _current_view_y_front = 0;
 static uint8_t _current_view_rotation_front = 0;
@@ -619,8 +621,32 @@ const GamePalette& lightfx_get_palette()
     return gPalette_light;
 }
 
+void lightfx_set_deferred_lights(std::vector<lightfx_deferred_light>* lights)
+{
+    _deferredLights = lights;
+}
+
+std::vector<lightfx_deferred_light>* lightfx_get_deferred_lights()
+{
+    return _deferredLights;
+}
+
+void lightfx_commit_deferred_lights(const std::vector<lightfx_deferred_light>& lights)
+{
+    for (const auto& light : lights)
+    {
+        lightfx_add_3d_light(light.lightID, light.lightIDqualifier, light.x, light.y, light.z, light.lightType);
+    }
+}
+
 void lightfx_add_3d_light(uint32_t lightID, uint16_t lightIDqualifier, int16_t x, int16_t y, uint16_t z, uint8_t lightType)
 {
+    if (_deferredLights != nullptr)
+    {
+        _deferredLights->push_back({ lightID, lightIDqualifier, x, y, z, lightType });
+        return;
+    }
+
     if (LightListCurrentCountBack == 15999)
     {
         return;
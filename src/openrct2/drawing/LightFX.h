@@ -14,6 +14,8 @@
 
 #    include "../common.h"
 
+#    include <vector>
+
 struct CoordsXY;
 struct Vehicle;
 struct rct_drawpixelinfo;
@@ -43,6 +45,16 @@ enum LIGHTFX_LIGHT_QUALIFIER
     LIGHTFX_LIGHT_QUALIFIER_MAP = 0x2
 };
 
+struct lightfx_deferred_light
+{
+    uint32_t lightID;
+    uint16_t lightIDqualifier;
+    int16_t x;
+    int16_t y;
+    uint16_t z;
+    uint8_t lightType;
+};
+
 void lightfx_set_available(bool available);
 bool lightfx_is_available();
 bool lightfx_for_vehicles_is_available();
@@ -59,6 +71,14 @@ void lightfx_update_viewport_settings();
 void* lightfx_get_front_buffer();
 const GamePalette& lightfx_get_palette();
 
+/**
+ * Redirects lights added on the calling thread into the given list instead of the shared light list.
+ * Pass nullptr to stop deferring. Deferred lists are merged with lightfx_commit_deferred_lights.
+ */
+void lightfx_set_deferred_lights(std::vector<lightfx_deferred_light>* lights);
+std::vector<lightfx_deferred_light>* lightfx_get_deferred_lights();
+void lightfx_commit_deferred_lights(const std::vector<lightfx_deferred_light>& lights);
+
 void lightfx_add_3d_light(uint32_t lightID, uint16_t lightIDqualifier, int16_t x, int16_t y, uint16_t z, uint8_t lightType);
 
 void lightfx_add_3d_light_magic_from_drawing_tile(
@@ -18,6 +18,7 @@
 #include "../ui/UiContext.h"
 #include "IDrawingContext.h"
 #include "IDrawingEngine.h"
+#include "SpriteCache.h"
 
 #include <cmath>
 
@@ -146,6 +147,10 @@ void drawing_engine_invalidate_image(uint32_t image)
     {
         drawingEngine->InvalidateImage(image);
     }
+    else
+    {
+        SpriteCache::Get().Invalidate(image);
+    }
 }
 
 void drawing_engine_set_vsync(bool vsync)
@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SpriteCache.h"
+
+#include "../core/Profiler.h"
+#include "../sprites.h"
+#include "Drawing.h"
+
+#include <algorithm>
+
+using namespace OpenRCT2::Drawing;
+
+// Images larger than this are rare and drawn rarely, e.g. title screen and intro images
+static constexpr int32_t MaxCachedSpriteArea = 256 * 256;
+
+size_t CachedSprite::GetMemoryUsage() const
+{
+    return sizeof(CachedSprite) + Pixels.capacity() + Mask.capacity() + Rows.capacity() * sizeof(Row);
+}
+
+SpriteCache& SpriteCache::Get()
+{
+    static SpriteCache spriteCache;
+    return spriteCache;
+}
+
+SpriteCache::SpriteCache(size_t memoryBudget)
+    : _cache(memoryBudget)
+{
+}
+
+bool SpriteCache::IsCacheable(uint32_t imageIndex, const rct_g1_element& g1)
+{
+    if (!(g1.flags & G1_FLAG_RLE_COMPRESSION) || g1.offset == nullptr || g1.width <= 0 || g1.height <= 0)
+        return false;
+    if (g1.width * g1.height > MaxCachedSpriteArea)
+        return false;
+
+    // The temporary and scrolling text images are replaced all the time
+    if (imageIndex == SPR_TEMP || (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END))
+        return false;
+    return true;
+}
+
+std::shared_ptr<CachedSprite> SpriteCache::Decode(const rct_g1_element& g1)
+{
+    auto sprite = std::make_shared<CachedSprite>();
+    sprite->Source = g1.offset;
+    sprite->Width = g1.width;
+    sprite->Height = g1.height;
+    sprite->Stride = (g1.width + 15) & ~15;
+    sprite->Pixels.resize(static_cast<size_t>(sprite->Stride) * g1.height);
+    sprite->Mask.resize(sprite->Pixels.size());
+    sprite->Rows.resize(g1.height);
+
+    const uint8_t* source = g1.offset;
+    for (int32_t y = 0; y < g1.height; y++)
+    {
+        uint8_t* pixels = sprite->Pixels.data() + y * sprite->Stride;
+        uint8_t* mask = sprite->Mask.data() + y * sprite->Stride;
+        auto& row = sprite->Rows[y];
+        row.Begin = g1.width;
+        row.End = 0;
+        int32_t numCovered = 0;
+
+        const uint16_t lineOffset = source[y * 2] | (source[y * 2 + 1] << 8);
+        const uint8_t* lineData = source + lineOffset;
+        uint8_t isEndOfLine = 0;
+        while (!isEndOfLine)
+        {
+            uint8_t dataSize = *lineData++;
+            int32_t x = *lineData++;
+            isEndOfLine = dataSize & 0x80;
+            dataSize &= 0x7F;
+
+            int32_t numPixels = std::min<int32_t>(dataSize, g1.width - x);
+            if (numPixels > 0)
+            {
+                std::copy_n(lineData, numPixels, pixels + x);
+                std::fill_n(mask + x, numPixels, 0xFF);
+                row.Begin = std::min<int16_t>(row.Begin, x);
+                row.End = std::max<int16_t>(row.End, x + numPixels);
+                numCovered += numPixels;
+            }
+            lineData += dataSize;
+        }
+
+        if (row.End <= row.Begin)
+        {
+            row.Begin = 0;
+            row.End = 0;
+        }
+        row.Solid = numCovered == row.End - row.Begin;
+    }
+    return sprite;
+}
+
+bool SpriteCache::Matches(const CachedSprite& sprite, const rct_g1_element& g1)
+{
+    return sprite.Source == g1.offset && sprite.Width == g1.width && sprite.Height == g1.height;
+}
+
+std::shared_ptr<const CachedSprite> SpriteCache::GetOrAdd(uint32_t imageIndex, const rct_g1_element& g1)
+{
+    if (!IsCacheable(imageIndex, g1))
+        return nullptr;
+
+    auto sprite = _cache.Find(imageIndex);
+    if (sprite != nullptr && Matches(*sprite, g1))
+    {
+        _cache.CountHit();
+        Profiling::IncrementCounter(Profiling::ProfileCounter::SpriteCacheHits);
+        return sprite;
+    }
+
+    // A sprite that does not match belongs to an image that has been replaced without being invalidated
+    Profiling::IncrementCounter(Profiling::ProfileCounter::SpriteCacheMisses);
+    if (!_cache.CountMiss(imageIndex, sprite))
+        return nullptr;
+
+    // Decoding happens outside of the lock, if another thread adds the same image first one of the copies is dropped.
+    std::shared_ptr<const CachedSprite> decoded = Decode(g1);
+    _cache.Insert(imageIndex, decoded);
+    return decoded;
+}
+
+void SpriteCache::Invalidate(uint32_t imageIndex)
+{
+    _cache.Remove(imageIndex);
+}
+
+void SpriteCache::Clear()
+{
+    _cache.Clear();
+}
+
+void SpriteCache::SetMemoryBudget(size_t memoryBudget)
+{
+    _cache.SetMemoryBudget(memoryBudget);
+}
+
+OpenRCT2::CacheStats SpriteCache::GetStats() const
+{
+    return _cache.GetStats();
+}
@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../core/BudgetedLruCache.hpp"
+
+#include <memory>
+#include <vector>
+
+struct rct_g1_element;
+
+namespace OpenRCT2::Drawing
+{
+    /**
+     * An RLE image expanded into rows of pixels, with a mask that is 0xFF for every pixel the image covers. Rows are
+     * padded to a multiple of 16 bytes.
+     */
+    struct CachedSprite
+    {
+        struct Row
+        {
+            // Range of the row that has covered pixels, Begin == End for an empty row
+            int16_t Begin;
+            int16_t End;
+            // Whether every pixel between Begin and End is covered, so the row can be copied as is
+            bool Solid;
+        };
+
+        const uint8_t* Source{};
+        int16_t Width{};
+        int16_t Height{};
+        int32_t Stride{};
+        std::vector<uint8_t> Pixels;
+        std::vector<uint8_t> Mask;
+        std::vector<Row> Rows;
+
+        size_t GetMemoryUsage() const;
+    };
+
+    /**
+     * Cache of decoded RLE images, so that sprites which are drawn over and over again such as terrain, paths and
+     * scenery do not have to be decoded every time. The full size image serves every zoom level.
+     */
+    class SpriteCache final
+    {
+    private:
+        BudgetedLruCache<uint32_t, CachedSprite> _cache;
+
+    public:
+        static constexpr size_t DefaultMemoryBudget = 32 * 1024 * 1024;
+
+        static SpriteCache& Get();
+
+        explicit SpriteCache(size_t memoryBudget = DefaultMemoryBudget);
+
+        /**
+         * Gets the decoded form of an RLE image, or nullptr if the image is not worth caching (yet).
+         */
+        std::shared_ptr<const CachedSprite> GetOrAdd(uint32_t imageIndex, const rct_g1_element& g1);
+
+        void Invalidate(uint32_t imageIndex);
+        void Clear();
+        void SetMemoryBudget(size_t memoryBudget);
+        CacheStats GetStats() const;
+
+        static std::shared_ptr<CachedSprite> Decode(const rct_g1_element& g1);
+
+    private:
+        static bool IsCacheable(uint32_t imageIndex, const rct_g1_element& g1);
+        static bool Matches(const CachedSprite& sprite, const rct_g1_element& g1);
+    };
+} // namespace OpenRCT2::Drawing
@@ -13,6 +13,7 @@
 #include "../Game.h"
 #include "../Intro.h"
 #include "../config/Config.h"
+#include "../core/Profiler.h"
 #include "../interface/Screenshot.h"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -22,6 +23,7 @@
 #include "IDrawingEngine.h"
 #include "LightFX.h"
 #include "Rain.h"
+#include "SpriteCache.h"
 
 #include <algorithm>
 #include <cstring>
@@ -285,12 +287,12 @@ rct_drawpixelinfo* X8DrawingEngine::GetDrawingPixelInfo()
 
 DRAWING_ENGINE_FLAGS X8DrawingEngine::GetFlags()
 {
-    return DEF_DIRTY_OPTIMISATIONS;
+    return static_cast<DRAWING_ENGINE_FLAGS>(DEF_DIRTY_OPTIMISATIONS | DEF_PARALLEL_DRAWING);
 }
 
-void X8DrawingEngine::InvalidateImage([[maybe_unused]] uint32_t image)
+void X8DrawingEngine::InvalidateImage(uint32_t image)
 {
-    // Not applicable for this engine
+    SpriteCache::Get().Invalidate(image);
 }
 
 rct_drawpixelinfo* X8DrawingEngine::GetDPI()
@@ -377,6 +379,8 @@ void X8DrawingEngine::ConfigureDirtyGrid()
 
 void X8DrawingEngine::DrawAllDirtyBlocks()
 {
+    PROFILE_SCOPE(DrawDirtyBlocks);
+
     uint32_t dirtyBlockColumns = _dirtyGrid.BlockColumns;
     uint32_t dirtyBlockRows = _dirtyGrid.BlockRows;
     uint8_t* dirtyBlocks = _dirtyGrid.Blocks;
@@ -457,6 +461,8 @@ void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns,
 #    pragma GCC diagnostic pop
 #endif
 
+thread_local rct_drawpixelinfo* X8DrawingContext::_dpi = nullptr;
+
 X8DrawingContext::X8DrawingContext(X8DrawingEngine* engine)
 {
     _engine = engine;
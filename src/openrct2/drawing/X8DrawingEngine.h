@@ -133,7 +133,8 @@ namespace OpenRCT2
         {
         private:
             X8DrawingEngine* _engine = nullptr;
-            rct_drawpixelinfo* _dpi = nullptr;
+            // Per thread so viewport columns can be drawn concurrently.
+            static thread_local rct_drawpixelinfo* _dpi;
 
         public:
             explicit X8DrawingContext(X8DrawingEngine* engine);
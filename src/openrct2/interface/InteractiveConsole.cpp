@@ -24,9 +24,11 @@
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../core/Path.hpp"
+#include "../core/Profiler.h"
 #include "../core/String.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/Font.h"
+#include "../drawing/SpriteCache.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
 #include "../interface/Window_internal.h"
@@ -39,6 +41,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../paint/TilePaintCache.h"
 #include "../peep/Staff.h"
 #include "../platform/platform.h"
 #include "../ride/Ride.h"
@@ -1247,7 +1250,7 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
         }
     }
 
-    console.WriteFormatLine("Sprites: %d/%d", spriteCount, MAX_SPRITES);
+    console.WriteFormatLine("Sprites: %d/%d (limit %d)", spriteCount, sprite_get_capacity(), sprite_get_limit());
     console.WriteFormatLine("Map Elements: %d/%d", tileElementCount, MAX_TILE_ELEMENTS);
     console.WriteFormatLine("Banners: %d/%zu", bannerCount, MAX_BANNERS);
     console.WriteFormatLine("Rides: %d/%d", rideCount, MAX_RIDES);
@@ -1496,10 +1499,15 @@ static int32_t cc_replay_start(InteractiveConsole& console, const arguments_t& a
                              "  Date Recorded: %s\n"
                              "  Ticks: %u\n"
                              "  Commands: %u\n"
-                             "  Checksums: %u";
+                             "  Checksums: %u\n"
+                             "  Keyframes: %u";
 
-        console.WriteFormatLine(logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums);
-        log_info(logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums);
+        console.WriteFormatLine(
+            logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums,
+            info.NumKeyframes);
+        log_info(
+            logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums,
+            info.NumKeyframes);
 
         return 1;
     }
@@ -1525,6 +1533,119 @@ static int32_t cc_replay_stop(InteractiveConsole& console, const arguments_t& ar
     return 0;
 }
 
+static int32_t cc_replay_seek(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (network_get_mode() != NETWORK_MODE_NONE)
+    {
+        console.WriteFormatLine("This command is currently not supported in multiplayer mode.");
+        return 0;
+    }
+
+    if (argv.size() < 1)
+    {
+        console.WriteFormatLine("Parameters required <tick>");
+        return 0;
+    }
+
+    uint32_t tick = static_cast<uint32_t>(std::max(0, atoi(argv[0].c_str())));
+
+    auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
+    if (replayManager->SeekPlayback(tick))
+    {
+        console.WriteFormatLine("Moved replay to tick %u", tick);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int32_t cc_profiler(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+#ifdef DISABLE_PROFILER
+    console.WriteFormatLine("The profiler is not available in this build.");
+    return 1;
+#else
+    using namespace OpenRCT2::Profiling;
+
+    const auto subCommand = argv.empty() ? std::string("stats") : argv[0];
+    if (subCommand == "stats")
+    {
+        console.WriteFormatLine("Last %u samples, times in ms:", static_cast<uint32_t>(WindowSize));
+        for (size_t i = 0; i < static_cast<size_t>(ProfileSection::Count); i++)
+        {
+            auto stats = GetStats(static_cast<ProfileSection>(i));
+            console.WriteFormatLine(
+                "%2d %-18s last %7.3f  avg %7.3f  p50 %7.3f  p95 %7.3f  max %7.3f", static_cast<int32_t>(i), stats.Name,
+                stats.Last, stats.Mean, stats.P50, stats.P95, stats.Max);
+        }
+        for (size_t i = 0; i < static_cast<size_t>(ProfileCounter::Count); i++)
+        {
+            auto counter = static_cast<ProfileCounter>(i);
+            console.WriteFormatLine(
+                "   %-18s %llu", GetCounterName(counter), static_cast<unsigned long long>(GetCounter(counter)));
+        }
+
+        auto spriteCacheStats = OpenRCT2::Drawing::SpriteCache::Get().GetStats();
+        console.WriteFormatLine(
+            "   Sprite cache: %zu images, %.1f of %.1f MiB, %llu evictions", spriteCacheStats.Entries,
+            spriteCacheStats.MemoryUsage / (1024.0 * 1024.0), spriteCacheStats.MemoryBudget / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(spriteCacheStats.Evictions));
+
+        auto tilePaintCacheStats = OpenRCT2::Paint::TilePaintCache::Get().GetStats();
+        console.WriteFormatLine(
+            "   Tile paint cache: %zu tiles, %.1f of %.1f MiB, %llu evictions", tilePaintCacheStats.Entries,
+            tilePaintCacheStats.MemoryUsage / (1024.0 * 1024.0), tilePaintCacheStats.MemoryBudget / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(tilePaintCacheStats.Evictions));
+    }
+    else if (subCommand == "histogram")
+    {
+        int32_t section = argv.size() > 1 ? atoi(argv[1].c_str()) : 0;
+        if (section < 0 || section >= static_cast<int32_t>(ProfileSection::Count))
+        {
+            console.WriteFormatLine("Invalid section, see profiler stats for the section numbers.");
+            return 1;
+        }
+
+        auto stats = GetStats(static_cast<ProfileSection>(section));
+        console.WriteFormatLine("%s, last %u samples:", stats.Name, stats.Samples);
+        for (size_t i = 0; i < HistogramBuckets; i++)
+        {
+            if (stats.Histogram[i] != 0)
+            {
+                console.WriteFormatLine("  < %8u us: %u", 1U << i, stats.Histogram[i]);
+            }
+        }
+    }
+    else if (subCommand == "enable" || subCommand == "disable")
+    {
+        SetEnabled(subCommand == "enable");
+    }
+    else if (subCommand == "overlay")
+    {
+        SetOverlayVisible(!IsOverlayVisible());
+    }
+    else if (subCommand == "reset")
+    {
+        Reset();
+    }
+    else if (subCommand == "trace" && argv.size() > 1)
+    {
+        if (!ExportTrace(argv[1]))
+        {
+            console.WriteFormatLine("Unable to write trace to %s", argv[1].c_str());
+            return 1;
+        }
+        console.WriteFormatLine("Trace written to %s", argv[1].c_str());
+    }
+    else
+    {
+        console.WriteFormatLine("Unknown subcommand, see help profiler.");
+        return 1;
+    }
+    return 0;
+#endif
+}
+
 static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_t& argv)
 {
     if (network_get_mode() != NETWORK_MODE_NONE)
@@ -1570,7 +1691,7 @@ static int32_t cc_mp_desync(InteractiveConsole& console, const arguments_t& argv
 
     std::vector<Peep*> peeps;
 
-    for (int i = 0; i < MAX_SPRITES; i++)
+    for (int i = 0; i < sprite_get_capacity(); i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1760,6 +1881,7 @@ static constexpr const console_command console_command_table[] = {
     { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
+    { "profiler", cc_profiler, "Shows timings of the game tick and rendering, or exports them as a Chrome trace.", "profiler [stats|histogram <section>|enable|disable|overlay|reset|trace <file>]" },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
     { "remove_unused_objects", cc_remove_unused_objects, "Removes all the unused objects from the object selection.", "remove_unused_objects" },
@@ -1777,6 +1899,7 @@ static constexpr const console_command console_command_table[] = {
     { "replay_stoprecord", cc_replay_stoprecord, "Stops recording a new replay.", "replay_stoprecord"},
     { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name>"},
     { "replay_stop", cc_replay_stop, "Stops the replay", "replay_stop"},
+    { "replay_seek", cc_replay_seek, "Moves the replay to a tick, counted from its start", "replay_seek <tick>"},
     { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps", "replay_normalise <input file> <output file>"},
     { "mp_desync", cc_mp_desync, "Forces a multiplayer desync", "cc_mp_desync [desync_type, 0 = Random t-shirt color on random peep, 1 = Remove random peep ]"},
 
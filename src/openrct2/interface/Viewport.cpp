@@ -16,7 +16,10 @@
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../core/JobPool.hpp"
+#include "../core/Profiler.h"
 #include "../drawing/Drawing.h"
+#include "../drawing/IDrawingEngine.h"
+#include "../drawing/LightFX.h"
 #include "../paint/Paint.h"
 #include "../peep/Staff.h"
 #include "../ride/Ride.h"
@@ -43,8 +46,6 @@ uint8_t gShowConstuctionRightsRefCount;
 rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
-
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
 uint8_t gSavedViewRotation;
@@ -775,7 +776,7 @@ void viewport_update_smart_vehicle_follow(rct_window* window)
  */
 void viewport_render(
     rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom,
-    std::vector<paint_session>* sessions)
+    std::vector<RecordedPaintSession>* sessions)
 {
     if (right <= viewport->pos.x)
         return;
@@ -816,30 +817,55 @@ void viewport_render(
 #endif
 }
 
-static void record_session(const paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+static void record_session(
+    const paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
-    // Perform a deep copy of the paint session, use relative offsets.
+    // Perform a deep copy of the paint session, flatten the paint entry chunks and use indices instead of pointers.
     // This is done to extract the session for benchmark.
     // Place the copied session at provided record_index, so the caller can decide which columns/paint sessions to copy; there
     // is no column information embedded in the session itself.
-    (*recorded_sessions)[record_index] = (*session);
-    paint_session* session_copy = &recorded_sessions->at(record_index);
-
-    // Mind the offset needs to be calculated against the original `session`, not `session_copy`
-    for (auto& ps : session_copy->PaintStructs)
+    auto& recorded = (*recorded_sessions)[record_index];
+    recorded.Session = *session;
+    recorded.Session.PaintEntryChunks = nullptr;
+    recorded.Session.CurrentPaintEntryChunk = nullptr;
+    recorded.Session.NumPaintEntryChunks = 0;
+    recorded.Session.NextFreePaintStruct = nullptr;
+    recorded.Session.EndOfPaintStructArray = nullptr;
+
+    const size_t numEntries = paint_session_get_entry_count(session);
+    recorded.Entries.clear();
+    recorded.Entries.reserve(numEntries);
+    for (auto chunk = session->PaintEntryChunks; chunk != nullptr && recorded.Entries.size() < numEntries; chunk = chunk->Next)
+    {
+        size_t count = std::min(numEntries - recorded.Entries.size(), PAINT_ENTRY_CHUNK_SIZE);
+        recorded.Entries.insert(recorded.Entries.end(), chunk->Entries, chunk->Entries + count);
+    }
+
+    // Mind the offset needs to be calculated against the chunks of the original `session`
+    auto toIndex = [session, numEntries](const paint_struct* ps) {
+        size_t baseIndex = 0;
+        for (auto chunk = session->PaintEntryChunks; ps != nullptr && chunk != nullptr; chunk = chunk->Next)
+        {
+            auto entry = reinterpret_cast<const paint_entry*>(ps);
+            if (entry >= chunk->Entries && entry < chunk->Entries + PAINT_ENTRY_CHUNK_SIZE)
+            {
+                return reinterpret_cast<paint_struct*>(baseIndex + (entry - chunk->Entries));
+            }
+            baseIndex += PAINT_ENTRY_CHUNK_SIZE;
+        }
+        return reinterpret_cast<paint_struct*>(numEntries);
+    };
+    for (auto& ps : recorded.Entries)
     {
-        ps.basic.next_quadrant_ps = reinterpret_cast<paint_struct*>(
-            ps.basic.next_quadrant_ps ? int(ps.basic.next_quadrant_ps - &session->PaintStructs[0].basic)
-                                      : std::size(session->PaintStructs));
+        ps.basic.next_quadrant_ps = toIndex(ps.basic.next_quadrant_ps);
     }
-    for (auto& quad : session_copy->Quadrants)
+    for (auto& quad : recorded.Session.Quadrants)
     {
-        quad = reinterpret_cast<paint_struct*>(
-            quad ? int(quad - &session->PaintStructs[0].basic) : std::size(session->Quadrants));
+        quad = toIndex(quad);
     }
 }
 
-static void viewport_fill_column(paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+static void viewport_fill_column(paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
     paint_session_generate(session);
     if (recorded_sessions != nullptr)
@@ -849,7 +875,22 @@ static void viewport_fill_column(paint_session* session, std::vector<paint_sessi
     paint_session_arrange(session);
 }
 
-static void viewport_paint_column(paint_session* session)
+#ifdef __ENABLE_LIGHTFX__
+static void viewport_fill_column_deferred_lights(
+    paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index,
+    std::vector<lightfx_deferred_light>* lights)
+{
+    lightfx_set_deferred_lights(lights);
+    viewport_fill_column(session, recorded_sessions, record_index);
+    lightfx_set_deferred_lights(nullptr);
+}
+#endif
+
+/**
+ * Draws the paint structs of a column. Only touches the column's own slice of the frame buffer so it is safe to call
+ * for different columns at the same time.
+ */
+static void viewport_draw_column(paint_session* session)
 {
     if (session->ViewFlags
             & (VIEWPORT_FLAG_HIDE_VERTICAL | VIEWPORT_FLAG_HIDE_BASE | VIEWPORT_FLAG_UNDERGROUND_INSIDE
@@ -871,7 +912,14 @@ static void viewport_paint_column(paint_session* session)
     {
         viewport_paint_weather_gloom(&session->DPI);
     }
+}
 
+/**
+ * Draws the money effect strings of a column and releases the session. Text rendering uses global state so this
+ * must always run on the main thread, in column order.
+ */
+static void viewport_finish_column(paint_session* session)
+{
     if (session->PSStringHead != nullptr)
     {
         paint_draw_money_structs(&session->DPI, session->PSStringHead);
@@ -880,6 +928,12 @@ static void viewport_paint_column(paint_session* session)
     paint_session_free(session);
 }
 
+static bool viewport_can_draw_parallel(const rct_drawpixelinfo* dpi)
+{
+    auto drawingEngine = dpi->DrawingEngine;
+    return drawingEngine != nullptr && (drawingEngine->GetFlags() & DEF_PARALLEL_DRAWING);
+}
+
 /**
  *
  *  rct2: 0x00685CBF
@@ -892,8 +946,10 @@ static void viewport_paint_column(paint_session* session)
  */
 void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
-    std::vector<paint_session>* recorded_sessions)
+    std::vector<RecordedPaintSession>* recorded_sessions)
 {
+    PROFILE_SCOPE(ViewportPaint);
+
     uint32_t viewFlags = viewport->flags;
     uint16_t width = right - left;
     uint16_t height = bottom - top;
@@ -931,24 +987,29 @@ void viewport_paint(
     std::vector<paint_session*> columns;
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
-    {
-        _paintJobs.reset();
-    }
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup paintJobs;
+
+    const uint16_t columnCount = (static_cast<uint16_t>(rightBorder - alignedX) + 31) / 32;
 
     // Create space to record sessions and keep track which index is being drawn
     size_t index = 0;
     if (recorded_sessions != nullptr)
     {
-        const uint16_t columnSize = rightBorder - alignedX;
-        const uint16_t columnCount = (columnSize + 31) / 32;
         recorded_sessions->resize(columnCount);
     }
 
+#ifdef __ENABLE_LIGHTFX__
+    // Lights found while painting on the job pool are collected per column and merged afterwards in column order,
+    // this keeps the light list independent of the order in which the columns finish.
+    const bool deferLights = useMultithreading && lightfx_is_available();
+    std::vector<std::vector<lightfx_deferred_light>> columnLights;
+    if (deferLights)
+    {
+        columnLights.resize(columnCount);
+    }
+#endif
+
     // Splits the area into 32 pixel columns and renders them
     for (x = alignedX; x < rightBorder; x += 32, index++)
     {
@@ -976,8 +1037,19 @@ void viewport_paint(
 
         if (useMultithreading)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
+#ifdef __ENABLE_LIGHTFX__
+            if (deferLights)
+            {
+                auto lights = &columnLights[index];
+                jobPool.AddTask(paintJobs, [session, recorded_sessions, index, lights]() -> void {
+                    viewport_fill_column_deferred_lights(session, recorded_sessions, index, lights);
+                });
+                continue;
+            }
+#endif
+            jobPool.AddTask(paintJobs, [session, recorded_sessions, index]() -> void {
+                viewport_fill_column(session, recorded_sessions, index);
+            });
         }
         else
         {
@@ -987,12 +1059,35 @@ void viewport_paint(
 
     if (useMultithreading)
     {
-        _paintJobs->Join();
+        jobPool.Join(paintJobs);
+    }
+
+#ifdef __ENABLE_LIGHTFX__
+    for (const auto& lights : columnLights)
+    {
+        lightfx_commit_deferred_lights(lights);
+    }
+#endif
+
+    if (useMultithreading && viewport_can_draw_parallel(&dpi1))
+    {
+        for (auto&& column : columns)
+        {
+            jobPool.AddTask(paintJobs, [column]() -> void { viewport_draw_column(column); });
+        }
+        jobPool.Join(paintJobs);
+    }
+    else
+    {
+        for (auto&& column : columns)
+        {
+            viewport_draw_column(column);
+        }
     }
 
     for (auto&& column : columns)
     {
-        viewport_paint_column(column);
+        viewport_finish_column(column);
     }
 }
 
@@ -32,7 +32,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "19"
+#define NETWORK_STREAM_VERSION "25"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -45,12 +45,14 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #ifndef DISABLE_NETWORK
 
 #    include "../Cheats.h"
+#    include "../ParkFile.h"
 #    include "../ParkImporter.h"
 #    include "../Version.h"
 #    include "../actions/GameAction.h"
 #    include "../config/Config.h"
 #    include "../core/Console.hpp"
 #    include "../core/FileStream.hpp"
+#    include "../core/JobPool.hpp"
 #    include "../core/Json.hpp"
 #    include "../core/MemoryStream.h"
 #    include "../core/Nullable.hpp"
@@ -78,8 +80,11 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 
 #    include <algorithm>
 #    include <array>
+#    include <atomic>
 #    include <cerrno>
+#    include <chrono>
 #    include <cmath>
+#    include <deque>
 #    include <fstream>
 #    include <functional>
 #    include <list>
@@ -87,6 +92,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include <memory>
 #    include <set>
 #    include <string>
+#    include <unordered_map>
 #    include <vector>
 
 #    if defined(_WIN32)
@@ -95,6 +101,72 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 
 using namespace OpenRCT2;
 
+// How much of a transfer may be waiting in the outbound queue of a connection, further chunks are queued once it drains.
+static constexpr size_t TRANSFER_WINDOW_SIZE = CHUNK_SIZE * 4;
+
+// Largest set of packed objects a client accepts, the size is announced by the server before any data is received.
+static constexpr uint32_t MAX_PACKED_OBJECTS_SIZE = 256 * 1024 * 1024;
+
+/**
+ * Data prepared by the job pool for a transfer. The task holds its own reference, so a transfer can be dropped before
+ * the data is ready without waiting for the task.
+ */
+struct NetworkTransferResult
+{
+    std::atomic_bool Ready = { false };
+    // nullptr if the data could not be prepared
+    std::shared_ptr<const std::vector<uint8_t>> Bytes;
+};
+
+using NetworkTransferData = std::shared_ptr<NetworkTransferResult>;
+
+template<typename TFunc> static NetworkTransferData PrepareTransferData(JobPool::TaskGroup& group, TFunc&& prepare)
+{
+    struct Job
+    {
+        NetworkTransferData Result;
+        std::decay_t<TFunc> Prepare;
+    };
+
+    auto result = std::make_shared<NetworkTransferResult>();
+    // Tasks are stored inline and have to be trivially copyable, so the task only holds a pointer to the job.
+    auto* job = new Job{ result, std::forward<TFunc>(prepare) };
+    auto runJob = [job]() {
+        std::unique_ptr<Job> owned(job);
+        owned->Result->Bytes = owned->Prepare();
+        owned->Result->Ready.store(true, std::memory_order_release);
+    };
+
+    // Nothing joins the group, without workers the task would never run.
+    auto& jobPool = JobPool::Get();
+    if (jobPool.GetConcurrency() > 1)
+    {
+        jobPool.AddTask(group, runJob);
+    }
+    else
+    {
+        runJob();
+    }
+    return result;
+}
+
+/**
+ * Data sent to a connection in chunks, each part is prepared by the job pool and sent once it is ready.
+ * Other packets to the connection are held back until the transfer is complete.
+ */
+struct NetworkTransfer
+{
+    struct Part
+    {
+        NETWORK_COMMAND Command;
+        NetworkTransferData Data;
+        size_t BytesQueued;
+    };
+
+    NetworkConnection* Connection;
+    std::deque<Part> Parts;
+};
+
 enum
 {
     SERVER_EVENT_PLAYER_JOINED,
@@ -217,7 +289,8 @@ private:
     void DecayCooldown(NetworkPlayer* player);
     void CloseConnection();
 
-    bool ProcessConnection(NetworkConnection& connection);
+    bool ProcessConnection(NetworkConnection& connection, bool readable = true, bool writable = true);
+    void SendQueuedPackets(NetworkConnection& connection, bool writable);
     void ProcessPacket(NetworkConnection& connection, NetworkPacket& packet);
     void AddClient(std::unique_ptr<ITcpSocket>&& socket);
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
@@ -231,7 +304,11 @@ private:
     void SetupDefaultGroups();
 
     bool LoadMap(IStream* stream);
-    bool SaveMap(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
+    void SaveMapExtraData(IStream* stream) const;
+    NetworkTransferData GetMapSnapshot(bool forceNew);
+    NetworkTransferData PackObjects(const std::vector<const ObjectRepositoryItem*>& objects);
+    void StartTransfer(NetworkConnection& connection, std::vector<NetworkTransfer::Part>&& parts);
+    void ProcessTransfers();
 
     struct PlayerListUpdate
     {
@@ -257,6 +334,9 @@ private:
     bool wsa_initialized = false;
     bool _clientMapLoaded = false;
     std::unique_ptr<ITcpSocket> _listenSocket;
+    std::unique_ptr<ISocketPoller> _socketPoller;
+    std::vector<SocketReadiness> _socketEvents;
+    std::unordered_map<const ITcpSocket*, SocketReadiness> _readySockets;
     std::unique_ptr<NetworkConnection> _serverConnection;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
     uint16_t listening_port = 0;
@@ -265,6 +345,12 @@ private:
     uint8_t player_id = 0;
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
     std::vector<uint8_t> chunk_buffer;
+    std::vector<uint8_t> _packedObjectsBuffer;
+    // The map saved during the current server update, shared by all clients that request it in the same update.
+    NetworkTransferData _mapSnapshot;
+    std::list<NetworkTransfer> _transfers;
+    // Tasks preparing transfer data, nothing waits for them.
+    JobPool::TaskGroup _transferJobs;
     std::string _host;
     uint16_t _port = 0;
     std::string _password;
@@ -292,6 +378,7 @@ private:
     void Server_Handle_AUTH(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Client_Joined(const char* name, const std::string& keyhash, NetworkConnection& connection);
     void Client_Handle_MAP(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_PACKED_OBJECTS(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_CHAT(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_CHAT(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
@@ -315,8 +402,6 @@ private:
     void Client_Handle_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_OBJECTS(NetworkConnection& connection, NetworkPacket& packet);
 
-    uint8_t* save_for_network(size_t& out_size, const std::vector<const ObjectRepositoryItem*>& objects) const;
-
     std::ofstream _chat_log_fs;
     std::ofstream _server_log_fs;
 };
@@ -348,6 +433,7 @@ Network::Network()
     client_command_handlers[NETWORK_COMMAND_TOKEN] = &Network::Client_Handle_TOKEN;
     client_command_handlers[NETWORK_COMMAND_OBJECTS] = &Network::Client_Handle_OBJECTS;
     client_command_handlers[NETWORK_COMMAND_SCRIPTS] = &Network::Client_Handle_SCRIPTS;
+    client_command_handlers[NETWORK_COMMAND_PACKED_OBJECTS] = &Network::Client_Handle_PACKED_OBJECTS;
     client_command_handlers[NETWORK_COMMAND_GAMESTATE] = &Network::Client_Handle_GAMESTATE;
     server_command_handlers.resize(NETWORK_COMMAND_MAX, nullptr);
     server_command_handlers[NETWORK_COMMAND_AUTH] = &Network::Server_Handle_AUTH;
@@ -455,6 +541,9 @@ void Network::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        _transfers.clear();
+        _mapSnapshot = {};
+        _socketPoller.reset();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -585,6 +674,9 @@ bool Network::BeginServer(uint16_t port, const std::string& address)
     try
     {
         _listenSocket->Listen(address, port);
+
+        _socketPoller = CreateSocketPoller();
+        _socketPoller->Add(_listenSocket.get());
     }
     catch (const std::exception& ex)
     {
@@ -714,26 +806,63 @@ void Network::Flush()
 {
     if (GetMode() == NETWORK_MODE_CLIENT)
     {
-        _serverConnection->SendQueuedPackets();
+        SendQueuedPackets(*_serverConnection, true);
     }
     else
     {
-        for (auto& it : client_connection_list)
+        // Without poll results only sockets that are not blocked are written to, like in UpdateServer.
+        for (auto& connection : client_connection_list)
         {
-            it->SendQueuedPackets();
+            if (connection->IsDisconnected || connection->Socket == nullptr)
+                continue;
+
+            const bool wasSendBlocked = connection->IsSendBlocked;
+            SendQueuedPackets(*connection, false);
+            if (connection->IsSendBlocked != wasSendBlocked)
+            {
+                _socketPoller->SetWriteInterest(connection->Socket.get(), connection->IsSendBlocked);
+            }
         }
     }
 }
 
 void Network::UpdateServer()
 {
+    // Game state may change between updates, even while paused.
+    _mapSnapshot = {};
+    ProcessTransfers();
+
+    // Only the sockets that are ready are touched, without readiness information every socket is considered ready.
+    const bool eventDriven = _socketPoller->IsEventDriven();
+    _socketPoller->Poll(_socketEvents, 0);
+
+    bool listenSocketReady = !eventDriven;
+    _readySockets.clear();
+    for (const auto& event : _socketEvents)
+    {
+        if (event.Socket == _listenSocket.get())
+            listenSocketReady = true;
+        else
+            _readySockets[event.Socket] = event;
+    }
+
     for (auto& connection : client_connection_list)
     {
         // This can be called multiple times before the connection is removed.
         if (connection->IsDisconnected)
             continue;
 
-        if (!ProcessConnection(*connection))
+        bool readable = !eventDriven;
+        bool writable = !eventDriven;
+        auto itReady = _readySockets.find(connection->Socket.get());
+        if (itReady != _readySockets.end())
+        {
+            readable = itReady->second.Readable;
+            writable = itReady->second.Writable;
+        }
+
+        const bool wasSendBlocked = connection->IsSendBlocked;
+        if (!ProcessConnection(*connection, readable, writable))
         {
             connection->IsDisconnected = true;
         }
@@ -741,6 +870,11 @@ void Network::UpdateServer()
         {
             DecayCooldown(connection->Player);
         }
+
+        if (connection->Socket != nullptr && connection->IsSendBlocked != wasSendBlocked)
+        {
+            _socketPoller->SetWriteInterest(connection->Socket.get(), connection->IsSendBlocked);
+        }
     }
 
     uint32_t ticks = platform_get_ticks();
@@ -755,10 +889,16 @@ void Network::UpdateServer()
         _advertiser->Update();
     }
 
-    std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
-    if (tcpSocket != nullptr)
+    if (listenSocketReady)
     {
-        AddClient(std::move(tcpSocket));
+        // Accept all pending connections at once.
+        for (;;)
+        {
+            std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
+            if (tcpSocket == nullptr)
+                break;
+            AddClient(std::move(tcpSocket));
+        }
     }
 }
 
@@ -954,7 +1094,7 @@ void Network::SendPacketToClients(NetworkPacket& packet, bool front, bool gameCm
                 continue;
             }
         }
-        client_connection->QueuePacket(NetworkPacket::Duplicate(packet), front);
+        client_connection->QueuePacket(packet, front);
     }
 }
 
@@ -1563,101 +1703,217 @@ void Network::Server_Send_AUTH(NetworkConnection& connection)
 
 void Network::Server_Send_MAP(NetworkConnection* connection)
 {
-    std::vector<const ObjectRepositoryItem*> objects;
     if (connection)
     {
-        objects = connection->RequestedObjects;
-    }
-    else
-    {
-        // This will send all custom objects to connected clients
-        // TODO: fix it so custom objects negotiation is performed even in this case.
-        auto context = GetContext();
-        auto& objManager = context->GetObjectManager();
-        objects = objManager.GetPackableObjects();
-    }
-
-    size_t out_size;
-    uint8_t* header = save_for_network(out_size, objects);
-    if (header == nullptr)
-    {
-        if (connection)
+        auto map = GetMapSnapshot(false);
+        if (map == nullptr)
         {
             connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
             connection->Socket->Disconnect();
+            return;
         }
-        return;
+
+        // The objects the client is missing have to be installed before the map is loaded.
+        std::vector<NetworkTransfer::Part> parts;
+        if (!connection->RequestedObjects.empty())
+        {
+            parts.push_back({ NETWORK_COMMAND_PACKED_OBJECTS, PackObjects(connection->RequestedObjects), 0 });
+        }
+        parts.push_back({ NETWORK_COMMAND_MAP, map, 0 });
+        StartTransfer(*connection, std::move(parts));
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < out_size; i += chunksize)
+    else
     {
-        size_t datasize = std::min(chunksize, out_size - i);
-        std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
-        *packet << static_cast<uint32_t>(NETWORK_COMMAND_MAP) << static_cast<uint32_t>(out_size) << static_cast<uint32_t>(i);
-        packet->Write(&header[i], datasize);
-        if (connection)
+        auto map = GetMapSnapshot(true);
+        if (map == nullptr)
         {
-            connection->QueuePacket(std::move(packet));
+            return;
         }
-        else
+
+        // This will send all custom objects to connected clients
+        // TODO: fix it so custom objects negotiation is performed even in this case.
+        auto& objManager = GetContext()->GetObjectManager();
+        auto objects = objManager.GetPackableObjects();
+        NetworkTransferData packedObjects;
+        if (!objects.empty())
+        {
+            packedObjects = PackObjects(objects);
+        }
+
+        for (auto& clientConnection : client_connection_list)
         {
-            SendPacketToClients(*packet);
+            if (clientConnection->IsDisconnected || clientConnection->AuthStatus != NETWORK_AUTH_OK)
+            {
+                continue;
+            }
+
+            std::vector<NetworkTransfer::Part> parts;
+            if (packedObjects != nullptr)
+            {
+                parts.push_back({ NETWORK_COMMAND_PACKED_OBJECTS, packedObjects, 0 });
+            }
+            parts.push_back({ NETWORK_COMMAND_MAP, map, 0 });
+            StartTransfer(*clientConnection, std::move(parts));
         }
     }
-    free(header);
 }
 
-uint8_t* Network::save_for_network(size_t& out_size, const std::vector<const ObjectRepositoryItem*>& objects) const
+NetworkTransferData Network::GetMapSnapshot(bool forceNew)
 {
-    uint8_t* header = nullptr;
-    out_size = 0;
+    if (!forceNew && _mapSnapshot != nullptr)
+    {
+        return _mapSnapshot;
+    }
+
+    // The park has to be exported between ticks, compressing the exported sections can be done by a worker thread.
+    std::shared_ptr<S6Exporter> s6exporter;
+    std::shared_ptr<ParkFileWriter> writer;
+    auto extraData = std::make_shared<MemoryStream>();
     bool RLEState = gUseRLE;
     gUseRLE = false;
-
-    auto ms = MemoryStream();
-    if (!SaveMap(&ms, objects))
+    map_reorganise_elements();
+    viewport_set_saved_view();
+    try
     {
-        log_warning("Failed to export map.");
-        return nullptr;
+        s6exporter = std::make_shared<S6Exporter>();
+        s6exporter->Export();
+        writer = std::make_shared<ParkFileWriter>(ParkFileExporter(*s6exporter).PrepareGame());
+        SaveMapExtraData(extraData.get());
+    }
+    catch (const std::exception& e)
+    {
+        gUseRLE = RLEState;
+        log_warning("Failed to export map: %s", e.what());
+        return {};
     }
     gUseRLE = RLEState;
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
+    auto saveMap = [s6exporter, writer, extraData]() -> std::shared_ptr<const std::vector<uint8_t>> {
+        try
+        {
+            // The sections of a park file are already compressed
+            const char* mapFormat = "open2_park";
+            auto ms = MemoryStream();
+            ms.Write(mapFormat, strlen(mapFormat) + 1);
+            writer->Write(&ms);
+            ms.Write(extraData->GetData(), extraData->GetLength());
+
+            auto data = static_cast<const uint8_t*>(ms.GetData());
+            auto result = std::make_shared<std::vector<uint8_t>>(data, data + ms.GetLength());
+            log_verbose("Prepared map of %u bytes", result->size());
+            return result;
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Failed to save map: %s", e.what());
+            return nullptr;
+        }
+    };
+    _mapSnapshot = PrepareTransferData(_transferJobs, saveMap);
+    return _mapSnapshot;
+}
 
-    auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
-    if (compressed != std::nullopt)
+NetworkTransferData Network::PackObjects(const std::vector<const ObjectRepositoryItem*>& objects)
+{
+    // The task may outlive the repository, it packs copies of the items.
+    std::vector<ObjectRepositoryItem> items;
+    items.reserve(objects.size());
+    for (const auto* object : objects)
     {
-        out_size = compressed->size();
-        header = reinterpret_cast<uint8_t*>(_strdup("open2_sv6_zlib"));
-        size_t header_len = strlen(reinterpret_cast<char*>(header)) + 1; // account for null terminator
-        header = static_cast<uint8_t*>(realloc(header, header_len + out_size));
-        if (header == nullptr)
+        items.push_back(*object);
+    }
+
+    return PrepareTransferData(_transferJobs, [items = std::move(items)]() -> std::shared_ptr<const std::vector<uint8_t>> {
+        try
         {
-            log_error("Failed to allocate %u bytes.", header_len + out_size);
+            std::vector<const ObjectRepositoryItem*> objectsToPack;
+            for (const auto& item : items)
+            {
+                objectsToPack.push_back(&item);
+            }
+
+            auto ms = MemoryStream();
+            ms.WriteValue<uint32_t>(static_cast<uint32_t>(objectsToPack.size()));
+            WritePackedObjects(&ms, objectsToPack);
+
+            auto data = static_cast<const uint8_t*>(ms.GetData());
+            return std::make_shared<std::vector<uint8_t>>(data, data + ms.GetLength());
         }
-        else
+        catch (const std::exception& e)
         {
-            std::memcpy(&header[header_len], compressed->data(), out_size);
-            out_size += header_len;
-            log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, out_size);
+            log_error("Failed to pack objects: %s", e.what());
+            return nullptr;
         }
+    });
+}
+
+void Network::StartTransfer(NetworkConnection& connection, std::vector<NetworkTransfer::Part>&& parts)
+{
+    auto it = std::find_if(_transfers.begin(), _transfers.end(), [&connection](const NetworkTransfer& transfer) {
+        return transfer.Connection == &connection;
+    });
+    if (it == _transfers.end())
+    {
+        connection.HoldPackets();
+        it = _transfers.insert(_transfers.end(), NetworkTransfer{ &connection, {} });
     }
-    else
+
+    // A new map replaces the rest of a transfer in progress, the client starts over when it receives its first chunk.
+    it->Parts.clear();
+    std::move(parts.begin(), parts.end(), std::back_inserter(it->Parts));
+}
+
+void Network::ProcessTransfers()
+{
+    for (auto it = _transfers.begin(); it != _transfers.end();)
     {
-        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
-        header = static_cast<uint8_t*>(malloc(size));
-        if (header == nullptr)
+        auto& connection = *it->Connection;
+        bool failed = false;
+        while (!it->Parts.empty() && connection.GetQueuedBytes() < TRANSFER_WINDOW_SIZE)
         {
-            log_error("Failed to allocate %u bytes.", size);
+            auto& part = it->Parts.front();
+            if (!part.Data->Ready.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            const auto& data = part.Data->Bytes;
+            if (data == nullptr)
+            {
+                failed = true;
+                break;
+            }
+
+            size_t datasize = std::min<size_t>(CHUNK_SIZE, data->size() - part.BytesQueued);
+            std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+            *packet << static_cast<uint32_t>(part.Command) << static_cast<uint32_t>(data->size())
+                    << static_cast<uint32_t>(part.BytesQueued);
+            packet->Write(data->data() + part.BytesQueued, datasize);
+            connection.QueueTransferPacket(*packet);
+
+            part.BytesQueued += datasize;
+            if (part.BytesQueued >= data->size())
+            {
+                it->Parts.pop_front();
+            }
+        }
+
+        if (failed)
+        {
+            connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+            connection.Socket->Disconnect();
+        }
+        if (failed || it->Parts.empty())
+        {
+            // Everything sent while the transfer was running follows the last chunk.
+            connection.ReleasePackets();
+            it = _transfers.erase(it);
         }
         else
         {
-            out_size = size;
-            std::memcpy(header, data, size);
+            it++;
         }
     }
-    return header;
 }
 
 void Network::Client_Send_CHAT(const char* text)
@@ -1686,7 +1942,7 @@ void Network::Server_Send_CHAT(const char* text, const std::vector<uint8_t>& pla
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr && !conn->IsDisconnected)
             {
-                conn->QueuePacket(NetworkPacket::Duplicate(*packet));
+                conn->QueuePacket(*packet);
             }
         }
     }
@@ -1887,10 +2143,10 @@ void Network::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName, cons
     SendPacketToClients(*packet);
 }
 
-bool Network::ProcessConnection(NetworkConnection& connection)
+bool Network::ProcessConnection(NetworkConnection& connection, bool readable, bool writable)
 {
-    int32_t packetStatus;
-    do
+    int32_t packetStatus = readable ? NETWORK_READPACKET_MORE_DATA : NETWORK_READPACKET_NO_DATA;
+    while (packetStatus == NETWORK_READPACKET_MORE_DATA || packetStatus == NETWORK_READPACKET_SUCCESS)
     {
         packetStatus = connection.ReadPacket();
         switch (packetStatus)
@@ -1917,8 +2173,9 @@ bool Network::ProcessConnection(NetworkConnection& connection)
                 // could not read anything from socket
                 break;
         }
-    } while (packetStatus == NETWORK_READPACKET_MORE_DATA || packetStatus == NETWORK_READPACKET_SUCCESS);
-    connection.SendQueuedPackets();
+    }
+
+    SendQueuedPackets(connection, writable);
     if (!connection.ReceivedPacketRecently())
     {
         if (!connection.GetLastDisconnectReason())
@@ -1930,6 +2187,15 @@ bool Network::ProcessConnection(NetworkConnection& connection)
     return true;
 }
 
+void Network::SendQueuedPackets(NetworkConnection& connection, bool writable)
+{
+    // A blocked socket is only written to again once it reports free space.
+    if (connection.HasQueuedPackets() && (writable || !connection.IsSendBlocked))
+    {
+        connection.IsSendBlocked = !connection.SendQueuedPackets();
+    }
+}
+
 void Network::ProcessPacket(NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t command;
@@ -2166,6 +2432,11 @@ void Network::ProcessDisconnectedClients()
             ServerClientDisconnected(connection);
             RemovePlayer(connection);
 
+            if (_socketPoller != nullptr && connection->Socket != nullptr)
+            {
+                _socketPoller->Remove(connection->Socket.get());
+            }
+            _transfers.remove_if([&connection](const NetworkTransfer& t) { return t.Connection == connection.get(); });
             it = client_connection_list.erase(it);
         }
         else
@@ -2182,6 +2453,16 @@ void Network::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     snprintf(addr, sizeof(addr), "Client joined from %s", socket->GetHostName());
     AppendServerLog(addr);
 
+    try
+    {
+        _socketPoller->Add(socket.get());
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to add client: %s", e.what());
+        return;
+    }
+
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
@@ -2421,21 +2702,34 @@ void Network::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection, Net
         MemoryStream snapshotMemory;
         DataSerialiser ds(true, snapshotMemory);
 
-        snapshots->SerialiseSnapshot(const_cast<GameStateSnapshot_t&>(*snapshot), ds);
+        snapshots->SerialiseSnapshotDeltas(const_cast<GameStateSnapshot_t&>(*snapshot), ds);
+
+        // The deltas are mostly unchanged bytes and compress well.
+        auto compressed = util_zlib_deflate(
+            static_cast<const uint8_t*>(snapshotMemory.GetData()), static_cast<size_t>(snapshotMemory.GetLength()));
+        if (!compressed)
+        {
+            log_error("Failed to compress game state snapshot.");
+            return;
+        }
+
+        MemoryStream gameStateMemory;
+        gameStateMemory.WriteValue<uint32_t>(static_cast<uint32_t>(snapshotMemory.GetLength()));
+        gameStateMemory.Write(compressed->data(), compressed->size());
 
         uint32_t bytesSent = 0;
-        uint32_t length = static_cast<uint32_t>(snapshotMemory.GetLength());
+        uint32_t length = static_cast<uint32_t>(gameStateMemory.GetLength());
         while (bytesSent < length)
         {
             uint32_t dataSize = CHUNK_SIZE;
-            if (bytesSent + dataSize > snapshotMemory.GetLength())
+            if (bytesSent + dataSize > length)
             {
-                dataSize = snapshotMemory.GetLength() - bytesSent;
+                dataSize = length - bytesSent;
             }
 
             std::unique_ptr<NetworkPacket> gameStateChunk(NetworkPacket::Allocate());
             *gameStateChunk << static_cast<uint32_t>(NETWORK_COMMAND_GAMESTATE) << tick << length << bytesSent << dataSize;
-            gameStateChunk->Write(static_cast<const uint8_t*>(snapshotMemory.GetData()) + bytesSent, dataSize);
+            gameStateChunk->Write(static_cast<const uint8_t*>(gameStateMemory.GetData()) + bytesSent, dataSize);
 
             connection.QueuePacket(std::move(gameStateChunk));
 
@@ -2618,12 +2912,25 @@ void Network::Client_Handle_GAMESTATE(NetworkConnection& connection, NetworkPack
     if (_serverGameState.GetLength() == totalSize)
     {
         _serverGameState.SetPosition(0);
-        DataSerialiser ds(false, _serverGameState);
+        const auto uncompressedSize = _serverGameState.ReadValue<uint32_t>();
+        const auto compressedSize = static_cast<size_t>(totalSize - _serverGameState.GetPosition());
+
+        std::vector<uint8_t> snapshotData(uncompressedSize);
+        if (!util_zlib_inflate(
+                static_cast<const uint8_t*>(_serverGameState.GetData()) + _serverGameState.GetPosition(), compressedSize,
+                snapshotData.data(), snapshotData.size()))
+        {
+            log_error("Failed to decompress game state snapshot.");
+            return;
+        }
+
+        MemoryStream snapshotMemory(snapshotData.data(), snapshotData.size());
+        DataSerialiser ds(false, snapshotMemory);
 
         IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
 
         GameStateSnapshot_t& serverSnapshot = snapshots->CreateSnapshot();
-        snapshots->SerialiseSnapshot(serverSnapshot, ds);
+        snapshots->SerialiseSnapshotDeltas(serverSnapshot, ds);
 
         const GameStateSnapshot_t* desyncSnapshot = snapshots->GetLinkedSnapshot(tick);
         if (desyncSnapshot)
@@ -2859,27 +3166,17 @@ void Network::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connection,
         GameActions::ResumeQueue();
 
         context_force_close_window_by_class(WC_NETWORK_STATUS);
-        bool has_to_free = false;
-        uint8_t* data = &chunk_buffer[0];
-        size_t data_size = size;
-        // zlib-compressed
-        if (strcmp("open2_sv6_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0)
-        {
-            log_verbose("Received zlib-compressed sv6 map");
-            has_to_free = true;
-            size_t header_len = strlen("open2_sv6_zlib") + 1;
-            data = util_zlib_inflate(&chunk_buffer[header_len], size - header_len, &data_size);
-            if (data == nullptr)
-            {
-                log_warning("Failed to decompress data sent from server.");
-                Close();
-                return;
-            }
-        }
-        else
+        const char* mapFormat = "open2_park";
+        size_t header_len = strlen(mapFormat) + 1;
+        if (size < header_len || std::memcmp(mapFormat, &chunk_buffer[0], header_len) != 0)
         {
-            log_verbose("Assuming received map is in plain sv6 format");
+            log_warning("Received map is not in a known format.");
+            Close();
+            return;
         }
+        log_verbose("Received park file map");
+        uint8_t* data = &chunk_buffer[header_len];
+        size_t data_size = size - header_len;
 
         auto ms = MemoryStream(data, data_size);
         if (LoadMap(&ms))
@@ -2904,10 +3201,45 @@ void Network::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connection,
             auto loadOrQuitAction = LoadOrQuitAction(LoadOrQuitModes::OpenSavePrompt, PM_SAVE_BEFORE_QUIT);
             GameActions::Execute(&loadOrQuitAction);
         }
-        if (has_to_free)
+    }
+}
+
+void Network::Client_Handle_PACKED_OBJECTS([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t size, offset;
+    packet >> size >> offset;
+    int32_t chunksize = static_cast<int32_t>(packet.Size - packet.BytesRead);
+    if (chunksize <= 0 || size > MAX_PACKED_OBJECTS_SIZE || offset > size
+        || static_cast<uint32_t>(chunksize) > size - offset)
+    {
+        log_warning("Received invalid packed objects chunk");
+        return;
+    }
+    if (size > _packedObjectsBuffer.size())
+    {
+        _packedObjectsBuffer.resize(size);
+    }
+    std::memcpy(&_packedObjectsBuffer[offset], packet.Read(chunksize), chunksize);
+    if (offset + chunksize == size)
+    {
+        // Install the objects now, the map that follows refers to them.
+        try
+        {
+            auto ms = MemoryStream(_packedObjectsBuffer.data(), size);
+            auto numObjects = ms.ReadValue<uint32_t>();
+            auto& objRepo = GetContext()->GetObjectRepository();
+            for (uint32_t i = 0; i < numObjects; i++)
+            {
+                objRepo.ExportPackedObject(&ms);
+            }
+            log_verbose("Received %u packed objects", numObjects);
+        }
+        catch (const std::exception& e)
         {
-            free(data);
+            log_warning("Failed to read packed objects: %s", e.what());
         }
+        _packedObjectsBuffer.clear();
+        _packedObjectsBuffer.shrink_to_fit();
     }
 }
 
@@ -2926,9 +3258,6 @@ bool Network::LoadMap(IStream* stream)
         sprite_position_tween_reset();
         AutoCreateMapAnimations();
 
-        // Read checksum
-        [[maybe_unused]] uint32_t checksum = stream->ReadValue<uint32_t>();
-
         // Read other data not in normal save files
         gGamePaused = stream->ReadValue<uint32_t>();
         _guestGenerationProbability = stream->ReadValue<uint32_t>();
@@ -2966,52 +3295,35 @@ bool Network::LoadMap(IStream* stream)
     return result;
 }
 
-bool Network::SaveMap(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const
-{
-    bool result = false;
-    map_reorganise_elements();
-    viewport_set_saved_view();
-    try
-    {
-        auto s6exporter = std::make_unique<S6Exporter>();
-        s6exporter->ExportObjectsList = objects;
-        s6exporter->Export();
-        s6exporter->SaveGame(stream);
-
-        // Write other data not in normal save files
-        stream->WriteValue<uint32_t>(gGamePaused);
-        stream->WriteValue<uint32_t>(_guestGenerationProbability);
-        stream->WriteValue<uint32_t>(_suggestedGuestMaximum);
-        stream->WriteValue<uint8_t>(gCheatsAllowTrackPlaceInvalidHeights);
-        stream->WriteValue<uint8_t>(gCheatsEnableAllDrawableTrackPieces);
-        stream->WriteValue<uint8_t>(gCheatsSandboxMode);
-        stream->WriteValue<uint8_t>(gCheatsDisableClearanceChecks);
-        stream->WriteValue<uint8_t>(gCheatsDisableSupportLimits);
-        stream->WriteValue<uint8_t>(gCheatsDisableTrainLengthLimit);
-        stream->WriteValue<uint8_t>(gCheatsEnableChainLiftOnAllTrack);
-        stream->WriteValue<uint8_t>(gCheatsShowAllOperatingModes);
-        stream->WriteValue<uint8_t>(gCheatsShowVehiclesFromOtherTrackTypes);
-        stream->WriteValue<uint8_t>(gCheatsFastLiftHill);
-        stream->WriteValue<uint8_t>(gCheatsDisableBrakesFailure);
-        stream->WriteValue<uint8_t>(gCheatsDisableAllBreakdowns);
-        stream->WriteValue<uint8_t>(gCheatsBuildInPauseMode);
-        stream->WriteValue<uint8_t>(gCheatsIgnoreRideIntensity);
-        stream->WriteValue<uint8_t>(gCheatsDisableVandalism);
-        stream->WriteValue<uint8_t>(gCheatsDisableLittering);
-        stream->WriteValue<uint8_t>(gCheatsNeverendingMarketing);
-        stream->WriteValue<uint8_t>(gCheatsFreezeWeather);
-        stream->WriteValue<uint8_t>(gCheatsDisablePlantAging);
-        stream->WriteValue<uint8_t>(gCheatsAllowArbitraryRideTypeChanges);
-        stream->WriteValue<uint8_t>(gCheatsDisableRideValueAging);
-        stream->WriteValue<uint8_t>(gConfigGeneral.show_real_names_of_guests);
-        stream->WriteValue<uint8_t>(gCheatsIgnoreResearchStatus);
-
-        result = true;
-    }
-    catch (const std::exception&)
-    {
-    }
-    return result;
+void Network::SaveMapExtraData(IStream* stream) const
+{
+    // Write other data not in normal save files
+    stream->WriteValue<uint32_t>(gGamePaused);
+    stream->WriteValue<uint32_t>(_guestGenerationProbability);
+    stream->WriteValue<uint32_t>(_suggestedGuestMaximum);
+    stream->WriteValue<uint8_t>(gCheatsAllowTrackPlaceInvalidHeights);
+    stream->WriteValue<uint8_t>(gCheatsEnableAllDrawableTrackPieces);
+    stream->WriteValue<uint8_t>(gCheatsSandboxMode);
+    stream->WriteValue<uint8_t>(gCheatsDisableClearanceChecks);
+    stream->WriteValue<uint8_t>(gCheatsDisableSupportLimits);
+    stream->WriteValue<uint8_t>(gCheatsDisableTrainLengthLimit);
+    stream->WriteValue<uint8_t>(gCheatsEnableChainLiftOnAllTrack);
+    stream->WriteValue<uint8_t>(gCheatsShowAllOperatingModes);
+    stream->WriteValue<uint8_t>(gCheatsShowVehiclesFromOtherTrackTypes);
+    stream->WriteValue<uint8_t>(gCheatsFastLiftHill);
+    stream->WriteValue<uint8_t>(gCheatsDisableBrakesFailure);
+    stream->WriteValue<uint8_t>(gCheatsDisableAllBreakdowns);
+    stream->WriteValue<uint8_t>(gCheatsBuildInPauseMode);
+    stream->WriteValue<uint8_t>(gCheatsIgnoreRideIntensity);
+    stream->WriteValue<uint8_t>(gCheatsDisableVandalism);
+    stream->WriteValue<uint8_t>(gCheatsDisableLittering);
+    stream->WriteValue<uint8_t>(gCheatsNeverendingMarketing);
+    stream->WriteValue<uint8_t>(gCheatsFreezeWeather);
+    stream->WriteValue<uint8_t>(gCheatsDisablePlantAging);
+    stream->WriteValue<uint8_t>(gCheatsAllowArbitraryRideTypeChanges);
+    stream->WriteValue<uint8_t>(gCheatsDisableRideValueAging);
+    stream->WriteValue<uint8_t>(gConfigGeneral.show_real_names_of_guests);
+    stream->WriteValue<uint8_t>(gCheatsIgnoreResearchStatus);
 }
 
 void Network::Client_Handle_CHAT([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
@@ -18,6 +18,7 @@
 #    include "network.h"
 
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
+constexpr size_t NETWORK_MAX_BATCHED_PACKETS = 32;
 
 NetworkConnection::NetworkConnection()
 {
@@ -74,7 +75,7 @@ int32_t NetworkConnection::ReadPacket()
         {
             _lastPacketTime = platform_get_ticks();
 
-            RecordPacketStats(InboundPacket, false);
+            RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, false);
 
             return NETWORK_READPACKET_SUCCESS;
         }
@@ -82,62 +83,140 @@ int32_t NetworkConnection::ReadPacket()
     return NETWORK_READPACKET_MORE_DATA;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(std::unique_ptr<NetworkPacket> packet, bool front)
 {
-    uint16_t sizen = Convert::HostToNetwork(packet.Size);
-    std::vector<uint8_t> tosend;
-    tosend.reserve(sizeof(sizen) + packet.Size);
-    tosend.insert(tosend.end(), reinterpret_cast<uint8_t*>(&sizen), reinterpret_cast<uint8_t*>(&sizen) + sizeof(sizen));
-    tosend.insert(tosend.end(), packet.Data->begin(), packet.Data->end());
+    QueuePacket(*packet, front);
+}
 
-    const void* buffer = &tosend[packet.BytesTransferred];
-    size_t bufferSize = tosend.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer, bufferSize);
-    if (sent > 0)
+void NetworkConnection::QueuePacket(const NetworkPacket& packet, bool front)
+{
+    if (AuthStatus == NETWORK_AUTH_OK || !packet.CommandRequiresAuth())
     {
-        packet.BytesTransferred += sent;
+        NetworkOutboundPacket outboundPacket;
+        outboundPacket.Data = packet.Data;
+        outboundPacket.Command = packet.GetCommand();
+        outboundPacket.SizeHeader = Convert::HostToNetwork(static_cast<uint16_t>(packet.Data->size()));
+        if (_holdPackets && !front)
+        {
+            _heldPackets.push_back(std::move(outboundPacket));
+        }
+        else
+        {
+            QueueOutboundPacket(std::move(outboundPacket), front);
+        }
     }
+}
+
+void NetworkConnection::QueueTransferPacket(const NetworkPacket& packet)
+{
+    NetworkOutboundPacket outboundPacket;
+    outboundPacket.Data = packet.Data;
+    outboundPacket.Command = packet.GetCommand();
+    outboundPacket.SizeHeader = Convert::HostToNetwork(static_cast<uint16_t>(packet.Data->size()));
+    QueueOutboundPacket(std::move(outboundPacket), false);
+}
 
-    bool sendComplete = packet.BytesTransferred == tosend.size();
-    if (sendComplete)
+void NetworkConnection::QueueOutboundPacket(NetworkOutboundPacket&& packet, bool front)
+{
+    _outboundBytes += packet.GetLength();
+    if (front)
     {
-        RecordPacketStats(packet, true);
+        // If the first packet was already partially sent add new packet to second position
+        if (!_outboundPackets.empty() && _outboundPackets.front().BytesTransferred > 0)
+        {
+            _outboundPackets.insert(_outboundPackets.begin() + 1, std::move(packet));
+        }
+        else
+        {
+            _outboundPackets.push_front(std::move(packet));
+        }
+    }
+    else
+    {
+        _outboundPackets.push_back(std::move(packet));
     }
-    return sendComplete;
 }
 
-void NetworkConnection::QueuePacket(std::unique_ptr<NetworkPacket> packet, bool front)
+void NetworkConnection::HoldPackets()
+{
+    _holdPackets = true;
+}
+
+void NetworkConnection::ReleasePackets()
 {
-    if (AuthStatus == NETWORK_AUTH_OK || !packet->CommandRequiresAuth())
+    _holdPackets = false;
+    for (auto& packet : _heldPackets)
     {
-        packet->Size = static_cast<uint16_t>(packet->Data->size());
-        if (front)
+        QueueOutboundPacket(std::move(packet), false);
+    }
+    _heldPackets.clear();
+}
+
+bool NetworkConnection::HasQueuedPackets() const
+{
+    return !_outboundPackets.empty();
+}
+
+size_t NetworkConnection::GetQueuedBytes() const
+{
+    return _outboundBytes;
+}
+
+bool NetworkConnection::SendQueuedPackets()
+{
+    while (!_outboundPackets.empty())
+    {
+        // Send as many queued packets as possible with one vectored write, the size prefix and the shared packet data
+        // are passed as separate buffers so nothing has to be copied.
+        SocketBuffer buffers[NETWORK_MAX_BATCHED_PACKETS * 2];
+        size_t numBuffers = 0;
+        size_t batchSize = 0;
+        for (size_t i = 0; i < _outboundPackets.size() && i < NETWORK_MAX_BATCHED_PACKETS; i++)
         {
-            // If the first packet was already partially sent add new packet to second position
-            if (!_outboundPackets.empty() && _outboundPackets.front()->BytesTransferred > 0)
+            const auto& packet = _outboundPackets[i];
+            const auto* header = reinterpret_cast<const uint8_t*>(&packet.SizeHeader);
+            size_t offset = packet.BytesTransferred;
+            if (offset < sizeof(packet.SizeHeader))
             {
-                auto it = _outboundPackets.begin();
-                it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
+                buffers[numBuffers++] = { header + offset, sizeof(packet.SizeHeader) - offset };
+                offset = 0;
             }
             else
             {
-                _outboundPackets.push_front(std::move(packet));
+                offset -= sizeof(packet.SizeHeader);
             }
+            if (offset < packet.Data->size())
+            {
+                buffers[numBuffers++] = { packet.Data->data() + offset, packet.Data->size() - offset };
+            }
+            batchSize += packet.GetLength() - packet.BytesTransferred;
         }
-        else
+
+        size_t sent = Socket->SendData(buffers, numBuffers);
+        const bool batchComplete = sent == batchSize;
+
+        while (sent > 0)
         {
-            _outboundPackets.push_back(std::move(packet));
+            auto& packet = _outboundPackets.front();
+            size_t remaining = packet.GetLength() - packet.BytesTransferred;
+            if (sent < remaining)
+            {
+                packet.BytesTransferred += sent;
+                break;
+            }
+
+            sent -= remaining;
+            _outboundBytes -= packet.GetLength();
+            RecordPacketStats(packet.Command, packet.GetLength(), true);
+            _outboundPackets.pop_front();
         }
-    }
-}
 
-void NetworkConnection::SendQueuedPackets()
-{
-    while (!_outboundPackets.empty() && SendPacket(*_outboundPackets.front()))
-    {
-        _outboundPackets.remove(_outboundPackets.front());
+        if (!batchComplete)
+        {
+            break;
+        }
     }
+    return _outboundPackets.empty();
 }
 
 void NetworkConnection::ResetLastPacketTime()
@@ -184,17 +263,17 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(int32_t command, size_t packetSize, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
     uint32_t trafficGroup = NETWORK_STATISTICS_GROUP_BASE;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NETWORK_COMMAND_GAME_ACTION:
             trafficGroup = NETWORK_STATISTICS_GROUP_COMMANDS;
             break;
         case NETWORK_COMMAND_MAP:
+        case NETWORK_COMMAND_PACKED_OBJECTS:
             trafficGroup = NETWORK_STATISTICS_GROUP_MAPDATA;
             break;
     }
@@ -16,13 +16,29 @@
 #    include "NetworkTypes.h"
 #    include "Socket.h"
 
-#    include <list>
+#    include <deque>
 #    include <memory>
 #    include <vector>
 
 class NetworkPlayer;
 struct ObjectRepositoryItem;
 
+/**
+ * A packet waiting to be sent. The data is shared by all connections the packet was queued on.
+ */
+struct NetworkOutboundPacket
+{
+    std::shared_ptr<const std::vector<uint8_t>> Data;
+    int32_t Command = NETWORK_COMMAND_INVALID;
+    uint16_t SizeHeader = 0; // Network byte order
+    size_t BytesTransferred = 0;
+
+    size_t GetLength() const
+    {
+        return sizeof(SizeHeader) + Data->size();
+    }
+};
+
 class NetworkConnection final
 {
 public:
@@ -36,13 +52,37 @@ public:
     std::vector<uint8_t> Challenge;
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
     bool IsDisconnected = false;
+    bool IsSendBlocked = false; // The socket could not take all queued packets on the last attempt
 
     NetworkConnection();
     ~NetworkConnection();
 
     int32_t ReadPacket();
     void QueuePacket(std::unique_ptr<NetworkPacket> packet, bool front = false);
-    void SendQueuedPackets();
+
+    /**
+     * Queues a packet without copying its data, the packet data must not be modified afterwards.
+     */
+    void QueuePacket(const NetworkPacket& packet, bool front = false);
+    bool HasQueuedPackets() const;
+
+    /**
+     * Number of bytes waiting to be sent, not counting held packets.
+     */
+    size_t GetQueuedBytes() const;
+
+    /**
+     * Holds back packets queued from now on until ReleasePackets is called, so that they are sent after a transfer
+     * that is still being prepared. Transfer packets are queued with QueueTransferPacket.
+     */
+    void HoldPackets();
+    void ReleasePackets();
+    void QueueTransferPacket(const NetworkPacket& packet);
+
+    /**
+     * Sends as many queued packets as the socket takes, returns true when all packets were sent.
+     */
+    bool SendQueuedPackets();
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
 
@@ -51,12 +91,15 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::list<std::unique_ptr<NetworkPacket>> _outboundPackets;
+    std::deque<NetworkOutboundPacket> _outboundPackets;
+    std::deque<NetworkOutboundPacket> _heldPackets;
+    size_t _outboundBytes = 0;
+    bool _holdPackets = false;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(int32_t command, size_t packetSize, bool sending);
+    void QueueOutboundPacket(NetworkOutboundPacket&& packet, bool front);
 };
 
 #endif // DISABLE_NETWORK
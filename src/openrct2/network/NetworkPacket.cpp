@@ -14,15 +14,64 @@
 #    include "NetworkTypes.h"
 
 #    include <memory>
+#    include <mutex>
+
+// Buffers of the largest packets are freed rather than kept in the pool.
+constexpr size_t NETWORK_PACKET_POOL_MAX_BUFFERS = 256;
+constexpr size_t NETWORK_PACKET_POOL_MAX_CAPACITY = 16 * 1024;
+
+struct NetworkPacketBufferPool
+{
+    std::mutex Mutex;
+    std::vector<std::vector<uint8_t>*> Buffers;
+};
+
+static NetworkPacketBufferPool& GetBufferPool()
+{
+    // Never destroyed, packets may still be released during shutdown.
+    static auto* pool = new NetworkPacketBufferPool();
+    return *pool;
+}
+
+static void ReleaseBuffer(std::vector<uint8_t>* buffer)
+{
+    if (buffer->capacity() <= NETWORK_PACKET_POOL_MAX_CAPACITY)
+    {
+        buffer->clear();
+
+        auto& pool = GetBufferPool();
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+        if (pool.Buffers.size() < NETWORK_PACKET_POOL_MAX_BUFFERS)
+        {
+            pool.Buffers.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
 
 std::unique_ptr<NetworkPacket> NetworkPacket::Allocate()
 {
     return std::make_unique<NetworkPacket>();
 }
 
-std::unique_ptr<NetworkPacket> NetworkPacket::Duplicate(NetworkPacket& packet)
+std::shared_ptr<std::vector<uint8_t>> NetworkPacket::AllocateBuffer()
 {
-    return std::make_unique<NetworkPacket>(packet);
+    std::vector<uint8_t>* buffer = nullptr;
+    {
+        auto& pool = GetBufferPool();
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+        if (!pool.Buffers.empty())
+        {
+            buffer = pool.Buffers.back();
+            pool.Buffers.pop_back();
+        }
+    }
+    if (buffer == nullptr)
+    {
+        buffer = new std::vector<uint8_t>();
+    }
+    return std::shared_ptr<std::vector<uint8_t>>(buffer, ReleaseBuffer);
 }
 
 uint8_t* NetworkPacket::GetData()
@@ -49,7 +98,7 @@ void NetworkPacket::Clear()
     Data->clear();
 }
 
-bool NetworkPacket::CommandRequiresAuth()
+bool NetworkPacket::CommandRequiresAuth() const
 {
     switch (GetCommand())
     {
@@ -20,18 +20,23 @@ class NetworkPacket final
 {
 public:
     uint16_t Size = 0;
-    std::shared_ptr<std::vector<uint8_t>> Data = std::make_shared<std::vector<uint8_t>>();
+    std::shared_ptr<std::vector<uint8_t>> Data = AllocateBuffer();
     size_t BytesTransferred = 0;
     size_t BytesRead = 0;
 
     static std::unique_ptr<NetworkPacket> Allocate();
-    static std::unique_ptr<NetworkPacket> Duplicate(NetworkPacket& packet);
+
+    /**
+     * Takes a buffer from the packet buffer pool, the buffer returns to the pool with its capacity once the last
+     * reference to it is gone.
+     */
+    static std::shared_ptr<std::vector<uint8_t>> AllocateBuffer();
 
     uint8_t* GetData();
     int32_t GetCommand() const;
 
     void Clear();
-    bool CommandRequiresAuth();
+    bool CommandRequiresAuth() const;
 
     const uint8_t* Read(size_t size);
     const utf8* ReadString();
@@ -69,6 +69,7 @@ enum NETWORK_COMMAND
     NETWORK_COMMAND_REQUEST_GAMESTATE,
     NETWORK_COMMAND_GAMESTATE,
     NETWORK_COMMAND_SCRIPTS,
+    NETWORK_COMMAND_PACKED_OBJECTS,
     NETWORK_COMMAND_MAX,
     NETWORK_COMMAND_INVALID = -1
 };
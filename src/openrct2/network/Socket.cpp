@@ -9,6 +9,7 @@
 
 #ifndef DISABLE_NETWORK
 
+#    include <algorithm>
 #    include <atomic>
 #    include <chrono>
 #    include <cmath>
@@ -46,6 +47,11 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+        #include <unistd.h>
+    #endif // defined(__linux__)
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -65,6 +71,9 @@
 
 constexpr auto CONNECT_TIMEOUT = std::chrono::milliseconds(3000);
 
+// Number of buffers passed to a single vectored send, well below IOV_MAX on all platforms.
+constexpr size_t MAX_SEND_BUFFERS = 64;
+
 #    ifdef _WIN32
 static bool _wsaInitialised = false;
 #    endif
@@ -209,6 +218,11 @@ private:
 public:
     TcpSocket() = default;
 
+    SOCKET GetSocket() const
+    {
+        return _socket;
+    }
+
     ~TcpSocket() override
     {
         if (_connectFuture.valid())
@@ -492,6 +506,63 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketBuffer* buffers, size_t count) override
+    {
+        if (_status != SOCKET_STATUS_CONNECTED)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        size_t totalSent = 0;
+        while (count > 0)
+        {
+            const size_t batchCount = std::min(count, MAX_SEND_BUFFERS);
+            size_t batchSize = 0;
+#    ifdef _WIN32
+            WSABUF wsaBuffers[MAX_SEND_BUFFERS];
+            for (size_t i = 0; i < batchCount; i++)
+            {
+                wsaBuffers[i].buf = const_cast<char*>(static_cast<const char*>(buffers[i].Data));
+                wsaBuffers[i].len = static_cast<ULONG>(buffers[i].Size);
+                batchSize += buffers[i].Size;
+            }
+
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, wsaBuffers, static_cast<DWORD>(batchCount), &sentBytes, 0, nullptr, nullptr)
+                == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            iovec iov[MAX_SEND_BUFFERS];
+            for (size_t i = 0; i < batchCount; i++)
+            {
+                iov[i].iov_base = const_cast<void*>(buffers[i].Data);
+                iov[i].iov_len = buffers[i].Size;
+                batchSize += buffers[i].Size;
+            }
+
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(batchCount);
+            ssize_t sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            totalSent += static_cast<size_t>(sentBytes);
+            if (static_cast<size_t>(sentBytes) < batchSize)
+            {
+                // Send buffer is full, the caller retries with the remaining data later.
+                return totalSent;
+            }
+            buffers += batchCount;
+            count -= batchCount;
+        }
+        return totalSent;
+    }
+
     NETWORK_READPACKET ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SOCKET_STATUS_CONNECTED)
@@ -850,6 +921,135 @@ std::unique_ptr<IUdpSocket> CreateUdpSocket()
     return std::make_unique<UdpSocket>();
 }
 
+/**
+ * Used where readiness can not be queried, reports nothing so that every socket is polled.
+ */
+class PollingSocketPoller final : public ISocketPoller
+{
+public:
+    bool IsEventDriven() const override
+    {
+        return false;
+    }
+
+    void Add(ITcpSocket* socket) override
+    {
+    }
+
+    void Remove(ITcpSocket* socket) override
+    {
+    }
+
+    void SetWriteInterest(ITcpSocket* socket, bool enabled) override
+    {
+    }
+
+    void Poll(std::vector<SocketReadiness>& events, int32_t timeoutMs) override
+    {
+        events.clear();
+    }
+};
+
+#    if defined(__linux__)
+class EpollSocketPoller final : public ISocketPoller
+{
+private:
+    static constexpr size_t MAX_EVENTS = 256;
+
+    int32_t _epoll = -1;
+    epoll_event _events[MAX_EVENTS]{};
+
+public:
+    EpollSocketPoller()
+    {
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll == -1)
+        {
+            throw SocketException("Unable to create epoll instance.");
+        }
+    }
+
+    ~EpollSocketPoller() override
+    {
+        close(_epoll);
+    }
+
+    bool IsEventDriven() const override
+    {
+        return true;
+    }
+
+    void Add(ITcpSocket* socket) override
+    {
+        if (!Control(EPOLL_CTL_ADD, socket, EPOLLIN))
+        {
+            throw SocketException("Unable to watch socket.");
+        }
+    }
+
+    void Remove(ITcpSocket* socket) override
+    {
+        Control(EPOLL_CTL_DEL, socket, 0);
+    }
+
+    void SetWriteInterest(ITcpSocket* socket, bool enabled) override
+    {
+        Control(EPOLL_CTL_MOD, socket, enabled ? EPOLLIN | EPOLLOUT : EPOLLIN);
+    }
+
+    void Poll(std::vector<SocketReadiness>& events, int32_t timeoutMs) override
+    {
+        events.clear();
+
+        int32_t numEvents;
+        do
+        {
+            numEvents = epoll_wait(_epoll, _events, static_cast<int32_t>(MAX_EVENTS), timeoutMs);
+        } while (numEvents == -1 && errno == EINTR);
+
+        for (int32_t i = 0; i < numEvents; i++)
+        {
+            const uint32_t flags = _events[i].events;
+            SocketReadiness readiness;
+            readiness.Socket = static_cast<ITcpSocket*>(_events[i].data.ptr);
+            readiness.Readable = (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+            readiness.Writable = (flags & (EPOLLOUT | EPOLLERR)) != 0;
+            events.push_back(readiness);
+        }
+    }
+
+private:
+    bool Control(int32_t operation, ITcpSocket* socket, uint32_t flags)
+    {
+        auto tcpSocket = dynamic_cast<TcpSocket*>(socket);
+        if (tcpSocket == nullptr)
+        {
+            throw std::invalid_argument("socket is not compatible.");
+        }
+
+        epoll_event event{};
+        event.events = flags;
+        event.data.ptr = socket;
+        return epoll_ctl(_epoll, operation, tcpSocket->GetSocket(), &event) == 0;
+    }
+};
+#    endif // defined(__linux__)
+
+std::unique_ptr<ISocketPoller> CreateSocketPoller()
+{
+#    if defined(__linux__)
+    try
+    {
+        return std::make_unique<EpollSocketPoller>();
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("%s Falling back to polling every socket.", e.what());
+    }
+#    endif
+    return std::make_unique<PollingSocketPoller>();
+}
+
 #    ifdef _WIN32
 static std::vector<INTERFACE_INFO> GetNetworkInterfaces()
 {
@@ -32,6 +32,15 @@ enum NETWORK_READPACKET
     NETWORK_READPACKET_DISCONNECTED
 };
 
+/**
+ * A block of memory sent as part of a vectored write.
+ */
+struct SocketBuffer
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents an address and port.
  */
@@ -65,6 +74,13 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+
+    /**
+     * Sends the buffers in order using as few system calls as possible. Returns the number of bytes sent, which is
+     * less than the total size of the buffers if the socket would block.
+     */
+    virtual size_t SendData(const SocketBuffer* buffers, size_t count) abstract;
+
     virtual NETWORK_READPACKET ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void Disconnect() abstract;
@@ -94,10 +110,52 @@ public:
     virtual void Close() abstract;
 };
 
+/**
+ * A socket reported by ISocketPoller as ready.
+ */
+struct SocketReadiness
+{
+    ITcpSocket* Socket;
+    bool Readable; // Also set when the connection was closed or failed
+    bool Writable;
+};
+
+/**
+ * Reports which TCP sockets can be read from or written to without blocking, so that idle sockets do not need to
+ * be polled individually.
+ */
+interface ISocketPoller
+{
+    virtual ~ISocketPoller() = default;
+
+    /**
+     * Returns false when readiness is not tracked on this platform, every socket has to be treated as ready then.
+     */
+    virtual bool IsEventDriven() const abstract;
+
+    /**
+     * Watches the socket for incoming data, or incoming connections for listening sockets. Sockets have to be
+     * removed again before they are closed.
+     */
+    virtual void Add(ITcpSocket * socket) abstract;
+    virtual void Remove(ITcpSocket * socket) abstract;
+
+    /**
+     * Watches the socket for free space in its send buffer, only enable this while sending would block.
+     */
+    virtual void SetWriteInterest(ITcpSocket * socket, bool enabled) abstract;
+
+    /**
+     * Replaces the contents of events with the sockets that are ready, waits at most timeoutMs for one.
+     */
+    virtual void Poll(std::vector<SocketReadiness> & events, int32_t timeoutMs) abstract;
+};
+
 bool InitialiseWSA();
 void DisposeWSA();
 std::unique_ptr<ITcpSocket> CreateTcpSocket();
 std::unique_ptr<IUdpSocket> CreateUdpSocket();
+std::unique_ptr<ISocketPoller> CreateSocketPoller();
 std::vector<std::unique_ptr<INetworkEndpoint>> GetBroadcastAddresses();
 
 namespace Convert
@@ -12,8 +12,10 @@
 #include "../Context.h"
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
+#include "../core/JobPool.hpp"
 #include "../core/Memory.hpp"
 #include "../localisation/StringIds.h"
+#include "../paint/TilePaintCache.h"
 #include "FootpathItemObject.h"
 #include "LargeSceneryObject.h"
 #include "Object.h"
@@ -28,7 +30,6 @@
 #include <array>
 #include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_set>
 
 class ObjectManager final : public IObjectManager
@@ -124,6 +125,7 @@ public:
                         _loadedObjects[slot] = loadedObject;
                         UpdateSceneryGroupIndexes();
                         ResetTypeToRideEntryIndexMap();
+                        OpenRCT2::Paint::TilePaintCache::Get().Clear();
                     }
                 }
             }
@@ -144,6 +146,7 @@ public:
         LoadDefaultObjects();
         UpdateSceneryGroupIndexes();
         ResetTypeToRideEntryIndexMap();
+        OpenRCT2::Paint::TilePaintCache::Get().Clear();
         log_verbose("%u / %u new objects loaded", numNewLoadedObjects, requiredObjects.size());
     }
 
@@ -173,6 +176,7 @@ public:
         {
             UpdateSceneryGroupIndexes();
             ResetTypeToRideEntryIndexMap();
+            OpenRCT2::Paint::TilePaintCache::Get().Clear();
         }
     }
 
@@ -184,6 +188,7 @@ public:
         }
         UpdateSceneryGroupIndexes();
         ResetTypeToRideEntryIndexMap();
+        OpenRCT2::Paint::TilePaintCache::Get().Clear();
     }
 
     void ResetObjects() override
@@ -198,6 +203,7 @@ public:
         }
         UpdateSceneryGroupIndexes();
         ResetTypeToRideEntryIndexMap();
+        OpenRCT2::Paint::TilePaintCache::Get().Clear();
     }
 
     std::vector<const ObjectRepositoryItem*> GetPackableObjects() override
@@ -556,26 +562,7 @@ private:
 
     template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
     {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
-        {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
+        JobPool::Get().ParallelFor(0, items.size(), 1, func);
     }
 
     std::vector<Object*> LoadObjects(std::vector<const ObjectRepositoryItem*>& requiredObjects, size_t* outNewObjectsLoaded)
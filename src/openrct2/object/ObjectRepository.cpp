@@ -373,21 +373,7 @@ public:
 
     void WritePackedObjects(IStream* stream, std::vector<const ObjectRepositoryItem*>& objects) override
     {
-        log_verbose("packing %u objects", objects.size());
-        for (const auto& object : objects)
-        {
-            Guard::ArgumentNotNull(object);
-
-            log_verbose("exporting object %.8s", object->ObjectEntry.name);
-            if (IsObjectCustom(object))
-            {
-                WritePackedObject(stream, &object->ObjectEntry);
-            }
-            else
-            {
-                log_warning("Refusing to pack vanilla/expansion object \"%s\"", object->ObjectEntry.name);
-            }
-        }
+        ::WritePackedObjects(stream, objects);
     }
 
 private:
@@ -612,30 +598,6 @@ private:
         // Convert to UTF-8 filename
         return String::Convert(normalisedName, CODE_PAGE::CP_1252, CODE_PAGE::CP_UTF8);
     }
-
-    void WritePackedObject(IStream* stream, const rct_object_entry* entry)
-    {
-        const ObjectRepositoryItem* item = FindObject(entry);
-        if (item == nullptr)
-        {
-            throw std::runtime_error(String::StdFormat("Unable to find object '%.8s'", entry->name));
-        }
-
-        // Read object data from file
-        auto fs = FileStream(item->Path, FILE_MODE_OPEN);
-        auto fileEntry = fs.ReadValue<rct_object_entry>();
-        if (!object_entry_compare(entry, &fileEntry))
-        {
-            throw std::runtime_error("Header found in object file does not match object to pack.");
-        }
-        auto chunkReader = SawyerChunkReader(&fs);
-        auto chunk = chunkReader.ReadChunk();
-
-        // Write object data to stream
-        auto chunkWriter = SawyerChunkWriter(stream);
-        stream->WriteValue(*entry);
-        chunkWriter.WriteChunk(chunk.get());
-    }
 };
 
 std::unique_ptr<IObjectRepository> CreateObjectRepository(const std::shared_ptr<IPlatformEnvironment>& env)
@@ -667,6 +629,43 @@ bool IsObjectCustom(const ObjectRepositoryItem* object)
     }
 }
 
+static void WritePackedObject(IStream* stream, const ObjectRepositoryItem* item)
+{
+    // Read object data from file
+    auto fs = FileStream(item->Path, FILE_MODE_OPEN);
+    auto fileEntry = fs.ReadValue<rct_object_entry>();
+    if (!object_entry_compare(&item->ObjectEntry, &fileEntry))
+    {
+        throw std::runtime_error("Header found in object file does not match object to pack.");
+    }
+    auto chunkReader = SawyerChunkReader(&fs);
+    auto chunk = chunkReader.ReadChunk();
+
+    // Write object data to stream
+    auto chunkWriter = SawyerChunkWriter(stream);
+    stream->WriteValue(item->ObjectEntry);
+    chunkWriter.WriteChunk(chunk.get());
+}
+
+void WritePackedObjects(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects)
+{
+    log_verbose("packing %u objects", objects.size());
+    for (const auto& object : objects)
+    {
+        Guard::ArgumentNotNull(object);
+
+        log_verbose("exporting object %.8s", object->ObjectEntry.name);
+        if (IsObjectCustom(object))
+        {
+            WritePackedObject(stream, object);
+        }
+        else
+        {
+            log_warning("Refusing to pack vanilla/expansion object \"%s\"", object->ObjectEntry.name);
+        }
+    }
+}
+
 const rct_object_entry* object_list_find(rct_object_entry* entry)
 {
     const rct_object_entry* result = nullptr;
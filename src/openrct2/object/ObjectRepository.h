@@ -85,6 +85,12 @@ std::unique_ptr<IObjectRepository> CreateObjectRepository(const std::shared_ptr<
 
 bool IsObjectCustom(const ObjectRepositoryItem* object);
 
+/**
+ * Writes the custom objects in the packed format, reading them from their files. The repository is not used, so
+ * copies of the items can be written on another thread.
+ */
+void WritePackedObjects(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects);
+
 size_t object_repository_get_items_count();
 const ObjectRepositoryItem* object_repository_get_items();
 const ObjectRepositoryItem* object_repository_find_object_by_entry(const rct_object_entry* entry);
@@ -16,12 +16,14 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "TilePaintCache.h"
 #include "sprite/Paint.Sprite.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -56,6 +58,15 @@ static void paint_ps_image_with_bounding_boxes(
 static void paint_ps_image(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t imageId, int16_t x, int16_t y);
 static uint32_t paint_ps_colourify_image(uint32_t imageId, uint8_t spriteType, uint32_t viewFlags);
 
+static bool paint_session_has_free_entry(paint_session* session)
+{
+    if (session->NextFreePaintStruct < session->EndOfPaintStructArray)
+    {
+        return true;
+    }
+    return paint_session_grow(session);
+}
+
 static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struct* ps, int32_t positionHash)
 {
     uint32_t paintQuadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
@@ -73,7 +84,7 @@ static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struc
 static paint_struct* sub_9819_c(
     paint_session* session, uint32_t image_id, const CoordsXYZ& offset, CoordsXYZ boundBoxSize, CoordsXYZ boundBoxOffset)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (!paint_session_has_free_entry(session))
         return nullptr;
     auto g1 = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1 == nullptr)
@@ -313,11 +324,28 @@ template<> bool check_bounding_box<3>(const paint_struct_bound_box& initialBBox,
     return false;
 }
 
+/**
+ * Paint struct as seen by the sort, the bounding box is copied so that the comparisons walk over a small contiguous array
+ * instead of chasing the next pointers of the much larger paint structs.
+ */
+struct paint_sort_entry
+{
+    paint_struct_bound_box bounds;
+    uint8_t quadrant_flags;
+    paint_struct* ps;
+};
+
+struct paint_sort_scratch
+{
+    std::vector<paint_sort_entry> entries;
+    std::vector<paint_sort_entry> moved;
+};
+
 template<uint8_t _TRotation>
-static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
+static paint_struct* paint_arrange_structs_helper_rotation(
+    paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, paint_sort_scratch& scratch)
 {
     paint_struct* ps;
-    paint_struct* ps_temp;
     do
     {
         ps = ps_next;
@@ -329,7 +357,12 @@ static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next
     // Cache the last visited node so we don't have to walk the whole list again
     paint_struct* ps_cache = ps;
 
-    ps_temp = ps;
+    // Flag the nodes of both quadrants and gather the ones that are sorted, which are all nodes up to the first one
+    // flagged as bigger
+    auto& entries = scratch.entries;
+    entries.clear();
+    paint_struct* ps_end = nullptr;
+    bool gathering = true;
     do
     {
         ps = ps->next_quadrant_ps;
@@ -348,69 +381,88 @@ static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next
         {
             ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
         }
-    } while (ps->quadrant_index <= quadrantIndex + 1);
-    ps = ps_temp;
 
-    while (true)
-    {
-        while (true)
+        if (gathering && (ps->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER))
         {
-            ps_next = ps->next_quadrant_ps;
-            if (ps_next == nullptr)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
-                break;
-            ps = ps_next;
+            ps_end = ps;
+            gathering = false;
         }
+        if (gathering)
+        {
+            entries.push_back({ ps->bounds, ps->quadrant_flags, ps });
+        }
+    } while (ps->quadrant_index <= quadrantIndex + 1);
 
-        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
-        ps_temp = ps;
+    // Every node that is still flagged as identical is compared against all nodes after it that are flagged as next, each
+    // node that has to be drawn before it is moved in front of it, the last one found ends up first. The moved nodes are
+    // compared next. All moves of one node are done in a single pass rather than shifting the array for each of them.
+    auto& moved = scratch.moved;
+    const size_t count = entries.size();
+    size_t position = 0;
+    while (true)
+    {
+        while (position < count && !(entries[position].quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL))
+            position++;
+        if (position == count)
+            break;
 
-        const paint_struct_bound_box& initialBBox = ps_next->bounds;
+        entries[position].quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        const paint_struct_bound_box initialBBox = entries[position].bounds;
 
-        while (true)
+        // Nothing has to be written back until the first node to move is found
+        size_t i = position + 1;
+        while (i < count
+               && !((entries[i].quadrant_flags & PAINT_QUADRANT_FLAG_NEXT)
+                    && check_bounding_box<_TRotation>(initialBBox, entries[i].bounds)))
         {
-            ps = ps_next;
-            ps_next = ps_next->next_quadrant_ps;
-            if (ps_next == nullptr)
-                break;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                break;
-            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
-                continue;
-
-            const paint_struct_bound_box& currentBBox = ps_next->bounds;
-
-            const bool compareResult = check_bounding_box<_TRotation>(initialBBox, currentBBox);
+            i++;
+        }
 
-            if (compareResult)
+        moved.clear();
+        size_t numKept = i;
+        for (; i < count; i++)
+        {
+            if ((entries[i].quadrant_flags & PAINT_QUADRANT_FLAG_NEXT)
+                && check_bounding_box<_TRotation>(initialBBox, entries[i].bounds))
             {
-                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
-                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
-                ps_temp->next_quadrant_ps = ps_next;
-                ps_next->next_quadrant_ps = ps_temp2;
-                ps_next = ps;
+                moved.push_back(entries[i]);
+            }
+            else
+            {
+                entries[numKept++] = entries[i];
             }
         }
+        if (!moved.empty())
+        {
+            std::move_backward(entries.begin() + position, entries.begin() + numKept, entries.end());
+            std::reverse_copy(moved.begin(), moved.end(), entries.begin() + position);
+        }
+    }
 
-        ps = ps_temp;
+    ps = ps_cache;
+    for (const auto& entry : entries)
+    {
+        entry.ps->quadrant_flags = entry.quadrant_flags;
+        ps->next_quadrant_ps = entry.ps;
+        ps = entry.ps;
     }
+    ps->next_quadrant_ps = ps_end;
+    return ps_cache;
 }
 
-static paint_struct* paint_arrange_structs_helper(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
+static paint_struct* paint_arrange_structs_helper(
+    paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation, paint_sort_scratch& scratch)
 {
     switch (rotation)
     {
         case 0:
-            return paint_arrange_structs_helper_rotation<0>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation<0>(ps_next, quadrantIndex, flag, scratch);
         case 1:
-            return paint_arrange_structs_helper_rotation<1>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation<1>(ps_next, quadrantIndex, flag, scratch);
         case 2:
-            return paint_arrange_structs_helper_rotation<2>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation<2>(ps_next, quadrantIndex, flag, scratch);
         case 3:
-            return paint_arrange_structs_helper_rotation<3>(ps_next, quadrantIndex, flag);
+            return paint_arrange_structs_helper_rotation<3>(ps_next, quadrantIndex, flag, scratch);
     }
     return nullptr;
 }
@@ -444,13 +496,16 @@ void paint_session_arrange(paint_session* session)
             }
         } while (++quadrantIndex <= session->QuadrantFrontIndex);
 
+        // Sessions are arranged on the paint worker threads, each of them keeps its own scratch space
+        static thread_local paint_sort_scratch scratch;
+
         paint_struct* ps_cache = paint_arrange_structs_helper(
-            psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation);
+            psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation, scratch);
 
         quadrantIndex = session->QuadrantBackIndex;
         while (++quadrantIndex < session->QuadrantFrontIndex)
         {
-            ps_cache = paint_arrange_structs_helper(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation);
+            ps_cache = paint_arrange_structs_helper(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation, scratch);
         }
     }
 }
@@ -698,6 +753,44 @@ void paint_session_free([[maybe_unused]] paint_session* session)
     GetContext()->GetPainter()->ReleaseSession(session);
 }
 
+/**
+ * Slow path for when the current chunk of paint entries is used up, takes a new chunk from the painter.
+ * @return false if the session has reached its chunk limit.
+ */
+bool paint_session_grow(paint_session* session)
+{
+    if (session->NumPaintEntryChunks >= PAINT_ENTRY_MAX_CHUNKS_PER_SESSION)
+    {
+        return false;
+    }
+
+    auto chunk = GetContext()->GetPainter()->AllocatePaintEntryChunk();
+    chunk->Next = nullptr;
+    if (session->CurrentPaintEntryChunk == nullptr)
+    {
+        session->PaintEntryChunks = chunk;
+    }
+    else
+    {
+        session->CurrentPaintEntryChunk->Next = chunk;
+    }
+    session->CurrentPaintEntryChunk = chunk;
+    session->NumPaintEntryChunks++;
+    session->NextFreePaintStruct = chunk->Entries;
+    session->EndOfPaintStructArray = chunk->Entries + std::size(chunk->Entries);
+    return true;
+}
+
+size_t paint_session_get_entry_count(const paint_session* session)
+{
+    if (session->CurrentPaintEntryChunk == nullptr)
+    {
+        return 0;
+    }
+    return (session->NumPaintEntryChunks - 1) * PAINT_ENTRY_CHUNK_SIZE
+        + static_cast<size_t>(session->NextFreePaintStruct - session->CurrentPaintEntryChunk->Entries);
+}
+
 /**
  *  rct2: 0x006861AC, 0x00686337, 0x006864D0, 0x0068666B, 0x0098196C
  *
@@ -717,10 +810,17 @@ paint_struct* sub_98196C(
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(
+            *session, Paint::TilePaintCommandType::Sub98196C, image_id, { x_offset, y_offset, z_offset },
+            { bound_box_length_x, bound_box_length_y, bound_box_length_z });
+    }
+
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (!paint_session_has_free_entry(session))
     {
         return nullptr;
     }
@@ -865,6 +965,14 @@ paint_struct* sub_98197C(
     int16_t bound_box_length_y, int8_t bound_box_length_z, int16_t z_offset, int16_t bound_box_offset_x,
     int16_t bound_box_offset_y, int16_t bound_box_offset_z)
 {
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(
+            *session, Paint::TilePaintCommandType::Sub98197C, image_id, { x_offset, y_offset, z_offset },
+            { bound_box_length_x, bound_box_length_y, bound_box_length_z },
+            { bound_box_offset_x, bound_box_offset_y, bound_box_offset_z });
+    }
+
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
@@ -926,6 +1034,14 @@ paint_struct* sub_98198C(
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(
+            *session, Paint::TilePaintCommandType::Sub98198C, image_id, { x_offset, y_offset, z_offset },
+            { bound_box_length_x, bound_box_length_y, bound_box_length_z },
+            { bound_box_offset_x, bound_box_offset_y, bound_box_offset_z });
+    }
+
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
@@ -968,6 +1084,14 @@ paint_struct* sub_98199C(
     assert(static_cast<uint16_t>(bound_box_length_x) == static_cast<int16_t>(bound_box_length_x));
     assert(static_cast<uint16_t>(bound_box_length_y) == static_cast<int16_t>(bound_box_length_y));
 
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(
+            *session, Paint::TilePaintCommandType::Sub98199C, image_id, { x_offset, y_offset, z_offset },
+            { bound_box_length_x, bound_box_length_y, bound_box_length_z },
+            { bound_box_offset_x, bound_box_offset_y, bound_box_offset_z });
+    }
+
     if (session->LastRootPS == nullptr)
     {
         return sub_98197C(
@@ -1003,12 +1127,17 @@ paint_struct* sub_98199C(
  */
 bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id, uint16_t x, uint16_t y)
 {
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(*session, Paint::TilePaintCommandType::AttachToPreviousAttach, image_id, { x, y, 0 });
+    }
+
     if (session->UnkF1AD2C == nullptr)
     {
         return paint_attach_to_previous_ps(session, image_id, x, y);
     }
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (!paint_session_has_free_entry(session))
     {
         return false;
     }
@@ -1040,7 +1169,12 @@ bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id,
  */
 bool paint_attach_to_previous_ps(paint_session* session, uint32_t image_id, uint16_t x, uint16_t y)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (session->Recorder != nullptr)
+    {
+        session->Recorder->Record(*session, Paint::TilePaintCommandType::AttachToPreviousPS, image_id, { x, y, 0 });
+    }
+
+    if (!paint_session_has_free_entry(session))
     {
         return false;
     }
@@ -1083,7 +1217,7 @@ void paint_floating_money_effect(
     paint_session* session, money32 amount, rct_string_id string_id, int16_t y, int16_t z, int8_t y_offsets[], int16_t offset_x,
     uint32_t rotation)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    if (!paint_session_has_free_entry(session))
     {
         return;
     }
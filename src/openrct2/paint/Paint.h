@@ -14,8 +14,15 @@
 #include "../interface/Colour.h"
 #include "../world/Location.hpp"
 
+#include <vector>
+
 struct TileElement;
 
+namespace OpenRCT2::Paint
+{
+    class TilePaintRecorder;
+}
+
 #pragma pack(push, 1)
 /* size 0x12 */
 struct attached_paint_struct
@@ -133,10 +140,23 @@ struct tunnel_entry
 #define MAX_PAINT_QUADRANTS 512
 #define TUNNEL_MAX_COUNT 65
 
+// Paint entries are handed out in chunks, a session takes another chunk from the painter when it runs out.
+constexpr size_t PAINT_ENTRY_CHUNK_SIZE = 512;
+// Upper bound for a single session so that a runaway paint function can not exhaust memory.
+constexpr size_t PAINT_ENTRY_MAX_CHUNKS_PER_SESSION = 128;
+
+struct PaintEntryChunk
+{
+    PaintEntryChunk* Next;
+    paint_entry Entries[PAINT_ENTRY_CHUNK_SIZE];
+};
+
 struct paint_session
 {
     rct_drawpixelinfo DPI;
-    paint_entry PaintStructs[4000];
+    PaintEntryChunk* PaintEntryChunks;
+    PaintEntryChunk* CurrentPaintEntryChunk;
+    uint32_t NumPaintEntryChunks;
     paint_struct* Quadrants[MAX_PAINT_QUADRANTS];
     paint_struct PaintHead;
     uint32_t ViewFlags;
@@ -168,6 +188,18 @@ struct paint_session
     uint8_t Unk141E9DB;
     uint16_t WaterHeight;
     uint32_t TrackColours[4];
+    // Set while the tile paint cache records the paint calls made for a tile
+    OpenRCT2::Paint::TilePaintRecorder* Recorder;
+};
+
+/**
+ * Copy of a paint session with its paint entry chunks flattened into a single array. Pointers to paint structs are
+ * stored as indices into Entries, with Entries.size() representing nullptr. Used to extract sessions for benchmarks.
+ */
+struct RecordedPaintSession
+{
+    paint_session Session;
+    std::vector<paint_entry> Entries;
 };
 
 extern paint_session gPaintSession;
@@ -222,6 +254,8 @@ void paint_floating_money_effect(
 
 paint_session* paint_session_alloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void paint_session_free(paint_session* session);
+bool paint_session_grow(paint_session* session);
+size_t paint_session_get_entry_count(const paint_session* session);
 void paint_session_generate(paint_session* session);
 void paint_session_arrange(paint_session* session);
 void paint_draw_structs(paint_session* session);
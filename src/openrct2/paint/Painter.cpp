@@ -14,6 +14,7 @@
 #include "../OpenRCT2.h"
 #include "../ReplayManager.h"
 #include "../config/Config.h"
+#include "../core/Profiler.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
 #include "../interface/Chat.h"
@@ -24,6 +25,8 @@
 #include "../title/TitleScreen.h"
 #include "../ui/UiContext.h"
 
+#include <algorithm>
+
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Paint;
@@ -36,6 +39,8 @@ Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
 
 void Painter::Paint(IDrawingEngine& de)
 {
+    PROFILE_SCOPE(Paint);
+
     auto dpi = de.GetDrawingPixelInfo();
     if (gIntroState != INTRO_STATE_NONE)
     {
@@ -69,6 +74,14 @@ void Painter::Paint(IDrawingEngine& de)
     else if (replayManager->IsNormalising())
         text = "Normalising...";
 
+    char autosaveText[32];
+    auto autosaveProgress = game_autosave_get_progress();
+    if (text == nullptr && autosaveProgress >= 0)
+    {
+        snprintf(autosaveText, sizeof(autosaveText), "Autosaving... %d%%", autosaveProgress);
+        text = autosaveText;
+    }
+
     if (text != nullptr)
         PaintReplayNotice(dpi, text);
 
@@ -76,7 +89,20 @@ void Painter::Paint(IDrawingEngine& de)
     {
         PaintFPS(dpi);
     }
+#ifndef DISABLE_PROFILER
+    if (Profiling::IsOverlayVisible())
+    {
+        PaintProfiler(dpi);
+    }
+#endif
     gCurrentDrawCount++;
+
+    {
+        std::lock_guard<std::mutex> lock(_paintEntryChunkMutex);
+        _frameStatistics.ChunksAllocated = static_cast<uint32_t>(_paintEntryChunkPool.size());
+        _lastFrameStatistics = _frameStatistics;
+        _frameStatistics = {};
+    }
 }
 
 void Painter::PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text)
@@ -127,6 +153,49 @@ void Painter::PaintFPS(rct_drawpixelinfo* dpi)
     gfx_set_dirty_blocks(screenCoords.x - 16, screenCoords.y - 4, gLastDrawStringX + 16, 16);
 }
 
+void Painter::PaintProfiler(rct_drawpixelinfo* dpi)
+{
+    // Right of the FPS counter, one line per section.
+    ScreenCoordsXY screenCoords(_uiContext->GetWidth() / 2 + 32, 2);
+    for (size_t i = 0; i < static_cast<size_t>(Profiling::ProfileSection::Count); i++)
+    {
+        auto stats = Profiling::GetStats(static_cast<Profiling::ProfileSection>(i));
+
+        utf8 buffer[128] = { 0 };
+        utf8* ch = buffer;
+        ch = utf8_write_codepoint(ch, FORMAT_MEDIUMFONT);
+        ch = utf8_write_codepoint(ch, FORMAT_OUTLINE);
+        ch = utf8_write_codepoint(ch, FORMAT_WHITE);
+
+        snprintf(
+            ch, 128 - (ch - buffer), "%s: %.2f ms avg, %.2f p95, %.2f max", stats.Name, stats.Mean, stats.P95, stats.Max);
+
+        gfx_draw_string(dpi, buffer, 0, screenCoords);
+
+        // Make area dirty so the text doesn't get drawn over the last
+        gfx_set_dirty_blocks(screenCoords.x - 16, screenCoords.y - 4, gLastDrawStringX + 16, screenCoords.y + 16);
+        screenCoords.y += 12;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(Profiling::ProfileCounter::Count); i++)
+    {
+        auto counter = static_cast<Profiling::ProfileCounter>(i);
+
+        utf8 buffer[128] = { 0 };
+        utf8* ch = buffer;
+        ch = utf8_write_codepoint(ch, FORMAT_MEDIUMFONT);
+        ch = utf8_write_codepoint(ch, FORMAT_OUTLINE);
+        ch = utf8_write_codepoint(ch, FORMAT_WHITE);
+
+        snprintf(
+            ch, 128 - (ch - buffer), "%s: %llu", Profiling::GetCounterName(counter),
+            static_cast<unsigned long long>(Profiling::GetCounter(counter)));
+
+        gfx_draw_string(dpi, buffer, 0, screenCoords);
+        gfx_set_dirty_blocks(screenCoords.x - 16, screenCoords.y - 4, gLastDrawStringX + 16, screenCoords.y + 16);
+        screenCoords.y += 12;
+    }
+}
+
 void Painter::MeasureFPS()
 {
     _frames++;
@@ -161,8 +230,11 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     }
 
     session->DPI = *dpi;
-    session->EndOfPaintStructArray = &session->PaintStructs[4000 - 1];
-    session->NextFreePaintStruct = session->PaintStructs;
+    session->PaintEntryChunks = nullptr;
+    session->CurrentPaintEntryChunk = nullptr;
+    session->NumPaintEntryChunks = 0;
+    session->EndOfPaintStructArray = nullptr;
+    session->NextFreePaintStruct = nullptr;
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
     session->ViewFlags = viewFlags;
@@ -177,11 +249,48 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->Recorder = nullptr;
 
     return session;
 }
 
 void Painter::ReleaseSession(paint_session* session)
 {
+    {
+        std::lock_guard<std::mutex> lock(_paintEntryChunkMutex);
+
+        auto numEntries = static_cast<uint32_t>(paint_session_get_entry_count(session));
+        _frameStatistics.Sessions++;
+        _frameStatistics.PaintEntries += numEntries;
+        _frameStatistics.MaxSessionPaintEntries = std::max(_frameStatistics.MaxSessionPaintEntries, numEntries);
+        _frameStatistics.ChunksUsed += session->NumPaintEntryChunks;
+        if (session->NumPaintEntryChunks >= PAINT_ENTRY_MAX_CHUNKS_PER_SESSION)
+        {
+            _frameStatistics.SessionsAtChunkLimit++;
+        }
+
+        for (auto chunk = session->PaintEntryChunks; chunk != nullptr; chunk = chunk->Next)
+        {
+            _freePaintEntryChunks.push_back(chunk);
+        }
+    }
+    session->PaintEntryChunks = nullptr;
+    session->CurrentPaintEntryChunk = nullptr;
+    session->NumPaintEntryChunks = 0;
+
     _freePaintSessions.push_back(session);
 }
+
+PaintEntryChunk* Painter::AllocatePaintEntryChunk()
+{
+    std::lock_guard<std::mutex> lock(_paintEntryChunkMutex);
+    if (!_freePaintEntryChunks.empty())
+    {
+        auto chunk = _freePaintEntryChunks.back();
+        _freePaintEntryChunks.pop_back();
+        return chunk;
+    }
+
+    _paintEntryChunkPool.emplace_back(std::make_unique<PaintEntryChunk>());
+    return _paintEntryChunkPool.back().get();
+}
@@ -14,6 +14,7 @@
 
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 struct rct_drawpixelinfo;
@@ -32,12 +33,27 @@ namespace OpenRCT2
 
     namespace Paint
     {
+        struct PaintStatistics
+        {
+            uint32_t Sessions;
+            uint32_t PaintEntries;
+            uint32_t MaxSessionPaintEntries;
+            uint32_t ChunksUsed;
+            uint32_t ChunksAllocated;
+            uint32_t SessionsAtChunkLimit;
+        };
+
         interface Painter final
         {
         private:
             std::shared_ptr<Ui::IUiContext> const _uiContext;
             std::vector<std::unique_ptr<paint_session>> _paintSessionPool;
             std::vector<paint_session*> _freePaintSessions;
+            std::mutex _paintEntryChunkMutex;
+            std::vector<std::unique_ptr<PaintEntryChunk>> _paintEntryChunkPool;
+            std::vector<PaintEntryChunk*> _freePaintEntryChunks;
+            PaintStatistics _frameStatistics{};
+            PaintStatistics _lastFrameStatistics{};
             time_t _lastSecond = 0;
             int32_t _currentFPS = 0;
             int32_t _frames = 0;
@@ -49,9 +65,24 @@ namespace OpenRCT2
             paint_session* CreateSession(rct_drawpixelinfo * dpi, uint32_t viewFlags);
             void ReleaseSession(paint_session * session);
 
+            /**
+             * Hands out a chunk of paint entries, chunks are recycled when their session is released.
+             * Safe to call from the paint job threads.
+             */
+            PaintEntryChunk* AllocatePaintEntryChunk();
+
+            /**
+             * Paint entry usage of the last completed frame.
+             */
+            const PaintStatistics& GetLastFrameStatistics() const
+            {
+                return _lastFrameStatistics;
+            }
+
         private:
             void PaintReplayNotice(rct_drawpixelinfo * dpi, const char* text);
             void PaintFPS(rct_drawpixelinfo * dpi);
+            void PaintProfiler(rct_drawpixelinfo * dpi);
             void MeasureFPS();
         };
     } // namespace Paint
@@ -0,0 +1,493 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TilePaintCache.h"
+
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../core/Profiler.h"
+#include "../interface/Viewport.h"
+#include "../peep/Staff.h"
+#include "../ride/TrackDesign.h"
+#include "../sprites.h"
+#include "../world/Banner.h"
+#include "../world/Map.h"
+#include "../world/Scenery.h"
+#include "../world/SmallScenery.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace OpenRCT2::Paint;
+
+// Overlays that are drawn on top of the elements depending on the tools in use
+static constexpr uint32_t UncacheableViewFlags = VIEWPORT_FLAG_LAND_HEIGHTS | VIEWPORT_FLAG_TRACK_HEIGHTS
+    | VIEWPORT_FLAG_PATH_HEIGHTS | VIEWPORT_FLAG_LAND_OWNERSHIP | VIEWPORT_FLAG_CONSTRUCTION_RIGHTS
+    | VIEWPORT_FLAG_CLIP_VIEW | VIEWPORT_FLAG_HIGHLIGHT_PATH_ISSUES;
+
+static constexpr const CoordsXY NeighbourOffsets[] = {
+    { -COORDS_XY_STEP, 0 },
+    { 0, COORDS_XY_STEP },
+    { COORDS_XY_STEP, 0 },
+    { 0, -COORDS_XY_STEP },
+};
+
+static bool IsPrimaryCommand(TilePaintCommandType type)
+{
+    return type == TilePaintCommandType::Sub98196C || type == TilePaintCommandType::Sub98197C
+        || type == TilePaintCommandType::Sub98198C;
+}
+
+static bool IsAttachCommand(TilePaintCommandType type)
+{
+    return type == TilePaintCommandType::AttachToPreviousAttach || type == TilePaintCommandType::AttachToPreviousPS;
+}
+
+void TilePaintRecorder::Record(
+    const paint_session& session, TilePaintCommandType type, uint32_t imageId, const CoordsXYZ& offset,
+    const CoordsXYZ& boundBoxLength, const CoordsXYZ& boundBoxOffset)
+{
+    // The call a command delegates to is replayed as part of the command
+    if (_skipNext)
+    {
+        _skipNext = false;
+        return;
+    }
+
+    // The first command has to start a new root paint struct, otherwise it depends on what the previous tile painted
+    if (_commands.empty() && !IsPrimaryCommand(type))
+    {
+        _valid = false;
+    }
+
+    // The temporary and scrolling text images are replaced all the time
+    const uint32_t imageIndex = imageId & 0x7FFFF;
+    if (imageIndex == SPR_TEMP || (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END))
+    {
+        _valid = false;
+    }
+
+    TilePaintCommand command;
+    command.Type = type;
+    command.InteractionType = session.InteractionType;
+    command.ImageId = imageId;
+    command.Offset = offset;
+    command.BoundBoxLength = boundBoxLength;
+    command.BoundBoxOffset = boundBoxOffset;
+    command.SpritePosition = session.SpritePosition;
+    command.MapPosition = session.MapPosition;
+    command.CurrentlyDrawnItem = session.CurrentlyDrawnItem;
+    _commands.push_back(command);
+    _entries.push_back(session.NextFreePaintStruct);
+
+    _skipNext = (type == TilePaintCommandType::Sub98199C && session.LastRootPS == nullptr)
+        || (type == TilePaintCommandType::AttachToPreviousAttach && session.UnkF1AD2C == nullptr);
+}
+
+bool TilePaintRecorder::Finish(const paint_session& session, std::vector<TilePaintCommand>& commands)
+{
+    // A full chunk means some of the calls may have failed for the lack of entries
+    if (!_valid || session.NextFreePaintStruct >= session.EndOfPaintStructArray)
+        return false;
+
+    for (size_t i = 0; i < _commands.size(); i++)
+    {
+        const paint_entry* entry = _entries[i];
+        const paint_entry* nextEntry = i + 1 < _entries.size() ? _entries[i + 1] : session.NextFreePaintStruct;
+        if (nextEntry == entry)
+            continue;
+
+        auto& command = _commands[i];
+        if (IsAttachCommand(command.Type))
+        {
+            command.ResultFlags = entry->attached.flags;
+            command.ResultColour = entry->attached.colour_image_id;
+        }
+        else
+        {
+            command.ResultFlags = entry->basic.flags;
+            command.ResultColour = entry->basic.tertiary_colour;
+        }
+    }
+    commands = std::move(_commands);
+    return true;
+}
+
+bool TilePaintCache::Key::operator==(const Key& other) const
+{
+    return TileX == other.TileX && TileY == other.TileY && ViewFlags == other.ViewFlags && Rotation == other.Rotation
+        && ZoomLevel == other.ZoomLevel;
+}
+
+size_t TilePaintCache::KeyHash::operator()(const Key& key) const
+{
+    const uint64_t position = static_cast<uint64_t>(key.TileX & 0xFFFF) | (static_cast<uint64_t>(key.TileY & 0xFFFF) << 16)
+        | (static_cast<uint64_t>(key.Rotation) << 32) | (static_cast<uint64_t>(static_cast<uint8_t>(key.ZoomLevel)) << 40);
+    return std::hash<uint64_t>()(position ^ (static_cast<uint64_t>(key.ViewFlags) * 0x9E3779B97F4A7C15ULL));
+}
+
+size_t TilePaintCache::Recording::GetMemoryUsage() const
+{
+    size_t memoryUsage = sizeof(Recording) + Elements.capacity() * sizeof(TileElement)
+        + Commands.capacity() * sizeof(TilePaintCommand);
+#ifdef __ENABLE_LIGHTFX__
+    memoryUsage += Lights.capacity() * sizeof(lightfx_deferred_light);
+#endif
+    return memoryUsage;
+}
+
+TilePaintCache& TilePaintCache::Get()
+{
+    static TilePaintCache tilePaintCache;
+    return tilePaintCache;
+}
+
+TilePaintCache::TilePaintCache(size_t memoryBudget)
+    : _cache(memoryBudget)
+{
+}
+
+bool TilePaintCache::CanUseCache(const paint_session& session)
+{
+    if ((session.ViewFlags & UncacheableViewFlags) || session.WoodenSupportsPrependTo != nullptr)
+        return false;
+    if (gStaffDrawPatrolAreas != SPRITE_INDEX_NULL || gTrackDesignSaveMode || gPaintBlockedTiles || gPaintWidePathsAsGhost
+        || gShowSupportSegmentHeights)
+        return false;
+    if (gScreenFlags & (SCREEN_FLAGS_TRACK_DESIGNER | SCREEN_FLAGS_TRACK_MANAGER))
+        return false;
+
+    // The selection overlays are attached to the surfaces of the selected tiles only
+    const CoordsXY& pos = session.MapPosition;
+    if ((gMapSelectFlags & MAP_SELECT_FLAG_ENABLE) && pos.x >= gMapSelectPositionA.x && pos.x <= gMapSelectPositionB.x
+        && pos.y >= gMapSelectPositionA.y && pos.y <= gMapSelectPositionB.y)
+        return false;
+    if (gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_CONSTRUCT)
+    {
+        for (const auto& tile : gMapSelectionTiles)
+        {
+            if (tile.x == pos.x && tile.y == pos.y)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool TilePaintCache::AreElementsCacheable(const TileElement* firstElement)
+{
+    // Elements at height 0 would see the path and track elements found on the previous tile
+    if (firstElement->base_height == 0)
+        return false;
+
+    const TileElement* element = firstElement;
+    do
+    {
+        switch (element->GetType())
+        {
+            case TILE_ELEMENT_TYPE_SURFACE:
+                break;
+            case TILE_ELEMENT_TYPE_PATH:
+                if (element->AsPath()->HasQueueBanner())
+                    return false;
+                break;
+            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+            {
+                auto entry = element->AsSmallScenery()->GetEntry();
+                if (entry == nullptr || scenery_small_entry_has_flag(entry, SMALL_SCENERY_FLAG_ANIMATED))
+                    return false;
+                break;
+            }
+            case TILE_ELEMENT_TYPE_WALL:
+            {
+                auto entry = element->AsWall()->GetEntry();
+                if (entry == nullptr || (entry->wall.flags2 & WALL_SCENERY_2_ANIMATED)
+                    || entry->wall.scrolling_mode != SCROLLING_MODE_NONE)
+                    return false;
+                break;
+            }
+            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+            {
+                auto entry = element->AsLargeScenery()->GetEntry();
+                if (entry == nullptr || entry->large_scenery.scrolling_mode != SCROLLING_MODE_NONE
+                    || (entry->large_scenery.flags & (LARGE_SCENERY_FLAG_3D_TEXT | LARGE_SCENERY_FLAG_ANIMATED)))
+                    return false;
+                break;
+            }
+            default:
+                // Tracks, entrances and banners are animated or depend on rides
+                return false;
+        }
+    } while (!(element++)->IsLastForTile());
+    return true;
+}
+
+static TileElement GetNeighbourSurface(const CoordsXY& mapPosition, size_t index)
+{
+    TileElement surface{};
+    const CoordsXY position = mapPosition + NeighbourOffsets[index];
+    if (map_is_location_valid(position))
+    {
+        auto surfaceElement = map_get_surface_element_at(position);
+        if (surfaceElement != nullptr)
+        {
+            std::memcpy(&surface, surfaceElement, sizeof(TileElement));
+        }
+    }
+    return surface;
+}
+
+bool TilePaintCache::Matches(const Recording& recording, const CoordsXY& mapPosition, const TileElement* firstElement)
+{
+    if (recording.FirstElement != firstElement || recording.LandscapeSmoothing != gConfigGeneral.landscape_smoothing)
+        return false;
+#ifdef __ENABLE_LIGHTFX__
+    if (recording.LightFX != lightfx_is_available())
+        return false;
+#endif
+
+    const TileElement* element = firstElement;
+    for (const auto& recordedElement : recording.Elements)
+    {
+        if (std::memcmp(&recordedElement, element, sizeof(TileElement)) != 0)
+            return false;
+        element++;
+    }
+
+    for (size_t i = 0; i < std::size(NeighbourOffsets); i++)
+    {
+        const TileElement surface = GetNeighbourSurface(mapPosition, i);
+        if (std::memcmp(&surface, &recording.NeighbourSurfaces[i], sizeof(TileElement)) != 0)
+            return false;
+    }
+    return true;
+}
+
+std::shared_ptr<TilePaintCache::Recording> TilePaintCache::Record(
+    const paint_session& session, TileElement* firstElement, TileElementsPaintFunc paintElements)
+{
+    auto recording = std::make_shared<Recording>();
+    recording->FirstElement = firstElement;
+    recording->LandscapeSmoothing = gConfigGeneral.landscape_smoothing;
+    const TileElement* element = firstElement;
+    do
+    {
+        recording->Elements.push_back(*element);
+    } while (!(element++)->IsLastForTile());
+    for (size_t i = 0; i < std::size(NeighbourOffsets); i++)
+    {
+        recording->NeighbourSurfaces[i] = GetNeighbourSurface(session.MapPosition, i);
+    }
+
+    // The tile is painted in a copy of the session with its own paint entries, nothing is culled so that the commands
+    // can be replayed in any session.
+    struct RecordingSession
+    {
+        paint_session Session;
+        PaintEntryChunk Chunk;
+    };
+    static thread_local RecordingSession scratch;
+    paint_session& recordingSession = scratch.Session;
+    recordingSession = session;
+    recordingSession.DPI.x = -16384;
+    recordingSession.DPI.y = -16384;
+    recordingSession.DPI.width = 32767;
+    recordingSession.DPI.height = 32767;
+    recordingSession.PaintEntryChunks = &scratch.Chunk;
+    recordingSession.CurrentPaintEntryChunk = &scratch.Chunk;
+    recordingSession.NumPaintEntryChunks = PAINT_ENTRY_MAX_CHUNKS_PER_SESSION;
+    recordingSession.NextFreePaintStruct = scratch.Chunk.Entries;
+    recordingSession.EndOfPaintStructArray = scratch.Chunk.Entries + std::size(scratch.Chunk.Entries);
+    recordingSession.LastRootPS = nullptr;
+    recordingSession.UnkF1AD2C = nullptr;
+    recordingSession.PSStringHead = nullptr;
+    recordingSession.LastPSString = nullptr;
+
+    TilePaintRecorder recorder;
+    recordingSession.Recorder = &recorder;
+#ifdef __ENABLE_LIGHTFX__
+    // The lights are added again each time the recording is replayed
+    recording->LightFX = lightfx_is_available();
+    auto deferredLights = lightfx_get_deferred_lights();
+    lightfx_set_deferred_lights(&recording->Lights);
+#endif
+    const bool completed = paintElements(&recordingSession, firstElement) != nullptr;
+#ifdef __ENABLE_LIGHTFX__
+    lightfx_set_deferred_lights(deferredLights);
+    recording->Lights.shrink_to_fit();
+#endif
+    recordingSession.Recorder = nullptr;
+    if (!completed || recordingSession.PSStringHead != nullptr || recordingSession.WoodenSupportsPrependTo != nullptr)
+        return nullptr;
+    if (!recorder.Finish(recordingSession, recording->Commands))
+        return nullptr;
+    recording->Commands.shrink_to_fit();
+
+    auto& state = recording->State;
+    state.SpritePosition = recordingSession.SpritePosition;
+    state.MapPosition = recordingSession.MapPosition;
+    state.CurrentlyDrawnItem = recordingSession.CurrentlyDrawnItem;
+    state.SurfaceElement = recordingSession.SurfaceElement;
+    state.PathElementOnSameHeight = recordingSession.PathElementOnSameHeight;
+    state.TrackElementOnSameHeight = recordingSession.TrackElementOnSameHeight;
+    std::copy(
+        std::begin(recordingSession.SupportSegments), std::end(recordingSession.SupportSegments), state.SupportSegments);
+    state.Support = recordingSession.Support;
+    state.WaterHeight = recordingSession.WaterHeight;
+    state.InteractionType = recordingSession.InteractionType;
+    state.Unk141E9DB = recordingSession.Unk141E9DB;
+    state.VerticalTunnelHeight = recordingSession.VerticalTunnelHeight;
+    state.DidPassSurface = recordingSession.DidPassSurface;
+    return recording;
+}
+
+template<typename T> static void ApplyResult(T* ps, const TilePaintCommand& command)
+{
+    if (ps != nullptr)
+    {
+        ps->flags = command.ResultFlags;
+        ps->tertiary_colour = command.ResultColour;
+    }
+}
+
+void TilePaintCache::Replay(paint_session* session, const Recording& recording)
+{
+    for (const auto& command : recording.Commands)
+    {
+        session->SpritePosition = command.SpritePosition;
+        session->MapPosition = command.MapPosition;
+        session->CurrentlyDrawnItem = command.CurrentlyDrawnItem;
+        session->InteractionType = command.InteractionType;
+
+        const auto& offset = command.Offset;
+        const auto& length = command.BoundBoxLength;
+        const auto& boundBoxOffset = command.BoundBoxOffset;
+        switch (command.Type)
+        {
+            case TilePaintCommandType::Sub98196C:
+                ApplyResult(
+                    sub_98196C(session, command.ImageId, offset.x, offset.y, length.x, length.y, length.z, offset.z),
+                    command);
+                break;
+            case TilePaintCommandType::Sub98197C:
+                ApplyResult(
+                    sub_98197C(
+                        session, command.ImageId, offset.x, offset.y, length.x, length.y, length.z, offset.z,
+                        boundBoxOffset.x, boundBoxOffset.y, boundBoxOffset.z),
+                    command);
+                break;
+            case TilePaintCommandType::Sub98198C:
+                ApplyResult(
+                    sub_98198C(
+                        session, command.ImageId, offset.x, offset.y, length.x, length.y, length.z, offset.z,
+                        boundBoxOffset.x, boundBoxOffset.y, boundBoxOffset.z),
+                    command);
+                break;
+            case TilePaintCommandType::Sub98199C:
+                ApplyResult(
+                    sub_98199C(
+                        session, command.ImageId, offset.x, offset.y, length.x, length.y, length.z, offset.z,
+                        boundBoxOffset.x, boundBoxOffset.y, boundBoxOffset.z),
+                    command);
+                break;
+            case TilePaintCommandType::AttachToPreviousAttach:
+                if (paint_attach_to_previous_attach(session, command.ImageId, offset.x, offset.y))
+                {
+                    ApplyResult(session->UnkF1AD2C, command);
+                }
+                break;
+            case TilePaintCommandType::AttachToPreviousPS:
+                if (paint_attach_to_previous_ps(session, command.ImageId, offset.x, offset.y))
+                {
+                    ApplyResult(session->UnkF1AD2C, command);
+                }
+                break;
+        }
+    }
+
+#ifdef __ENABLE_LIGHTFX__
+    for (const auto& light : recording.Lights)
+    {
+        lightfx_add_3d_light(light.lightID, light.lightIDqualifier, light.x, light.y, light.z, light.lightType);
+    }
+#endif
+
+    const auto& state = recording.State;
+    session->SpritePosition = state.SpritePosition;
+    session->MapPosition = state.MapPosition;
+    session->CurrentlyDrawnItem = state.CurrentlyDrawnItem;
+    session->SurfaceElement = state.SurfaceElement;
+    session->PathElementOnSameHeight = state.PathElementOnSameHeight;
+    session->TrackElementOnSameHeight = state.TrackElementOnSameHeight;
+    std::copy(std::begin(state.SupportSegments), std::end(state.SupportSegments), session->SupportSegments);
+    session->Support = state.Support;
+    session->WaterHeight = state.WaterHeight;
+    session->InteractionType = state.InteractionType;
+    session->Unk141E9DB = state.Unk141E9DB;
+    session->VerticalTunnelHeight = state.VerticalTunnelHeight;
+    session->DidPassSurface = state.DidPassSurface;
+}
+
+bool TilePaintCache::Paint(paint_session* session, TileElement* firstElement, TileElementsPaintFunc paintElements)
+{
+    if (!CanUseCache(*session))
+        return false;
+
+    const Key key = {
+        session->MapPosition.x / COORDS_XY_STEP,
+        session->MapPosition.y / COORDS_XY_STEP,
+        session->ViewFlags,
+        session->CurrentRotation,
+        static_cast<int8_t>(session->DPI.zoom_level),
+    };
+
+    // The recording is compared against the tile by each painting thread on its own, a recording is never changed once
+    // it is in the cache.
+    auto recording = _cache.Find(key);
+    if (recording != nullptr && Matches(*recording, session->MapPosition, firstElement))
+    {
+        _cache.CountHit();
+        Profiling::IncrementCounter(Profiling::ProfileCounter::TilePaintCacheHits);
+        Replay(session, *recording);
+        return true;
+    }
+
+    // A recording that does not match is of a tile that has changed since it was recorded
+    Profiling::IncrementCounter(Profiling::ProfileCounter::TilePaintCacheMisses);
+    if (!_cache.CountMiss(key, recording))
+        return false;
+
+    if (!AreElementsCacheable(firstElement))
+        return false;
+
+    // Recording happens outside of the lock, if another thread records the same tile first one of the copies is dropped.
+    recording = Record(*session, firstElement, paintElements);
+    if (recording == nullptr)
+        return false;
+
+    _cache.Insert(key, recording);
+    Replay(session, *recording);
+    return true;
+}
+
+void TilePaintCache::Clear()
+{
+    _cache.Clear();
+}
+
+void TilePaintCache::SetMemoryBudget(size_t memoryBudget)
+{
+    _cache.SetMemoryBudget(memoryBudget);
+}
+
+OpenRCT2::CacheStats TilePaintCache::GetStats() const
+{
+    return _cache.GetStats();
+}
@@ -0,0 +1,173 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../core/BudgetedLruCache.hpp"
+#include "../drawing/LightFX.h"
+#include "../world/Location.hpp"
+#include "../world/TileElement.h"
+#include "Paint.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace OpenRCT2::Paint
+{
+    enum class TilePaintCommandType : uint8_t
+    {
+        Sub98196C,
+        Sub98197C,
+        Sub98198C,
+        Sub98199C,
+        AttachToPreviousAttach,
+        AttachToPreviousPS,
+    };
+
+    /**
+     * A call to one of the paint struct primitives along with the session state it reads. ResultFlags and ResultColour
+     * are the values the paint functions left in the struct the call created.
+     */
+    struct TilePaintCommand
+    {
+        TilePaintCommandType Type{};
+        uint8_t InteractionType{};
+        uint8_t ResultFlags{};
+        uint32_t ImageId{};
+        uint32_t ResultColour{};
+        CoordsXYZ Offset;
+        CoordsXYZ BoundBoxLength;
+        CoordsXYZ BoundBoxOffset;
+        CoordsXY SpritePosition;
+        CoordsXY MapPosition;
+        const void* CurrentlyDrawnItem{};
+    };
+
+    /**
+     * Collects the primitive calls made while the elements of a tile are painted, see paint_session::Recorder.
+     */
+    class TilePaintRecorder final
+    {
+    private:
+        std::vector<TilePaintCommand> _commands;
+        // Next free paint entry of the session at the time of each command
+        std::vector<const paint_entry*> _entries;
+        bool _skipNext{};
+        bool _valid = true;
+
+    public:
+        void Record(
+            const paint_session& session, TilePaintCommandType type, uint32_t imageId, const CoordsXYZ& offset,
+            const CoordsXYZ& boundBoxLength = {}, const CoordsXYZ& boundBoxOffset = {});
+
+        /**
+         * Fills in the results of the recorded commands.
+         * @return false if the commands can not be replayed.
+         */
+        bool Finish(const paint_session& session, std::vector<TilePaintCommand>& commands);
+    };
+
+    /**
+     * Paints the elements of a tile, returns nullptr if painting stopped at a corrupt element.
+     */
+    using TileElementsPaintFunc = TileElement* (*)(paint_session* session, TileElement* firstElement);
+
+    /**
+     * Cache of the paint struct primitive calls made for tiles that only hold static elements, such
+     * as terrain, paths, walls and scenery. A cached tile is painted by replaying the calls instead of running the
+     * element paint functions, the calls still cull against the session they are replayed in.
+     *
+     * A recording is only used while the elements of the tile and the surfaces of its neighbours are the same as when
+     * it was made, the cache has to be cleared when objects are loaded or unloaded.
+     */
+    class TilePaintCache final
+    {
+    private:
+        struct Key
+        {
+            int32_t TileX;
+            int32_t TileY;
+            uint32_t ViewFlags;
+            uint8_t Rotation;
+            int8_t ZoomLevel;
+
+            bool operator==(const Key& other) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct ExitState
+        {
+            CoordsXY SpritePosition;
+            CoordsXY MapPosition;
+            const void* CurrentlyDrawnItem;
+            const TileElement* SurfaceElement;
+            TileElement* PathElementOnSameHeight;
+            TileElement* TrackElementOnSameHeight;
+            support_height SupportSegments[9];
+            support_height Support;
+            uint16_t WaterHeight;
+            uint8_t InteractionType;
+            uint8_t Unk141E9DB;
+            uint8_t VerticalTunnelHeight;
+            bool DidPassSurface;
+        };
+
+        struct Recording
+        {
+            const TileElement* FirstElement{};
+            std::vector<TileElement> Elements;
+            // Surface paint draws the edges against the neighbouring surfaces, zeroed where there is no neighbour
+            std::array<TileElement, 4> NeighbourSurfaces{};
+            bool LandscapeSmoothing{};
+            std::vector<TilePaintCommand> Commands;
+            ExitState State{};
+#ifdef __ENABLE_LIGHTFX__
+            // Lights added by the element paint functions, such as the lamps on paths
+            bool LightFX{};
+            std::vector<lightfx_deferred_light> Lights;
+#endif
+
+            size_t GetMemoryUsage() const;
+        };
+
+        BudgetedLruCache<Key, Recording, KeyHash> _cache;
+
+    public:
+        static constexpr size_t DefaultMemoryBudget = 16 * 1024 * 1024;
+
+        static TilePaintCache& Get();
+
+        explicit TilePaintCache(size_t memoryBudget = DefaultMemoryBudget);
+
+        /**
+         * Paints the elements of the tile at session->MapPosition from a recording, recording them first if the tile
+         * has missed before.
+         * @return false if the tile has not been painted, the caller then has to run the element paint functions.
+         */
+        bool Paint(paint_session* session, TileElement* firstElement, TileElementsPaintFunc paintElements);
+
+        void Clear();
+        void SetMemoryBudget(size_t memoryBudget);
+        CacheStats GetStats() const;
+
+    private:
+        static bool CanUseCache(const paint_session& session);
+        static bool AreElementsCacheable(const TileElement* firstElement);
+        static bool Matches(const Recording& recording, const CoordsXY& mapPosition, const TileElement* firstElement);
+        static std::shared_ptr<Recording> Record(
+            const paint_session& session, TileElement* firstElement, TileElementsPaintFunc paintElements);
+        static void Replay(paint_session* session, const Recording& recording);
+    };
+} // namespace OpenRCT2::Paint
@@ -27,6 +27,7 @@
 #include "../../world/Surface.h"
 #include "../Paint.h"
 #include "../Supports.h"
+#include "../TilePaintCache.h"
 #include "../VirtualFloor.h"
 #include "Paint.Surface.h"
 
@@ -37,7 +38,8 @@ uint16_t testPaintVerticalTunnelHeight;
 #endif
 
 static void blank_tiles_paint(paint_session* session, int32_t x, int32_t y);
-static void sub_68B3FB(paint_session* session, int32_t x, int32_t y);
+static void sub_68B3FB(paint_session* session, int32_t x, int32_t y, bool useCache);
+static TileElement* paint_tile_elements(paint_session* session, TileElement* tile_element);
 
 const int32_t SEGMENTS_ALL = SEGMENT_B4 | SEGMENT_B8 | SEGMENT_BC | SEGMENT_C0 | SEGMENT_C4 | SEGMENT_C8 | SEGMENT_CC
     | SEGMENT_D0 | SEGMENT_D4;
@@ -55,7 +57,7 @@ void tile_element_paint_setup(paint_session* session, int32_t x, int32_t y)
         session->Unk141E9DB = 0;
         session->WaterHeight = 0xFFFF;
 
-        sub_68B3FB(session, x, y);
+        sub_68B3FB(session, x, y, true);
     }
     else if (!(session->ViewFlags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND))
     {
@@ -76,7 +78,7 @@ void sub_68B2B7(paint_session* session, const CoordsXY& mapCoords)
         session->WaterHeight = 0xFFFF;
         session->Unk141E9DB = G141E9DB_FLAG_2;
 
-        sub_68B3FB(session, mapCoords.x, mapCoords.y);
+        sub_68B3FB(session, mapCoords.x, mapCoords.y, false);
     }
     else if (!(session->ViewFlags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND))
     {
@@ -134,7 +136,7 @@ bool gShowSupportSegmentHeights = false;
  *
  *  rct2: 0x0068B3FB
  */
-static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
+static void sub_68B3FB(paint_session* session, int32_t x, int32_t y, bool useCache)
 {
     rct_drawpixelinfo* dpi = &session->DPI;
 
@@ -241,6 +243,81 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
     session->SpritePosition.x = x;
     session->SpritePosition.y = y;
     session->DidPassSurface = false;
+
+#ifndef __TESTPAINT__
+    // Tiles that only hold static elements are replayed from the paint calls recorded for them
+    if (useCache && !partOfVirtualFloor
+        && OpenRCT2::Paint::TilePaintCache::Get().Paint(session, tile_element, paint_tile_elements))
+    {
+        return;
+    }
+#endif // __TESTPAINT__
+
+    tile_element = paint_tile_elements(session, tile_element);
+    if (tile_element == nullptr)
+        return;
+
+#ifndef __TESTPAINT__
+    if (gConfigGeneral.virtual_floor_style != VIRTUAL_FLOOR_STYLE_OFF && partOfVirtualFloor)
+    {
+        virtual_floor_paint(session);
+    }
+#endif // __TESTPAINT__
+
+    if (!gShowSupportSegmentHeights)
+    {
+        return;
+    }
+
+    if ((tile_element - 1)->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+    {
+        return;
+    }
+
+    static constexpr const int32_t segmentPositions[][3] = {
+        { 0, 6, 2 },
+        { 5, 4, 8 },
+        { 1, 7, 3 },
+    };
+
+    for (int32_t sy = 0; sy < 3; sy++)
+    {
+        for (int32_t sx = 0; sx < 3; sx++)
+        {
+            uint16_t segmentHeight = session->SupportSegments[segmentPositions[sy][sx]].height;
+            int32_t imageColourFlats = 0b101111 << 19 | IMAGE_TYPE_TRANSPARENT;
+            if (segmentHeight == 0xFFFF)
+            {
+                segmentHeight = session->Support.height;
+                // white: 0b101101
+                imageColourFlats = 0b111011 << 19 | IMAGE_TYPE_TRANSPARENT;
+            }
+
+            // Only draw supports below the clipping height.
+            if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (segmentHeight > gClipHeight))
+                continue;
+
+            int32_t xOffset = sy * 10;
+            int32_t yOffset = -22 + sx * 10;
+            paint_struct* ps = sub_98197C(
+                session, 5504 | imageColourFlats, xOffset, yOffset, 10, 10, 1, segmentHeight, xOffset + 1, yOffset + 16,
+                segmentHeight);
+            if (ps != nullptr)
+            {
+                ps->flags &= PAINT_STRUCT_FLAG_IS_MASKED;
+                ps->colour_image_id = COLOUR_BORDEAUX_RED;
+            }
+        }
+    }
+}
+
+/**
+ * Paints the elements of a tile.
+ * @return the element after the last element of the tile, or nullptr if painting stopped at a corrupt element.
+ */
+static TileElement* paint_tile_elements(paint_session* session, TileElement* tile_element)
+{
+    uint8_t rotation = session->CurrentRotation;
     int32_t previousBaseZ = 0;
     do
     {
@@ -318,69 +395,17 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
             // A corrupt element inserted by OpenRCT2 itself, which skips the drawing of the next element only.
             case TILE_ELEMENT_TYPE_CORRUPT:
                 if (tile_element->IsLastForTile())
-                    return;
+                    return nullptr;
                 tile_element++;
                 break;
             default:
                 // An undefined map element is most likely a corrupt element inserted by 8 cars' MOM feature to skip drawing of
                 // all elements after it.
-                return;
+                return nullptr;
         }
         session->MapPosition = mapPosition;
     } while (!(tile_element++)->IsLastForTile());
-
-#ifndef __TESTPAINT__
-    if (gConfigGeneral.virtual_floor_style != VIRTUAL_FLOOR_STYLE_OFF && partOfVirtualFloor)
-    {
-        virtual_floor_paint(session);
-    }
-#endif // __TESTPAINT__
-
-    if (!gShowSupportSegmentHeights)
-    {
-        return;
-    }
-
-    if ((tile_element - 1)->GetType() == TILE_ELEMENT_TYPE_SURFACE)
-    {
-        return;
-    }
-
-    static constexpr const int32_t segmentPositions[][3] = {
-        { 0, 6, 2 },
-        { 5, 4, 8 },
-        { 1, 7, 3 },
-    };
-
-    for (int32_t sy = 0; sy < 3; sy++)
-    {
-        for (int32_t sx = 0; sx < 3; sx++)
-        {
-            uint16_t segmentHeight = session->SupportSegments[segmentPositions[sy][sx]].height;
-            int32_t imageColourFlats = 0b101111 << 19 | IMAGE_TYPE_TRANSPARENT;
-            if (segmentHeight == 0xFFFF)
-            {
-                segmentHeight = session->Support.height;
-                // white: 0b101101
-                imageColourFlats = 0b111011 << 19 | IMAGE_TYPE_TRANSPARENT;
-            }
-
-            // Only draw supports below the clipping height.
-            if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (segmentHeight > gClipHeight))
-                continue;
-
-            int32_t xOffset = sy * 10;
-            int32_t yOffset = -22 + sx * 10;
-            paint_struct* ps = sub_98197C(
-                session, 5504 | imageColourFlats, xOffset, yOffset, 10, 10, 1, segmentHeight, xOffset + 1, yOffset + 16,
-                segmentHeight);
-            if (ps != nullptr)
-            {
-                ps->flags &= PAINT_STRUCT_FLAG_IS_MASKED;
-                ps->colour_image_id = COLOUR_BORDEAUX_RED;
-            }
-        }
-    }
+    return tile_element;
 }
 
 void paint_util_push_tunnel_left(paint_session* session, uint16_t height, uint8_t type)
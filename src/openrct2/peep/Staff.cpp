@@ -438,20 +438,8 @@ void staff_toggle_patrol_area(int32_t staffIndex, int32_t x, int32_t y)
  */
 static uint8_t staff_handyman_direction_to_nearest_litter(Peep* peep)
 {
-    uint16_t nearestLitterDist = 0xFFFF;
-    Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
-    {
-        uint16_t distance = abs(litter->x - peep->x) + abs(litter->y - peep->y) + abs(litter->z - peep->z) * 4;
-
-        if (distance < nearestLitterDist)
-        {
-            nearestLitterDist = distance;
-            nearestLitter = litter;
-        }
-    }
-
-    if (nearestLitterDist > 0x60)
+    Litter* nearestLitter = litter_get_nearest({ peep->x, peep->y, peep->z }, 0x60);
+    if (nearestLitter == nullptr)
     {
         return INVALID_DIRECTION;
     }
@@ -1806,14 +1794,12 @@ static int32_t peep_update_patrolling_find_sweeping(Peep* peep)
 {
     if (!(peep->StaffOrders & STAFF_ORDERS_SWEEPING))
         return 0;
-    auto quad = EntityTileList<Litter>({ peep->x, peep->y });
-    for (auto litter : quad)
+    auto tile = CoordsXY{ peep->x, peep->y }.ToTileStart();
+    auto litter = litter_get_first_in_range(
+        { tile.x, tile.y, tile.x + COORDS_XY_STEP - 1, tile.y + COORDS_XY_STEP - 1 },
+        [peep](const Litter* candidate) { return abs(peep->z - candidate->z) < 16; });
+    if (litter != nullptr)
     {
-        uint16_t z_diff = abs(peep->z - litter->z);
-
-        if (z_diff >= 16)
-            continue;
-
         peep->SetState(PEEP_STATE_SWEEPING);
 
         peep->Var37 = 0;
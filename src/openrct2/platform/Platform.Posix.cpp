@@ -13,11 +13,15 @@
 #    include "Platform2.h"
 #    include "platform.h"
 
+#    include <cerrno>
 #    include <clocale>
 #    include <cstdlib>
 #    include <cstring>
 #    include <ctime>
+#    include <fcntl.h>
 #    include <pwd.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
 
 namespace Platform
 {
@@ -104,6 +108,69 @@ namespace Platform
     {
         return false;
     }
+
+    int32_t Execute(const std::string& path, const std::vector<std::string>& args, std::string* output)
+    {
+        // The pipe must not leak into processes started concurrently by other threads, or its end of file is delayed
+        // until they exit.
+        int pipeFds[2];
+#    ifdef __linux__
+        if (pipe2(pipeFds, O_CLOEXEC) != 0)
+            return -1;
+#    else
+        if (pipe(pipeFds) != 0)
+            return -1;
+        fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+#    endif
+
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(path.c_str()));
+        for (const auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid = fork();
+        if (pid == -1)
+        {
+            close(pipeFds[0]);
+            close(pipeFds[1]);
+            return -1;
+        }
+        if (pid == 0)
+        {
+            dup2(pipeFds[1], STDOUT_FILENO);
+            execv(path.c_str(), argv.data());
+            _exit(127);
+        }
+
+        close(pipeFds[1]);
+        char buffer[4096];
+        for (;;)
+        {
+            ssize_t bytesRead = read(pipeFds[0], buffer, sizeof(buffer));
+            if (bytesRead > 0)
+            {
+                if (output != nullptr)
+                    output->append(buffer, static_cast<size_t>(bytesRead));
+            }
+            else if (bytesRead == 0 || errno != EINTR)
+            {
+                break;
+            }
+        }
+        close(pipeFds[0]);
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) == -1)
+        {
+            if (errno != EINTR)
+                return -1;
+        }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
 } // namespace Platform
 
 #endif
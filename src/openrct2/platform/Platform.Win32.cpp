@@ -17,6 +17,7 @@
 
 #    include <datetimeapi.h>
 #    include <memory>
+#    include <mutex>
 #    include <shlobj.h>
 #    undef GetEnvironmentVariable
 
@@ -476,6 +477,78 @@ namespace Platform
     {
         return false;
     }
+
+    static std::string QuoteCommandLineArgument(const std::string& arg)
+    {
+        std::string result = "\"";
+        for (auto c : arg)
+        {
+            if (c == '"')
+                result += '\\';
+            result += c;
+        }
+        result += '"';
+        return result;
+    }
+
+    int32_t Execute(const std::string& path, const std::vector<std::string>& args, std::string* output)
+    {
+        SECURITY_ATTRIBUTES securityAttributes = {};
+        securityAttributes.nLength = sizeof(securityAttributes);
+        securityAttributes.bInheritHandle = TRUE;
+
+        std::string commandLine = QuoteCommandLineArgument(path);
+        for (const auto& arg : args)
+        {
+            commandLine += " " + QuoteCommandLineArgument(arg);
+        }
+        auto commandLineW = String::ToWideChar(commandLine);
+
+        // Every inheritable handle is passed to a process created while it is open, so the write end of the pipe must
+        // only exist while this child is created and not leak into one created by another thread.
+        static std::mutex inheritMutex;
+        std::unique_lock<std::mutex> inheritLock(inheritMutex);
+
+        HANDLE readPipe = nullptr;
+        HANDLE writePipe = nullptr;
+        if (!CreatePipe(&readPipe, &writePipe, &securityAttributes, 0))
+            return -1;
+        SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOW startupInfo = {};
+        startupInfo.cb = sizeof(startupInfo);
+        startupInfo.dwFlags = STARTF_USESTDHANDLES;
+        startupInfo.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        startupInfo.hStdOutput = writePipe;
+        startupInfo.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+        PROCESS_INFORMATION processInfo = {};
+        BOOL created = CreateProcessW(
+            nullptr, commandLineW.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startupInfo, &processInfo);
+        CloseHandle(writePipe);
+        inheritLock.unlock();
+        if (!created)
+        {
+            CloseHandle(readPipe);
+            return -1;
+        }
+
+        char buffer[4096];
+        DWORD bytesRead = 0;
+        while (ReadFile(readPipe, buffer, sizeof(buffer), &bytesRead, nullptr) && bytesRead > 0)
+        {
+            if (output != nullptr)
+                output->append(buffer, bytesRead);
+        }
+        CloseHandle(readPipe);
+
+        WaitForSingleObject(processInfo.hProcess, INFINITE);
+        DWORD exitCode = 0;
+        GetExitCodeProcess(processInfo.hProcess, &exitCode);
+        CloseHandle(processInfo.hThread);
+        CloseHandle(processInfo.hProcess);
+        return static_cast<int32_t>(exitCode);
+    }
 } // namespace Platform
 
 #endif
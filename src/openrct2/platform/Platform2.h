@@ -14,6 +14,7 @@
 
 #include <ctime>
 #include <string>
+#include <vector>
 
 enum class SPECIAL_FOLDER
 {
@@ -34,6 +35,12 @@ namespace Platform
     std::string GetDocsPath();
     std::string GetCurrentExecutablePath();
     bool FileExists(const std::string path);
+
+    /**
+     * Runs an executable and waits for it to exit. Its standard output is appended to output, if given.
+     * @returns The exit code of the process, or -1 if it could not be started or did not exit normally.
+     */
+    int32_t Execute(const std::string& path, const std::vector<std::string>& args, std::string* output = nullptr);
     rct2_time GetTimeLocal();
     rct2_date GetDateLocal();
 
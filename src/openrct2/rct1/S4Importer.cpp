@@ -35,6 +35,7 @@
 #include "../peep/Peep.h"
 #include "../peep/Staff.h"
 #include "../ride/RideData.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../scenario/Scenario.h"
@@ -1340,7 +1341,7 @@ private:
                 ImportPeep(peep, srcPeep);
             }
         }
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        for (size_t i = 0; i < sprite_get_capacity(); i++)
         {
             auto vehicle = GetEntity<Vehicle>(i);
             if (vehicle != nullptr)
@@ -2767,6 +2768,7 @@ private:
         }
 
         gNextFreeTileElement = nextFreeTileElement;
+        ride_footprint_invalidate();
     }
 
     void FixWalls()
@@ -10,6 +10,9 @@
 #include "SawyerChunkReader.h"
 
 #include "../core/IStream.hpp"
+#include "../core/JobPool.hpp"
+
+#include <exception>
 
 // malloc is very slow for large allocations in MSVC debug builds as it allocates
 // memory on a special debug heap and then initialises all the memory to 0xCC.
@@ -145,8 +148,83 @@ std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunkTrack()
 void SawyerChunkReader::ReadChunk(void* dst, size_t length)
 {
     auto chunk = ReadChunk();
-    auto chunkData = static_cast<const uint8_t*>(chunk->GetData());
-    auto chunkLength = chunk->GetLength();
+    CopyChunkData(dst, length, *chunk);
+}
+
+void SawyerChunkReader::ReadChunks(const std::vector<SawyerChunkDestination>& chunks)
+{
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        // Reading is cheap compared to decoding, read all the encoded data first so the chunks can be decoded in parallel.
+        std::vector<sawyercoding_chunk_header> headers(chunks.size());
+        std::vector<std::unique_ptr<uint8_t[]>> compressedData(chunks.size());
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            auto& header = headers[i];
+            header = _stream->ReadValue<sawyercoding_chunk_header>();
+            if (header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            if (header.encoding > CHUNK_ENCODING_ROTATE)
+                throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+
+            compressedData[i] = std::make_unique<uint8_t[]>(header.length);
+            if (_stream->TryRead(compressedData[i].get(), header.length) != header.length)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            }
+        }
+
+        std::vector<std::exception_ptr> errors(chunks.size());
+        JobPool::Get().ParallelFor(0, chunks.size(), 1, [&](size_t i) {
+            try
+            {
+                auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
+                size_t uncompressedLength = 0;
+                try
+                {
+                    uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData[i].get(), headers[i]);
+                }
+                catch (const std::exception&)
+                {
+                    FreeLargeTempBuffer(buffer);
+                    throw;
+                }
+                if (uncompressedLength == 0)
+                {
+                    FreeLargeTempBuffer(buffer);
+                    throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+                }
+                buffer = static_cast<uint8_t*>(FinaliseLargeTempBuffer(buffer, uncompressedLength));
+                auto chunk = SawyerChunk(static_cast<SAWYER_ENCODING>(headers[i].encoding), buffer, uncompressedLength);
+                CopyChunkData(chunks[i].Data, chunks[i].Length, chunk);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        });
+
+        for (const auto& error : errors)
+        {
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
+    }
+}
+
+void SawyerChunkReader::CopyChunkData(void* dst, size_t length, const SawyerChunk& chunk)
+{
+    auto chunkData = static_cast<const uint8_t*>(chunk.GetData());
+    auto chunkLength = chunk.GetLength();
     if (chunkLength > length)
     {
         std::memcpy(dst, chunkData, length);
@@ -14,9 +14,19 @@
 #include "SawyerChunk.h"
 
 #include <memory>
+#include <vector>
 
 interface IStream;
 
+/**
+ * A buffer to read a chunk into.
+ */
+struct SawyerChunkDestination
+{
+    void* Data;
+    size_t Length;
+};
+
 /**
  * Reads sawyer encoding chunks from a data stream. This can be used to read
  * SC6, SV6 and RCT2 objects.
@@ -55,6 +65,13 @@ public:
      */
     void ReadChunk(void* dst, size_t length);
 
+    /**
+     * Reads the next chunks from the stream into the given buffers like
+     * ReadChunk(dst, length), the chunks are decoded concurrently.
+     * @param chunks The destination buffer of each chunk, in stream order.
+     */
+    void ReadChunks(const std::vector<SawyerChunkDestination>& chunks);
+
     /**
      * Reads the next chunk from the stream into a buffer returned as the
      * specified type. If the chunk is smaller than the size of the type
@@ -68,6 +85,7 @@ public:
     }
 
 private:
+    static void CopyChunkData(void* dst, size_t length, const SawyerChunk& chunk);
     static size_t DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header);
     static size_t DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
     static size_t DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
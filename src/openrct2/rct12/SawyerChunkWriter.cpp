@@ -10,8 +10,12 @@
 #include "SawyerChunkWriter.h"
 
 #include "../core/IStream.hpp"
+#include "../core/JobPool.hpp"
 #include "../util/SawyerCoding.h"
 
+#include <atomic>
+#include <exception>
+
 // Maximum buffer size to store compressed data, maximum of 16 MiB
 constexpr size_t MAX_COMPRESSED_CHUNK_SIZE = 16 * 1024 * 1024;
 
@@ -26,15 +30,69 @@ void SawyerChunkWriter::WriteChunk(const SawyerChunk* chunk)
 }
 
 void SawyerChunkWriter::WriteChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
+{
+    auto data = EncodeChunk(src, length, encoding);
+    _stream->Write(data.data(), data.size());
+}
+
+void SawyerChunkWriter::WriteChunks(const std::vector<SawyerChunkSource>& chunks, const std::function<void(size_t)>& reportFn)
+{
+    // Every chunk is encoded on its own, so encode them all at once and only write them out in order afterwards.
+    std::vector<std::vector<uint8_t>> encodedChunks(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::atomic<size_t> encodedLength = { 0 };
+
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup group;
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        auto* chunk = &chunks[i];
+        auto* encodedChunk = &encodedChunks[i];
+        auto* error = &errors[i];
+        auto* progress = &encodedLength;
+        jobPool.AddTask(group, [chunk, encodedChunk, error, progress]() {
+            try
+            {
+                *encodedChunk = EncodeChunk(chunk->Data, chunk->Length, chunk->Encoding);
+            }
+            catch (...)
+            {
+                *error = std::current_exception();
+            }
+            progress->fetch_add(chunk->Length, std::memory_order_relaxed);
+        });
+    }
+    if (reportFn)
+    {
+        jobPool.Join(group, [&reportFn, &encodedLength]() { reportFn(encodedLength.load(std::memory_order_relaxed)); });
+    }
+    else
+    {
+        jobPool.Join(group);
+    }
+
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        if (errors[i] != nullptr)
+        {
+            std::rethrow_exception(errors[i]);
+        }
+        _stream->Write(encodedChunks[i].data(), encodedChunks[i].size());
+    }
+}
+
+std::vector<uint8_t> SawyerChunkWriter::EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding)
 {
     sawyercoding_chunk_header header;
     header.encoding = static_cast<uint8_t>(encoding);
     header.length = static_cast<uint32_t>(length);
 
-    auto data = std::make_unique<uint8_t[]>(MAX_COMPRESSED_CHUNK_SIZE);
-    size_t dataLength = sawyercoding_write_chunk_buffer(data.get(), static_cast<const uint8_t*>(src), header);
-
-    _stream->Write(data.get(), dataLength);
+    // Repeat encoding can double the size, RLE adds another byte for every 126 bytes
+    size_t capacity = sizeof(header) + (length * 2) + (length / 32) + 8;
+    std::vector<uint8_t> data(std::min(capacity, MAX_COMPRESSED_CHUNK_SIZE));
+    size_t dataLength = sawyercoding_write_chunk_buffer(data.data(), static_cast<const uint8_t*>(src), header);
+    data.resize(dataLength);
+    return data;
 }
 
 /**
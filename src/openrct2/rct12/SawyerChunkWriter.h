@@ -12,10 +12,22 @@
 #include "../common.h"
 #include "SawyerChunk.h"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 interface IStream;
 
+/**
+ * A buffer to be written to a stream as a chunk.
+ */
+struct SawyerChunkSource
+{
+    const void* Data;
+    size_t Length;
+    SAWYER_ENCODING Encoding;
+};
+
 /**
  * Writes sawyer encoding chunks to a data stream. This can be used to write
  * SC6 and SV6 files.
@@ -40,6 +52,13 @@ public:
      */
     void WriteChunk(const void* src, size_t length, SAWYER_ENCODING encoding);
 
+    /**
+     * Encodes the given chunks concurrently and writes them to the stream in the given order.
+     * @param chunks The chunks to write.
+     * @param reportFn Called periodically on the calling thread with the number of source bytes encoded so far.
+     */
+    void WriteChunks(const std::vector<SawyerChunkSource>& chunks, const std::function<void(size_t)>& reportFn = nullptr);
+
     /**
      * Writes a track chunk to the stream containing the given buffer.
      * @param src The source buffer.
@@ -54,4 +73,7 @@ public:
     {
         WriteChunk(src, sizeof(T), encoding);
     }
+
+private:
+    static std::vector<uint8_t> EncodeChunk(const void* src, size_t length, SAWYER_ENCODING encoding);
 };
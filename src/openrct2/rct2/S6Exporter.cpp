@@ -13,10 +13,12 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../common.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -92,13 +94,28 @@ void S6Exporter::Save(IStream* stream, bool isScenario)
 
     auto chunkWriter = SawyerChunkWriter(stream);
 
+    // Progress is the share of the park data that has been encoded, which is nearly all of the time taken.
+    const size_t totalLength = sizeof(_s6) + _extensionSprites.size() * sizeof(RCT2Sprite);
+    size_t writtenLength = 0;
+    auto reportProgress = [&](size_t length) {
+        if (OnSaveProgress != nullptr)
+        {
+            OnSaveProgress(std::min(writtenLength + length, totalLength), totalLength);
+        }
+    };
+    auto writeChunk = [&](const void* src, size_t length, SAWYER_ENCODING encoding) {
+        chunkWriter.WriteChunk(src, length, encoding);
+        reportProgress(length);
+        writtenLength += length;
+    };
+
     // 0: Write header chunk
-    chunkWriter.WriteChunk(&_s6.header, SAWYER_ENCODING::ROTATE);
+    writeChunk(&_s6.header, sizeof(_s6.header), SAWYER_ENCODING::ROTATE);
 
     // 1: Write scenario info chunk
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
-        chunkWriter.WriteChunk(&_s6.info, SAWYER_ENCODING::ROTATE);
+        writeChunk(&_s6.info, sizeof(_s6.info), SAWYER_ENCODING::ROTATE);
     }
 
     // 2: Write packed objects
@@ -108,33 +125,52 @@ void S6Exporter::Save(IStream* stream, bool isScenario)
         objRepo.WritePackedObjects(stream, ExportObjectsList);
     }
 
+    // The remaining chunks are independent of each other and encoded concurrently
+    std::vector<SawyerChunkSource> chunks;
+
     // 3: Write available objects chunk
-    chunkWriter.WriteChunk(_s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE);
+    chunks.push_back({ _s6.objects, sizeof(_s6.objects), SAWYER_ENCODING::ROTATE });
 
     // 4: Misc fields (data, rand...) chunk
-    chunkWriter.WriteChunk(&_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.elapsed_months, 16, SAWYER_ENCODING::RLECOMPRESSED });
 
     // 5: Map elements + sprites and other fields chunk
-    chunkWriter.WriteChunk(&_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED);
+    chunks.push_back({ &_s6.tile_elements, 0x180000, SAWYER_ENCODING::RLECOMPRESSED });
 
     if (_s6.header.type == S6_TYPE_SCENARIO)
     {
         // 6 to 13:
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED);
-        chunkWriter.WriteChunk(&_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x27104C, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.guests_in_park, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.last_guests_in_park, 8, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_rating, 2, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.active_research_types, 1082, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.current_expenditure, 16, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.park_value, 4, SAWYER_ENCODING::RLECOMPRESSED });
+        chunks.push_back({ &_s6.completed_company_value, 0x761E8, SAWYER_ENCODING::RLECOMPRESSED });
     }
     else
     {
         // 6: Everything else...
-        chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED);
+        chunks.push_back({ &_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED });
+    }
+
+    // OpenRCT2 sprite extension
+    std::vector<uint8_t> extension;
+    if (_spriteExtension.magic == S6_SPRITE_EXTENSION_MAGIC)
+    {
+        const size_t spritesSize = _extensionSprites.size() * sizeof(RCT2Sprite);
+        extension.resize(sizeof(_spriteExtension) + spritesSize);
+        std::memcpy(extension.data(), &_spriteExtension, sizeof(_spriteExtension));
+        if (spritesSize > 0)
+        {
+            std::memcpy(extension.data() + sizeof(_spriteExtension), _extensionSprites.data(), spritesSize);
+        }
+        chunks.push_back({ extension.data(), extension.size(), SAWYER_ENCODING::RLECOMPRESSED });
     }
 
+    chunkWriter.WriteChunks(chunks, reportProgress);
+
     // Determine number of bytes written
     size_t fileSize = stream->GetLength();
 
@@ -948,6 +984,22 @@ void S6Exporter::ExportSprites()
         ExportSprite(&_s6.sprites[i], reinterpret_cast<const rct_sprite*>(GetEntity(i)));
     }
 
+    // Sprites beyond the RCT2 limit and the sprite limit itself are only written when they are used.
+    const uint16_t numSprites = sprite_get_capacity();
+    _extensionSprites.clear();
+    _spriteExtension = {};
+    if (numSprites > RCT2_MAX_SPRITES || sprite_get_limit() != MAX_SPRITES_DEFAULT)
+    {
+        _spriteExtension.magic = S6_SPRITE_EXTENSION_MAGIC;
+        _spriteExtension.sprite_limit = sprite_get_limit();
+        _spriteExtension.num_sprites = numSprites;
+        _extensionSprites.resize(numSprites - RCT2_MAX_SPRITES);
+        for (int32_t i = RCT2_MAX_SPRITES; i < numSprites; i++)
+        {
+            ExportSprite(&_extensionSprites[i - RCT2_MAX_SPRITES], reinterpret_cast<const rct_sprite*>(GetEntity(i)));
+        }
+    }
+
     for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
     {
         _s6.sprite_lists_head[i] = gSpriteListHead[i];
@@ -957,7 +1009,7 @@ void S6Exporter::ExportSprites()
 
 void S6Exporter::ExportSprite(RCT2Sprite* dst, const rct_sprite* src)
 {
-    std::memset(dst, 0, sizeof(rct_sprite));
+    std::memset(dst, 0, sizeof(RCT2Sprite));
     switch (src->generic.sprite_identifier)
     {
         case SPRITE_IDENTIFIER_NULL:
@@ -1677,21 +1729,11 @@ enum : uint32_t
 };
 
 /**
- *
- *  rct2: 0x006754F5
- * @param flags bit 0: pack objects, 1: save as scenario
+ * Copies the game state into an exporter, this has to happen on the main thread between ticks. The returned exporter
+ * does not refer to the game state anymore, so it can be saved on another thread. Returns nullptr on failure.
  */
-int32_t scenario_save(const utf8* path, int32_t flags)
+std::unique_ptr<S6Exporter> scenario_save_snapshot(int32_t flags)
 {
-    if (flags & S6_SAVE_FLAG_SCENARIO)
-    {
-        log_verbose("scenario_save(%s, SCENARIO)", path);
-    }
-    else
-    {
-        log_verbose("scenario_save(%s, SAVED GAME)", path);
-    }
-
     if (!(flags & S6_SAVE_FLAG_AUTOMATIC))
     {
         window_close_construction_windows();
@@ -1700,8 +1742,7 @@ int32_t scenario_save(const utf8* path, int32_t flags)
     map_reorganise_elements();
     viewport_set_saved_view();
 
-    bool result = false;
-    auto s6exporter = new S6Exporter();
+    auto s6exporter = std::make_unique<S6Exporter>();
     try
     {
         if (flags & S6_SAVE_FLAG_EXPORT)
@@ -1711,23 +1752,66 @@ int32_t scenario_save(const utf8* path, int32_t flags)
         }
         s6exporter->RemoveTracklessRides = true;
         s6exporter->Export();
-        if (flags & S6_SAVE_FLAG_SCENARIO)
-        {
-            s6exporter->SaveScenario(path);
-        }
-        else
-        {
-            s6exporter->SaveGame(path);
-        }
-        result = true;
     }
     catch (const std::exception& e)
     {
         log_error("Unable to save park: '%s'", e.what());
+        s6exporter = nullptr;
     }
-    delete s6exporter;
 
     gfx_invalidate_screen();
+    return s6exporter;
+}
+
+/**
+ *
+ *  rct2: 0x006754F5
+ * @param flags bit 0: pack objects, 1: save as scenario
+ */
+int32_t scenario_save(const utf8* path, int32_t flags)
+{
+    if (flags & S6_SAVE_FLAG_SCENARIO)
+    {
+        log_verbose("scenario_save(%s, SCENARIO)", path);
+    }
+    else
+    {
+        log_verbose("scenario_save(%s, SAVED GAME)", path);
+    }
+
+    bool result = false;
+    auto s6exporter = scenario_save_snapshot(flags);
+    if (s6exporter != nullptr)
+    {
+        try
+        {
+            if (ParkFile::ExtensionIsParkFile(Path::GetExtension(path)))
+            {
+                auto parkFileExporter = ParkFileExporter(*s6exporter);
+                if (flags & S6_SAVE_FLAG_SCENARIO)
+                {
+                    parkFileExporter.SaveScenario(path);
+                }
+                else
+                {
+                    parkFileExporter.SaveGame(path);
+                }
+            }
+            else if (flags & S6_SAVE_FLAG_SCENARIO)
+            {
+                s6exporter->SaveScenario(path);
+            }
+            else
+            {
+                s6exporter->SaveGame(path);
+            }
+            result = true;
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Unable to save park: '%s'", e.what());
+        }
+    }
 
     if (result && !(flags & S6_SAVE_FLAG_AUTOMATIC))
     {
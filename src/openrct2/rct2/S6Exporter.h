@@ -13,6 +13,8 @@
 #include "../object/ObjectList.h"
 #include "../scenario/Scenario.h"
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -28,9 +30,13 @@ struct SpriteBase;
  */
 class S6Exporter final
 {
+    friend class ParkFileExporter;
+
 public:
     bool RemoveTracklessRides;
     std::vector<const ObjectRepositoryItem*> ExportObjectsList;
+    // Called after each chunk has been written with the uncompressed bytes written so far and in total.
+    std::function<void(size_t, size_t)> OnSaveProgress;
 
     S6Exporter();
 
@@ -52,6 +58,8 @@ public:
 
 private:
     rct_s6_data _s6{};
+    rct_s6_sprite_extension _spriteExtension{};
+    std::vector<RCT2Sprite> _extensionSprites;
     std::vector<std::string> _userStrings;
 
     void Save(IStream* stream, bool isScenario);
@@ -75,3 +83,5 @@ private:
     std::optional<uint16_t> AllocateUserString(const std::string_view& value);
     void ExportUserStrings();
 };
+
+std::unique_ptr<S6Exporter> scenario_save_snapshot(int32_t flags);
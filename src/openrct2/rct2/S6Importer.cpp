@@ -12,11 +12,13 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../config/Config.h"
 #include "../core/Console.hpp"
 #include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/Random.hpp"
 #include "../core/String.hpp"
@@ -65,6 +67,8 @@ private:
 
     const utf8* _s6Path = nullptr;
     rct_s6_data _s6{};
+    rct_s6_sprite_extension _spriteExtension{};
+    std::vector<RCT2Sprite> _extensionSprites;
     uint8_t _gameVersion = 0;
     bool _isSV7 = false;
 
@@ -85,6 +89,12 @@ public:
         {
             return LoadSavedGame(path);
         }
+        else if (ParkFile::ExtensionIsParkFile(extension))
+        {
+            rct_s6_header header;
+            ParkFileReader(path).ReadSection(ParkFileSection::S6Header, &header, sizeof(header));
+            return header.type == S6_TYPE_SCENARIO ? LoadScenario(path) : LoadSavedGame(path);
+        }
         else
         {
             throw std::runtime_error("Invalid RCT2 park extension.");
@@ -93,6 +103,13 @@ public:
 
     ParkLoadResult LoadSavedGame(const utf8* path, bool skipObjectCheck = false) override
     {
+        if (ParkFileReader::IsParkFile(path))
+        {
+            auto result = LoadFromParkFile(ParkFileReader(path), false);
+            _s6Path = path;
+            return result;
+        }
+
         auto fs = FileStream(path, FILE_MODE_OPEN);
         auto result = LoadFromStream(&fs, false, skipObjectCheck);
         _s6Path = path;
@@ -101,6 +118,13 @@ public:
 
     ParkLoadResult LoadScenario(const utf8* path, bool skipObjectCheck = false) override
     {
+        if (ParkFileReader::IsParkFile(path))
+        {
+            auto result = LoadFromParkFile(ParkFileReader(path), true);
+            _s6Path = path;
+            return result;
+        }
+
         auto fs = FileStream(path, FILE_MODE_OPEN);
         auto result = LoadFromStream(&fs, true, skipObjectCheck);
         _s6Path = path;
@@ -111,6 +135,13 @@ public:
         IStream* stream, bool isScenario, [[maybe_unused]] bool skipObjectCheck = false,
         const utf8* path = String::Empty) override
     {
+        if (ParkFileReader::IsParkFile(stream))
+        {
+            auto result = LoadFromParkFile(ParkFileReader(stream), isScenario);
+            _s6Path = path;
+            return result;
+        }
+
         if (isScenario && !gConfigGeneral.allow_loading_with_incorrect_checksum && !SawyerEncoding::ValidateChecksum(stream))
         {
             throw IOException("Invalid checksum.");
@@ -156,24 +187,36 @@ public:
 
         if (isScenario)
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 2560076);
-            chunkReader.ReadChunk(&_s6.guests_in_park, 4);
-            chunkReader.ReadChunk(&_s6.last_guests_in_park, 8);
-            chunkReader.ReadChunk(&_s6.park_rating, 2);
-            chunkReader.ReadChunk(&_s6.active_research_types, 1082);
-            chunkReader.ReadChunk(&_s6.current_expenditure, 16);
-            chunkReader.ReadChunk(&_s6.park_value, 4);
-            chunkReader.ReadChunk(&_s6.completed_company_value, 483816);
+            chunkReader.ReadChunks({
+                { &_s6.objects, sizeof(_s6.objects) },
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 2560076 },
+                { &_s6.guests_in_park, 4 },
+                { &_s6.last_guests_in_park, 8 },
+                { &_s6.park_rating, 2 },
+                { &_s6.active_research_types, 1082 },
+                { &_s6.current_expenditure, 16 },
+                { &_s6.park_value, 4 },
+                { &_s6.completed_company_value, 483816 },
+            });
         }
         else
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 3048816);
+            chunkReader.ReadChunks({
+                { &_s6.objects, sizeof(_s6.objects) },
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 3048816 },
+            });
+        }
+
+        // Parks with more sprites than RCT2 supports have an extension chunk before the checksum.
+        _spriteExtension = {};
+        _extensionSprites.clear();
+        if (stream->GetLength() - stream->GetPosition() > sizeof(uint32_t))
+        {
+            ReadSpriteExtension(chunkReader);
         }
 
         _s6Path = path;
@@ -181,6 +224,176 @@ public:
         return ParkLoadResult(GetRequiredObjects());
     }
 
+    /**
+     * Reads a park written by ParkFileExporter into the same structures as an SV6 / SC6. The sections are all read
+     * here as the reader may refer to the stream.
+     */
+    ParkLoadResult LoadFromParkFile(const ParkFileReader& reader, bool isScenario)
+    {
+        for (auto section : { ParkFileSection::S6Header, ParkFileSection::Objects, ParkFileSection::General,
+                              ParkFileSection::TileElements, ParkFileSection::Sprites })
+        {
+            if (reader.GetSectionVersion(section) > 1)
+            {
+                throw IOException("Park was saved by a newer version of OpenRCT2.");
+            }
+        }
+
+        reader.ReadSection(ParkFileSection::S6Header, &_s6.header, sizeof(_s6.header));
+        if (isScenario)
+        {
+            if (_s6.header.type != S6_TYPE_SCENARIO)
+            {
+                throw std::runtime_error("Park is not a scenario.");
+            }
+            reader.ReadSection(ParkFileSection::ScenarioInfo, &_s6.info, sizeof(_s6.info));
+        }
+        else if (_s6.header.type != S6_TYPE_SAVEDGAME)
+        {
+            throw std::runtime_error("Park is not a saved game.");
+        }
+
+        if (_s6.header.num_packed_objects > 0)
+        {
+            auto packedObjects = reader.ReadSection(ParkFileSection::PackedObjects);
+            auto ms = MemoryStream(packedObjects.data(), packedObjects.size());
+            for (uint16_t i = 0; i < _s6.header.num_packed_objects; i++)
+            {
+                _objectRepository.ExportPackedObject(&ms);
+            }
+        }
+        _isSV7 = false;
+
+        auto sections = reader.ReadSections(
+            { ParkFileSection::Objects, ParkFileSection::General, ParkFileSection::TileElements, ParkFileSection::Sprites });
+        const auto& objects = sections[0];
+        const auto& general = sections[1];
+        const auto& tileElements = sections[2];
+        const auto& sprites = sections[3];
+
+        if (objects.size() != sizeof(_s6.objects))
+        {
+            throw IOException("Invalid objects section.");
+        }
+        std::memcpy(_s6.objects, objects.data(), objects.size());
+
+        // See ParkFileExporter::Save for the layout of the general section
+        const uint8_t* src = general.data();
+        const uint8_t* srcEnd = general.data() + general.size();
+        auto readRange = [&src, srcEnd](void* begin, void* end) {
+            const size_t length = static_cast<uint8_t*>(end) - static_cast<uint8_t*>(begin);
+            if (static_cast<size_t>(srcEnd - src) < length)
+            {
+                throw IOException("Invalid general section.");
+            }
+            std::memcpy(begin, src, length);
+            src += length;
+        };
+        readRange(&_s6.elapsed_months, &_s6.tile_elements);
+        readRange(&_s6.next_free_tile_element_pointer_index, &_s6.sprites);
+        readRange(&_s6.sprite_lists_head, &_s6 + 1);
+        if (src != srcEnd)
+        {
+            throw IOException("Invalid general section.");
+        }
+
+        if (tileElements.size() % sizeof(RCT12TileElement) != 0 || tileElements.size() > sizeof(_s6.tile_elements))
+        {
+            throw IOException("Invalid tile elements section.");
+        }
+        std::memcpy(_s6.tile_elements, tileElements.data(), tileElements.size());
+        std::memset(
+            reinterpret_cast<uint8_t*>(_s6.tile_elements) + tileElements.size(), 0,
+            sizeof(_s6.tile_elements) - tileElements.size());
+
+        ReadParkFileSprites(sprites);
+
+        return ParkLoadResult(GetRequiredObjects());
+    }
+
+    void ReadParkFileSprites(const std::vector<uint8_t>& data)
+    {
+        rct_s6_sprite_extension header;
+        if (data.size() < sizeof(header))
+        {
+            throw IOException("Invalid sprites section.");
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        const bool hasExtension = header.magic == S6_SPRITE_EXTENSION_MAGIC;
+        if (header.num_sprites < RCT2_MAX_SPRITES || header.num_sprites > MAX_SPRITES_LIMIT
+            || (!hasExtension && header.num_sprites != RCT2_MAX_SPRITES))
+        {
+            throw IOException("Invalid sprites section.");
+        }
+
+        _spriteExtension = hasExtension ? header : rct_s6_sprite_extension{};
+        _extensionSprites.clear();
+        _extensionSprites.resize(header.num_sprites - RCT2_MAX_SPRITES);
+
+        // Free sprites are stored without anything after their common properties
+        size_t offset = sizeof(header);
+        for (size_t i = 0; i < header.num_sprites; i++)
+        {
+            auto& dst = i < RCT2_MAX_SPRITES ? _s6.sprites[i] : _extensionSprites[i - RCT2_MAX_SPRITES];
+            std::memset(&dst, 0, sizeof(dst));
+            if (data.size() - offset < sizeof(RCT12SpriteBase))
+            {
+                throw IOException("Sprites section is too short.");
+            }
+            std::memcpy(&dst, data.data() + offset, sizeof(RCT12SpriteBase));
+
+            const size_t length = dst.unknown.sprite_identifier == SPRITE_IDENTIFIER_NULL ? sizeof(RCT12SpriteBase)
+                                                                                          : sizeof(RCT2Sprite);
+            if (data.size() - offset < length)
+            {
+                throw IOException("Sprites section is too short.");
+            }
+            std::memcpy(&dst, data.data() + offset, length);
+            offset += length;
+        }
+    }
+
+    void ReadSpriteExtension(SawyerChunkReader& chunkReader)
+    {
+        try
+        {
+            auto chunk = chunkReader.ReadChunk();
+            if (chunk->GetLength() < sizeof(_spriteExtension))
+            {
+                throw IOException("Sprite extension chunk is too short.");
+            }
+
+            rct_s6_sprite_extension extension;
+            std::memcpy(&extension, chunk->GetData(), sizeof(extension));
+            if (extension.magic != S6_SPRITE_EXTENSION_MAGIC || extension.num_sprites < RCT2_MAX_SPRITES
+                || extension.num_sprites > MAX_SPRITES_LIMIT)
+            {
+                throw IOException("Invalid sprite extension chunk.");
+            }
+
+            const size_t numExtensionSprites = extension.num_sprites - RCT2_MAX_SPRITES;
+            if (chunk->GetLength() < sizeof(extension) + numExtensionSprites * sizeof(RCT2Sprite))
+            {
+                throw IOException("Sprite extension chunk is too short.");
+            }
+
+            _extensionSprites.resize(numExtensionSprites);
+            if (numExtensionSprites > 0)
+            {
+                std::memcpy(
+                    _extensionSprites.data(), static_cast<const uint8_t*>(chunk->GetData()) + sizeof(extension),
+                    numExtensionSprites * sizeof(RCT2Sprite));
+            }
+            _spriteExtension = extension;
+        }
+        catch (const std::exception& e)
+        {
+            // Trailing data of other tools, the park is still a valid RCT2 park.
+            log_warning("Ignoring data after the last chunk: %s", e.what());
+            _extensionSprites.clear();
+        }
+    }
+
     bool GetDetails(scenario_index_entry* dst) override
     {
         *dst = {};
@@ -472,6 +685,7 @@ public:
         {
             log_error("Found %d disjoint null sprites", disjoint_sprites_count);
         }
+        reset_sprite_list_index();
 
         if (String::Equals(_s6.scenario_filename, "Europe - European Cultural Festival.SC6"))
         {
@@ -1281,20 +1495,32 @@ public:
 
     void ImportSprites()
     {
+        const bool hasExtension = _spriteExtension.magic == S6_SPRITE_EXTENSION_MAGIC;
+        if (hasExtension)
+        {
+            sprite_grow_capacity(_spriteExtension.num_sprites);
+        }
+
         for (int32_t i = 0; i < RCT2_MAX_SPRITES; i++)
         {
             auto src = &_s6.sprites[i];
             auto dst = GetEntity(i);
             ImportSprite(reinterpret_cast<rct_sprite*>(dst), src);
         }
+        for (size_t i = 0; i < _extensionSprites.size(); i++)
+        {
+            auto dst = GetEntity(RCT2_MAX_SPRITES + i);
+            ImportSprite(reinterpret_cast<rct_sprite*>(dst), &_extensionSprites[i]);
+        }
 
+        // The counts include the sprites of the extension, RCT2 parks have exactly RCT2_MAX_SPRITES sprites.
         for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
         {
             gSpriteListHead[i] = _s6.sprite_lists_head[i];
             gSpriteListCount[i] = _s6.sprite_lists_count[i];
         }
-        // This list contains the number of free slots. Increase it according to our own sprite limit.
-        gSpriteListCount[SPRITE_LIST_FREE] += (MAX_SPRITES - RCT2_MAX_SPRITES);
+
+        sprite_set_limit(hasExtension ? _spriteExtension.sprite_limit : MAX_SPRITES_DEFAULT);
     }
 
     void ImportSprite(rct_sprite* dst, const RCT2Sprite* src)
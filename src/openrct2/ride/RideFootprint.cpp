@@ -0,0 +1,194 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RideFootprint.h"
+
+#include "../world/Map.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// The map is split into cells of 8x8 tiles. Each cell lists the tiles it contains that have track on them together with
+// the ride of the track, and the set of all those rides. A query ORs the sets of cells that are fully in range and only
+// checks single tiles for cells on the border of the range, so the result is the same as looking at every tile.
+static constexpr int32_t RIDE_FOOTPRINT_CELL_TILES = 8;
+static constexpr int32_t RIDE_FOOTPRINT_CELLS_PER_AXIS = MAXIMUM_MAP_SIZE_TECHNICAL / RIDE_FOOTPRINT_CELL_TILES;
+
+struct RideFootprintTile
+{
+    uint8_t X;
+    uint8_t Y;
+    ride_id_t RideIndex;
+
+    bool operator==(const RideFootprintTile& other) const
+    {
+        return X == other.X && Y == other.Y && RideIndex == other.RideIndex;
+    }
+};
+
+struct RideFootprintCell
+{
+    std::bitset<MAX_RIDES> Rides;
+    std::vector<RideFootprintTile> Tiles;
+};
+
+static std::array<RideFootprintCell, RIDE_FOOTPRINT_CELLS_PER_AXIS * RIDE_FOOTPRINT_CELLS_PER_AXIS> _rideFootprintCells;
+static bool _rideFootprintValid = false;
+
+static RideFootprintCell& ride_footprint_get_cell(const TileCoordsXY& tile)
+{
+    return _rideFootprintCells
+        [(tile.x / RIDE_FOOTPRINT_CELL_TILES) * RIDE_FOOTPRINT_CELLS_PER_AXIS + tile.y / RIDE_FOOTPRINT_CELL_TILES];
+}
+
+static void ride_footprint_scan_tile(RideFootprintCell& cell, const TileCoordsXY& tile)
+{
+    auto tileElement = map_get_first_element_at(tile.ToCoordsXY());
+    if (tileElement == nullptr)
+        return;
+
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
+            continue;
+
+        auto rideIndex = tileElement->AsTrack()->GetRideIndex();
+        if (rideIndex >= MAX_RIDES)
+            continue;
+
+        RideFootprintTile entry{ static_cast<uint8_t>(tile.x), static_cast<uint8_t>(tile.y), rideIndex };
+        if (std::find(cell.Tiles.begin(), cell.Tiles.end(), entry) == cell.Tiles.end())
+        {
+            cell.Tiles.push_back(entry);
+            cell.Rides[rideIndex] = true;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+}
+
+static void ride_footprint_update_cell_rides(RideFootprintCell& cell)
+{
+    cell.Rides.reset();
+    for (const auto& entry : cell.Tiles)
+    {
+        cell.Rides[entry.RideIndex] = true;
+    }
+}
+
+static void ride_footprint_rebuild()
+{
+    for (auto& cell : _rideFootprintCells)
+    {
+        cell.Rides.reset();
+        cell.Tiles.clear();
+    }
+
+    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    {
+        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+        {
+            TileCoordsXY tile{ x, y };
+            ride_footprint_scan_tile(ride_footprint_get_cell(tile), tile);
+        }
+    }
+    _rideFootprintValid = true;
+}
+
+/**
+ * Rebuilds the grid before the next query, for when tile elements have been replaced or removed in bulk.
+ */
+void ride_footprint_invalidate()
+{
+    _rideFootprintValid = false;
+}
+
+/**
+ * Updates the grid for a tile after track has been placed on or removed from it.
+ */
+void ride_footprint_update_tile(const CoordsXY& loc)
+{
+    if (!_rideFootprintValid || !map_is_location_valid(loc))
+        return;
+
+    TileCoordsXY tile{ loc };
+    auto& cell = ride_footprint_get_cell(tile);
+    cell.Tiles.erase(
+        std::remove_if(
+            cell.Tiles.begin(), cell.Tiles.end(),
+            [&tile](const RideFootprintTile& entry) { return entry.X == tile.x && entry.Y == tile.y; }),
+        cell.Tiles.end());
+    ride_footprint_scan_tile(cell, tile);
+    ride_footprint_update_cell_rides(cell);
+}
+
+/**
+ * Removes all tiles of a ride from the grid, for when the ride is demolished.
+ */
+void ride_footprint_remove_ride(ride_id_t rideIndex)
+{
+    if (!_rideFootprintValid || rideIndex >= MAX_RIDES)
+        return;
+
+    for (auto& cell : _rideFootprintCells)
+    {
+        if (!cell.Rides[rideIndex])
+            continue;
+
+        cell.Tiles.erase(
+            std::remove_if(
+                cell.Tiles.begin(), cell.Tiles.end(),
+                [rideIndex](const RideFootprintTile& entry) { return entry.RideIndex == rideIndex; }),
+            cell.Tiles.end());
+        cell.Rides[rideIndex] = false;
+    }
+}
+
+/**
+ * Gets the rides that have track on any tile within the range (inclusive).
+ */
+std::bitset<MAX_RIDES> ride_footprint_get_rides_in_range(const MapRange& range)
+{
+    if (!_rideFootprintValid)
+    {
+        ride_footprint_rebuild();
+    }
+
+    std::bitset<MAX_RIDES> result;
+    const int32_t left = std::max(range.GetLeft(), 0) / COORDS_XY_STEP;
+    const int32_t top = std::max(range.GetTop(), 0) / COORDS_XY_STEP;
+    const int32_t right = std::min(range.GetRight(), MAXIMUM_MAP_SIZE_BIG - 1) / COORDS_XY_STEP;
+    const int32_t bottom = std::min(range.GetBottom(), MAXIMUM_MAP_SIZE_BIG - 1) / COORDS_XY_STEP;
+    if (range.GetRight() < 0 || range.GetBottom() < 0)
+        return result;
+
+    for (int32_t cellX = left / RIDE_FOOTPRINT_CELL_TILES; cellX <= right / RIDE_FOOTPRINT_CELL_TILES; cellX++)
+    {
+        for (int32_t cellY = top / RIDE_FOOTPRINT_CELL_TILES; cellY <= bottom / RIDE_FOOTPRINT_CELL_TILES; cellY++)
+        {
+            const auto& cell = _rideFootprintCells[cellX * RIDE_FOOTPRINT_CELLS_PER_AXIS + cellY];
+            const int32_t cellLeft = cellX * RIDE_FOOTPRINT_CELL_TILES;
+            const int32_t cellTop = cellY * RIDE_FOOTPRINT_CELL_TILES;
+            if (cellLeft >= left && cellTop >= top && cellLeft + RIDE_FOOTPRINT_CELL_TILES - 1 <= right
+                && cellTop + RIDE_FOOTPRINT_CELL_TILES - 1 <= bottom)
+            {
+                result |= cell.Rides;
+                continue;
+            }
+
+            for (const auto& entry : cell.Tiles)
+            {
+                if (entry.X >= left && entry.X <= right && entry.Y >= top && entry.Y <= bottom)
+                {
+                    result[entry.RideIndex] = true;
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,20 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../world/Location.hpp"
+#include "Ride.h"
+
+#include <bitset>
+
+void ride_footprint_invalidate();
+void ride_footprint_update_tile(const CoordsXY& loc);
+void ride_footprint_remove_ride(ride_id_t rideIndex);
+std::bitset<MAX_RIDES> ride_footprint_get_rides_in_range(const MapRange& range);
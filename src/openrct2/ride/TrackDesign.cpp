@@ -53,6 +53,7 @@
 #include "../world/Wall.h"
 #include "Ride.h"
 #include "RideData.h"
+#include "RideFootprint.h"
 #include "Track.h"
 #include "TrackData.h"
 #include "TrackDesignRepository.h"
@@ -2139,6 +2140,7 @@ static void track_design_preview_restore_map(map_backup* backup)
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
     gCurrentRotation = backup->current_rotation;
+    ride_footprint_invalidate();
 }
 
 /**
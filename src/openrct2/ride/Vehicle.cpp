@@ -6224,7 +6224,7 @@ Vehicle* Vehicle::TrainHead() const
 
     for (;;)
     {
-        if (vehicle->prev_vehicle_on_ride > MAX_SPRITES)
+        if (vehicle->prev_vehicle_on_ride >= sprite_get_capacity())
             return nullptr;
         prevVehicle = GET_VEHICLE(vehicle->prev_vehicle_on_ride);
         if (prevVehicle->next_vehicle_on_train == SPRITE_INDEX_NULL)
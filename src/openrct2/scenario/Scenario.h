@@ -297,6 +297,18 @@ struct rct_s6_data
     uint8_t pad_13CE778[434];
 };
 assert_struct_size(rct_s6_data, 0x46b44a);
+
+/**
+ * OpenRCT2 extension chunk written after the last SV6 chunk when the park is allowed more sprites than RCT2.
+ * It is followed by the sprites from RCT2_MAX_SPRITES up to num_sprites.
+ */
+struct rct_s6_sprite_extension
+{
+    uint32_t magic;
+    uint16_t sprite_limit;
+    uint16_t num_sprites;
+};
+assert_struct_size(rct_s6_sprite_extension, 8);
 #pragma pack(pop)
 
 enum
@@ -314,6 +326,7 @@ enum
 
 #define S6_RCT2_VERSION 120001
 #define S6_MAGIC_NUMBER 0x00031144
+#define S6_SPRITE_EXTENSION_MAGIC 0x58545053 // SPTX
 
 enum
 {
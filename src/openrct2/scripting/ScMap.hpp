@@ -50,7 +50,7 @@ namespace OpenRCT2::Scripting
 
         int32_t numEntities_get() const
         {
-            return MAX_SPRITES;
+            return sprite_get_capacity();
         }
 
         std::vector<std::shared_ptr<ScRide>> rides_get() const
@@ -86,7 +86,7 @@ namespace OpenRCT2::Scripting
 
         DukValue getEntity(int32_t id) const
         {
-            if (id >= 0 && id < MAX_SPRITES)
+            if (id >= 0 && id < sprite_get_capacity())
             {
                 auto spriteId = static_cast<uint16_t>(id);
                 auto sprite = GetEntity(spriteId);
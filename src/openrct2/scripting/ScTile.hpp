@@ -14,6 +14,7 @@
 #    include "../Context.h"
 #    include "../common.h"
 #    include "../core/Guard.hpp"
+#    include "../ride/RideFootprint.h"
 #    include "../world/Footpath.h"
 #    include "../world/Scenery.h"
 #    include "../world/Sprite.h"
@@ -944,6 +945,7 @@ namespace OpenRCT2::Scripting
 
         void Invalidate()
         {
+            ride_footprint_update_tile(_coords);
             map_invalidate_tile_full(_coords);
         }
 
@@ -1123,6 +1125,7 @@ namespace OpenRCT2::Scripting
                         first[numElements - 1].SetLastForTile(true);
                     }
                 }
+                ride_footprint_update_tile(_coords);
                 map_invalidate_tile_full(_coords);
             }
         }
@@ -1175,6 +1178,7 @@ namespace OpenRCT2::Scripting
                         first[i].SetLastForTile(false);
                     }
                     first[origNumElements].SetLastForTile(true);
+                    ride_footprint_update_tile(_coords);
                     map_invalidate_tile_full(_coords);
                     result = std::make_shared<ScTileElement>(_coords, &first[index]);
                 }
@@ -1194,6 +1198,7 @@ namespace OpenRCT2::Scripting
             if (index < GetNumElements(first))
             {
                 tile_element_remove(&first[index]);
+                ride_footprint_update_tile(_coords);
                 map_invalidate_tile_full(_coords);
             }
         }
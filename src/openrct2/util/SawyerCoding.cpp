@@ -262,6 +262,29 @@ static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst
 
 #pragma region Encoding
 
+/**
+ * Returns the first position in [src, last) holding the same byte as the position after it, or last if there is none.
+ */
+static const uint8_t* find_repeated_byte(const uint8_t* src, const uint8_t* last)
+{
+    // XOR eight bytes with the eight bytes that follow them, any zero byte in the result is a repeated byte.
+    constexpr uint64_t lowBits = 0x0101010101010101ULL;
+    constexpr uint64_t highBits = 0x8080808080808080ULL;
+    while (last - src >= 8)
+    {
+        uint64_t current, next;
+        std::memcpy(&current, src, sizeof(current));
+        std::memcpy(&next, src + 1, sizeof(next));
+        uint64_t diff = current ^ next;
+        if (((diff - lowBits) & ~diff & highBits) != 0)
+            break;
+        src += 8;
+    }
+    while (src < last && src[0] != src[1])
+        src++;
+    return src;
+}
+
 /**
  * Ensure dst_buffer is bigger than src_buffer then resize afterwards
  * returns length of dst_buffer
@@ -276,32 +299,42 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
 
     while (src < end_src - 1)
     {
-        if ((count && *src == src[1]) || count > 125)
+        // Skip over the literal bytes up to the next run, flushing them every 126 bytes
+        const uint8_t* run = find_repeated_byte(src, end_src - 1);
+        while (src < run)
+        {
+            if (count > 125)
+            {
+                *dst++ = count - 1;
+                std::memcpy(dst, src_norm_start, count);
+                dst += count;
+                src_norm_start += count;
+                count = 0;
+            }
+            auto literalLength = static_cast<uint8_t>(std::min<size_t>(run - src, 126 - count));
+            count += literalLength;
+            src += literalLength;
+        }
+        if (src == end_src - 1)
+            break;
+
+        if (count)
         {
             *dst++ = count - 1;
             std::memcpy(dst, src_norm_start, count);
             dst += count;
-            src_norm_start += count;
-            count = 0;
-        }
-        if (*src == src[1])
-        {
-            for (; (count < 125) && ((src + count) < end_src); count++)
-            {
-                if (*src != src[count])
-                    break;
-            }
-            *dst++ = 257 - count;
-            *dst++ = *src;
-            src += count;
-            src_norm_start = src;
             count = 0;
         }
-        else
+        for (; (count < 125) && ((src + count) < end_src); count++)
         {
-            count++;
-            src++;
+            if (*src != src[count])
+                break;
         }
+        *dst++ = 257 - count;
+        *dst++ = *src;
+        src += count;
+        src_norm_start = src;
+        count = 0;
     }
     if (src == end_src - 1)
         count++;
@@ -330,37 +363,33 @@ static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer
     for (size_t i = 1; i < length;)
     {
         size_t searchIndex = (i < 32) ? 0 : (i - 32);
-        size_t searchEnd = i - 1;
+        const uint8_t* searchEnd = src_buffer + i;
 
+        // Maximum repeat count is 8, repeats can not overlap the current position or run past the end
+        size_t longestRepeatCount = std::min(static_cast<size_t>(8), length - i);
         size_t bestRepeatIndex = 0;
         size_t bestRepeatCount = 0;
-        for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
+
+        // Only offsets starting with the current byte can repeat it, let memchr find those oldest first so the same
+        // repeat as an exhaustive search is picked.
+        auto match = static_cast<const uint8_t*>(std::memchr(src_buffer + searchIndex, src_buffer[i], i - searchIndex));
+        while (match != nullptr)
         {
-            size_t repeatCount = 0;
-            size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
-            // maxRepeatCount should not exceed length
-            assert(repeatIndex + maxRepeatCount < length);
-            assert(i + maxRepeatCount < length);
-            for (size_t j = 0; j <= maxRepeatCount; j++)
+            size_t repeatIndex = match - src_buffer;
+            size_t maxRepeatCount = std::min(longestRepeatCount, i - repeatIndex);
+            size_t repeatCount = 1;
+            while (repeatCount < maxRepeatCount && src_buffer[repeatIndex + repeatCount] == src_buffer[i + repeatCount])
             {
-                if (src_buffer[repeatIndex + j] == src_buffer[i + j])
-                {
-                    repeatCount++;
-                }
-                else
-                {
-                    break;
-                }
+                repeatCount++;
             }
             if (repeatCount > bestRepeatCount)
             {
                 bestRepeatIndex = repeatIndex;
                 bestRepeatCount = repeatCount;
-
-                // Maximum repeat count is 8
-                if (repeatCount == 8)
+                if (repeatCount == longestRepeatCount)
                     break;
             }
+            match = static_cast<const uint8_t*>(std::memchr(match + 1, src_buffer[i], searchEnd - (match + 1)));
         }
 
         if (bestRepeatCount == 0)
@@ -582,6 +582,26 @@ uint8_t* util_zlib_inflate(uint8_t* data, size_t data_in_size, size_t* data_out_
     return buffer;
 }
 
+/**
+ * @brief Inflates zlib-compressed data of a known size into a buffer
+ * @param data Data to be decompressed
+ * @param data_in_size Size of data to be decompressed
+ * @param data_out Buffer the decompressed data is written to
+ * @param data_out_size Size of the decompressed data, which must fill the buffer exactly
+ * @return Returns false if the data is corrupt or does not have the expected size.
+ */
+bool util_zlib_inflate(const uint8_t* data, size_t data_in_size, uint8_t* data_out, size_t data_out_size)
+{
+    uLongf out_size = static_cast<uLongf>(data_out_size);
+    int32_t ret = uncompress(data_out, &out_size, data, static_cast<uLong>(data_in_size));
+    if (ret == Z_STREAM_ERROR)
+    {
+        log_error("Your build is shipped with broken zlib. Please use the official build.");
+        return false;
+    }
+    return ret == Z_OK && out_size == data_out_size;
+}
+
 /**
  * @brief Deflates input using zlib
  * @param data Data to be compressed
@@ -613,6 +633,20 @@ std::optional<std::vector<uint8_t>> util_zlib_deflate(const uint8_t* data, size_
     return buffer;
 }
 
+uint32_t util_crc32(const uint8_t* data, size_t length)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (length > 0)
+    {
+        // zlib takes 32-bit lengths
+        auto blockLength = static_cast<uInt>(std::min<size_t>(length, 1u << 30));
+        crc = crc32(crc, data, blockLength);
+        data += blockLength;
+        length -= blockLength;
+    }
+    return static_cast<uint32_t>(crc);
+}
+
 // Compress the source to gzip-compatible stream, write to dest.
 // Mainly used for compressing the crashdumps
 bool util_gzip_compress(FILE* source, FILE* dest)
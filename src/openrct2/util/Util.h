@@ -56,6 +56,8 @@ uint32_t util_rand();
 
 std::optional<std::vector<uint8_t>> util_zlib_deflate(const uint8_t* data, size_t data_in_size);
 uint8_t* util_zlib_inflate(uint8_t* data, size_t data_in_size, size_t* data_out_size);
+bool util_zlib_inflate(const uint8_t* data, size_t data_in_size, uint8_t* data_out, size_t data_out_size);
+uint32_t util_crc32(const uint8_t* data, size_t length);
 bool util_gzip_compress(FILE* source, FILE* dest);
 
 int8_t add_clamp_int8_t(int8_t value, int8_t value_to_add);
@@ -36,7 +36,9 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/TilePaintCache.h"
 #include "../ride/RideData.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../ride/TrackDesign.h"
@@ -314,6 +316,7 @@ void map_init(int32_t size)
     map_update_tile_pointers();
     map_remove_out_of_range_elements();
     AutoCreateMapAnimations();
+    OpenRCT2::Paint::TilePaintCache::Get().Clear();
 
     auto intent = Intent(INTENT_ACTION_MAP);
     context_broadcast_intent(&intent);
@@ -403,6 +406,7 @@ void map_update_tile_pointers()
     }
 
     gNextFreeTileElement = tileElement;
+    ride_footprint_invalidate();
 }
 
 /**
@@ -996,6 +1000,7 @@ void map_remove_all_rides()
                 break;
         }
     } while (tile_element_iterator_next(&it));
+    ride_footprint_invalidate();
 }
 
 /**
@@ -1621,6 +1626,7 @@ void map_remove_out_of_range_elements()
             }
         }
     }
+    ride_footprint_invalidate();
 
     // Reset cheat state
     gCheatsBuildInPauseMode = buildState;
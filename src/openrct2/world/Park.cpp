@@ -467,15 +467,10 @@ int32_t Park::CalculateParkRating() const
 
     // Litter
     {
-        int32_t litterCount = 0;
-        for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
-        {
-            // Ignore recently dropped litter
-            if (litter->creationTick - gScenarioTicks >= 7680)
-            {
-                litterCount++;
-            }
-        }
+        // Ignore recently dropped litter
+        int32_t litterCount = litter_count_in_range(
+            { 0, 0, MAXIMUM_MAP_SIZE_BIG - 1, MAXIMUM_MAP_SIZE_BIG - 1 },
+            [](const Litter* litter) { return litter->creationTick - gScenarioTicks >= 7680; });
         result -= 600 - (4 * (150 - std::min<int32_t>(150, litterCount)));
     }
 
@@ -15,6 +15,7 @@
 #include "../audio/audio.h"
 #include "../core/Crypt.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.hpp"
 #include "../interface/Viewport.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
@@ -22,17 +23,50 @@
 #include "Fountain.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <iterator>
+#include <limits>
+#include <memory>
 
 uint16_t gSpriteListHead[SPRITE_LIST_COUNT];
 uint16_t gSpriteListCount[SPRITE_LIST_COUNT];
-static rct_sprite _spriteList[MAX_SPRITES];
+// Sprites are allocated in blocks so that growing the table never moves existing sprites.
+static constexpr size_t SPRITE_BLOCK_SIZE = 1024;
+// The table grows once fewer sprites than this are free, guest generation and staff hiring already stop at 400.
+static constexpr uint16_t SPRITE_HEADROOM = 1000;
 
-static bool _spriteFlashingList[MAX_SPRITES];
+static std::vector<std::unique_ptr<rct_sprite[]>> _spriteBlocks;
+static uint16_t _spriteCapacity = 0;
+static uint16_t _spriteLimit = MAX_SPRITES_DEFAULT;
+
+static std::vector<bool> _spriteFlashingList;
 
 uint16_t gSpriteSpatialIndex[SPATIAL_INDEX_SIZE];
 
+// Dense copy of each sprite list in reverse list order, so that iterating does not need to follow the next links
+// through every sprite. Holes left by sprites that moved to another list are removed by sprite_compact_list_index.
+static std::vector<uint16_t> _spriteListIndex[SPRITE_LIST_COUNT];
+static std::vector<uint32_t> _spriteListIndexPosition;
+static bool _spriteListIndexHasHoles[SPRITE_LIST_COUNT];
+static constexpr uint32_t SPRITE_LIST_INDEX_POSITION_NULL = std::numeric_limits<uint32_t>::max();
+
+// Copy of each sprite as it went into the previous checksum. A block is marked as modified when the copy of one of its
+// sprites changes, and only modified blocks are hashed again.
+static constexpr size_t SPRITE_CHECKSUM_BLOCK_SIZE = 256;
+static_assert(SPRITE_BLOCK_SIZE % SPRITE_CHECKSUM_BLOCK_SIZE == 0);
+static std::vector<rct_sprite> _spriteChecksumInput;
+static std::vector<uint8_t> _spriteChecksumBlockDirty;
+static std::vector<std::array<uint8_t, 20>> _spriteChecksumBlockHash;
+
+// Litter is bucketed into cells of 4x4 tiles so that handymen and guests can look for litter around them without
+// walking the whole litter list. Each cell is sorted by descending sprite index, the order of the spatial index.
+static constexpr int32_t LITTER_INDEX_CELL_SIZE = 4 * COORDS_XY_STEP;
+static constexpr int32_t LITTER_INDEX_CELLS_PER_AXIS = MAXIMUM_MAP_SIZE_BIG / LITTER_INDEX_CELL_SIZE;
+static constexpr uint16_t LITTER_INDEX_CELL_NULL = std::numeric_limits<uint16_t>::max();
+static std::array<std::vector<uint16_t>, LITTER_INDEX_CELLS_PER_AXIS * LITTER_INDEX_CELLS_PER_AXIS> _litterIndex;
+static std::vector<uint16_t> _litterIndexCell;
+
 const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
                                         STR_LITTER_VOMIT,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_CAN,
@@ -46,11 +80,15 @@ const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_JUICE_CUP,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_BOWL_BLUE };
 
-static CoordsXYZ _spritelocations1[MAX_SPRITES];
-static CoordsXYZ _spritelocations2[MAX_SPRITES];
+static std::vector<CoordsXYZ> _spritelocations1;
+static std::vector<CoordsXYZ> _spritelocations2;
 
 static size_t GetSpatialIndexOffset(int32_t x, int32_t y);
 static void move_sprite_to_list(SpriteBase* sprite, SPRITE_LIST newListIndex);
+static void sprite_list_index_rebuild(int32_t listIndex);
+static void reset_litter_index();
+static void litter_index_insert(uint16_t spriteIndex, const CoordsXY& litterPos);
+static void litter_index_remove(uint16_t spriteIndex);
 
 // Required for GetEntity to return a default
 template<> bool SpriteBase::Is<SpriteBase>() const
@@ -96,9 +134,9 @@ std::string rct_sprite_checksum::ToString() const
 rct_sprite* try_get_sprite(size_t spriteIndex)
 {
     rct_sprite* sprite = nullptr;
-    if (spriteIndex < MAX_SPRITES)
+    if (spriteIndex < _spriteCapacity)
     {
-        sprite = &_spriteList[spriteIndex];
+        sprite = &_spriteBlocks[spriteIndex / SPRITE_BLOCK_SIZE][spriteIndex % SPRITE_BLOCK_SIZE];
     }
     return sprite;
 }
@@ -109,12 +147,12 @@ rct_sprite* get_sprite(size_t sprite_idx)
     {
         return nullptr;
     }
-    openrct2_assert(sprite_idx < MAX_SPRITES, "Tried getting sprite %u", sprite_idx);
-    if (sprite_idx >= MAX_SPRITES)
+    openrct2_assert(sprite_idx < _spriteCapacity, "Tried getting sprite %u", sprite_idx);
+    if (sprite_idx >= _spriteCapacity)
     {
         return nullptr;
     }
-    return &_spriteList[sprite_idx];
+    return &_spriteBlocks[sprite_idx / SPRITE_BLOCK_SIZE][sprite_idx % SPRITE_BLOCK_SIZE];
 }
 
 SpriteBase* GetEntity(size_t sprite_idx)
@@ -176,42 +214,209 @@ void SpriteBase::Invalidate2()
 void reset_sprite_list()
 {
     gSavedAge = 0;
-    std::memset(static_cast<void*>(_spriteList), 0, sizeof(_spriteList));
 
     for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
     {
         gSpriteListHead[i] = SPRITE_INDEX_NULL;
         gSpriteListCount[i] = 0;
-        _spriteFlashingList[i] = false;
     }
 
-    SpriteBase* previous_spr = nullptr;
+    // Blocks of a previous park are kept and cleared when the table grows into them again.
+    _spriteCapacity = 0;
+    sprite_grow_capacity(MAX_SPRITES_DEFAULT);
+
+    reset_sprite_list_index();
+    reset_sprite_spatial_index();
+}
+
+/**
+ * Number of sprites in the sprite table, all sprite indices are below this.
+ */
+uint16_t sprite_get_capacity()
+{
+    return _spriteCapacity;
+}
+
+/**
+ * Grows the sprite table to the given number of sprites (at most MAX_SPRITES_LIMIT). The new sprites are appended to
+ * the free list, existing sprites keep their address.
+ */
+void sprite_grow_capacity(uint16_t capacity)
+{
+    capacity = std::min(capacity, MAX_SPRITES_LIMIT);
+    if (capacity <= _spriteCapacity)
+    {
+        return;
+    }
+
+    if (_spriteBlocks.size() * SPRITE_BLOCK_SIZE < capacity)
+    {
+        while (_spriteBlocks.size() * SPRITE_BLOCK_SIZE < capacity)
+        {
+            _spriteBlocks.push_back(std::make_unique<rct_sprite[]>(SPRITE_BLOCK_SIZE));
+        }
 
-    for (int32_t i = 0; i < MAX_SPRITES; ++i)
+        // Per sprite data covers all allocated blocks, it never shrinks.
+        const size_t allocated = _spriteBlocks.size() * SPRITE_BLOCK_SIZE;
+        _spriteFlashingList.resize(allocated);
+        _spriteListIndexPosition.resize(allocated, SPRITE_LIST_INDEX_POSITION_NULL);
+        _litterIndexCell.resize(allocated, LITTER_INDEX_CELL_NULL);
+        _spritelocations1.resize(allocated);
+        _spritelocations2.resize(allocated);
+        _spriteChecksumInput.resize(allocated);
+        _spriteChecksumBlockDirty.resize(allocated / SPRITE_CHECKSUM_BLOCK_SIZE, true);
+        _spriteChecksumBlockHash.resize(allocated / SPRITE_CHECKSUM_BLOCK_SIZE);
+    }
+
+    // Append to the tail of the free list so that the lowest free sprites keep being used first.
+    uint16_t tail = SPRITE_INDEX_NULL;
+    for (uint16_t i = gSpriteListHead[SPRITE_LIST_FREE]; i != SPRITE_INDEX_NULL; i = GetEntity(i)->next)
+    {
+        tail = i;
+    }
+
+    const uint16_t oldCapacity = _spriteCapacity;
+    _spriteCapacity = capacity;
+    for (uint16_t i = oldCapacity; i < capacity; i++)
     {
         auto* spr = GetEntity(i);
+        std::memset(static_cast<void*>(spr), 0, sizeof(rct_sprite));
         spr->sprite_identifier = SPRITE_IDENTIFIER_NULL;
         spr->sprite_index = i;
         spr->next = SPRITE_INDEX_NULL;
+        spr->previous = tail;
         spr->linked_list_index = SPRITE_LIST_FREE;
 
-        if (previous_spr != nullptr)
+        if (tail == SPRITE_INDEX_NULL)
         {
-            spr->previous = previous_spr->sprite_index;
-            previous_spr->next = i;
+            gSpriteListHead[SPRITE_LIST_FREE] = i;
         }
         else
         {
-            spr->previous = SPRITE_INDEX_NULL;
-            gSpriteListHead[SPRITE_LIST_FREE] = i;
+            GetEntity(tail)->next = i;
         }
         _spriteFlashingList[i] = false;
-        previous_spr = spr;
+        _spritelocations1[i] = _spritelocations2[i] = {};
+        tail = i;
     }
+    gSpriteListCount[SPRITE_LIST_FREE] += capacity - oldCapacity;
 
-    gSpriteListCount[SPRITE_LIST_FREE] = MAX_SPRITES;
+    sprite_list_index_rebuild(SPRITE_LIST_FREE);
+}
 
-    reset_sprite_spatial_index();
+/**
+ * Highest number of sprites the sprite table can grow to. This is part of the game state as sprite creation
+ * depends on it.
+ */
+uint16_t sprite_get_limit()
+{
+    return _spriteLimit;
+}
+
+void sprite_set_limit(int32_t limit)
+{
+    // Sprites can not be removed from the table, so the limit can not go below its current size.
+    _spriteLimit = static_cast<uint16_t>(
+        std::clamp<int32_t>(limit, std::max(MAX_SPRITES_DEFAULT, _spriteCapacity), MAX_SPRITES_LIMIT));
+}
+
+/**
+ * Rebuilds the dense sprite list index from the sprite linked lists, required after the linked lists have been
+ * written directly, e.g. when importing a park.
+ */
+void reset_sprite_list_index()
+{
+    std::fill(_spriteListIndexPosition.begin(), _spriteListIndexPosition.end(), SPRITE_LIST_INDEX_POSITION_NULL);
+    for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
+    {
+        sprite_list_index_rebuild(i);
+    }
+    reset_litter_index();
+}
+
+static void sprite_list_index_rebuild(int32_t listIndex)
+{
+    auto& ids = _spriteListIndex[listIndex];
+    for (auto spriteIndex : ids)
+    {
+        if (spriteIndex != SPRITE_INDEX_NULL)
+        {
+            _spriteListIndexPosition[spriteIndex] = SPRITE_LIST_INDEX_POSITION_NULL;
+        }
+    }
+    ids.clear();
+
+    // Guard against cycles in corrupt lists, no list can be longer than the sprite count.
+    for (uint16_t spriteIndex = gSpriteListHead[listIndex]; spriteIndex != SPRITE_INDEX_NULL && ids.size() < _spriteCapacity;)
+    {
+        auto* sprite = GetEntity(spriteIndex);
+        if (sprite == nullptr)
+        {
+            break;
+        }
+        ids.push_back(spriteIndex);
+        spriteIndex = sprite->next;
+    }
+
+    std::reverse(ids.begin(), ids.end());
+    for (size_t j = 0; j < ids.size(); j++)
+    {
+        _spriteListIndexPosition[ids[j]] = static_cast<uint32_t>(j);
+    }
+    _spriteListIndexHasHoles[listIndex] = false;
+}
+
+/**
+ * Removes the holes left in the sprite list index by sprites that changed list. Must not be called while an
+ * EntityList is being iterated.
+ */
+void sprite_compact_list_index()
+{
+    for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
+    {
+        if (!_spriteListIndexHasHoles[i])
+        {
+            continue;
+        }
+
+        auto& ids = _spriteListIndex[i];
+        ids.erase(std::remove(ids.begin(), ids.end(), SPRITE_INDEX_NULL), ids.end());
+        for (size_t j = 0; j < ids.size(); j++)
+        {
+            _spriteListIndexPosition[ids[j]] = static_cast<uint32_t>(j);
+        }
+        _spriteListIndexHasHoles[i] = false;
+    }
+}
+
+/**
+ * Gets the sprite indices of a sprite list in reverse list order, removed sprites are SPRITE_INDEX_NULL.
+ */
+const std::vector<uint16_t>& sprite_get_list_index(SPRITE_LIST list)
+{
+    return _spriteListIndex[list];
+}
+
+static void sprite_list_index_remove(uint16_t spriteIndex, int32_t listIndex)
+{
+    auto position = _spriteListIndexPosition[spriteIndex];
+    if (listIndex < SPRITE_LIST_COUNT && position != SPRITE_LIST_INDEX_POSITION_NULL)
+    {
+        auto& ids = _spriteListIndex[listIndex];
+        if (position < ids.size() && ids[position] == spriteIndex)
+        {
+            ids[position] = SPRITE_INDEX_NULL;
+            _spriteListIndexHasHoles[listIndex] = true;
+        }
+    }
+    _spriteListIndexPosition[spriteIndex] = SPRITE_LIST_INDEX_POSITION_NULL;
+}
+
+static void sprite_list_index_add(uint16_t spriteIndex, int32_t listIndex)
+{
+    auto& ids = _spriteListIndex[listIndex];
+    _spriteListIndexPosition[spriteIndex] = static_cast<uint32_t>(ids.size());
+    ids.push_back(spriteIndex);
 }
 
 /**
@@ -223,7 +428,7 @@ void reset_sprite_list()
 void reset_sprite_spatial_index()
 {
     std::fill_n(gSpriteSpatialIndex, std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
-    for (size_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spriteCapacity; i++)
     {
         auto* spr = GetEntity(i);
         if (spr->sprite_identifier != SPRITE_IDENTIFIER_NULL)
@@ -258,7 +463,102 @@ static size_t GetSpatialIndexOffset(int32_t x, int32_t y)
 
 #ifndef DISABLE_NETWORK
 
-rct_sprite_checksum sprite_checksum()
+// Copy of a sprite as it goes into the checksum. Sprites that are not part of the checksum are cleared apart from their
+// sprite identifier, so that every copy of the same state is the same.
+static void sprite_checksum_make_input(size_t spriteIndex, rct_sprite& copy)
+{
+    // TODO create a way to copy only the specific type
+    auto sprite = get_sprite(spriteIndex);
+    if (sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
+        || sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_MISC)
+    {
+        std::memset(static_cast<void*>(&copy), 0, sizeof(copy));
+        copy.generic.sprite_identifier = sprite->generic.sprite_identifier;
+        return;
+    }
+
+    copy = *sprite;
+
+    // Only required for rendering/invalidation, has no meaning to the game state.
+    copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
+    copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
+
+    // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
+    while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
+    {
+        if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
+            copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
+        else
+            break;
+    }
+
+    if (copy.generic.Is<Peep>())
+    {
+        // Name is pointer and will not be the same across clients
+        copy.peep.Name = {};
+
+        // We set this to 0 because as soon the client selects a guest the window will remove the
+        // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
+        // game state.
+        copy.peep.WindowInvalidateFlags = 0;
+    }
+}
+
+static bool sprite_checksum_is_input(const rct_sprite& copy)
+{
+    return copy.generic.sprite_identifier != SPRITE_IDENTIFIER_NULL
+        && copy.generic.sprite_identifier != SPRITE_IDENTIFIER_MISC;
+}
+
+// Makes the copies of the sprites in a block again and marks the block as modified if any of them changed.
+static void sprite_checksum_update_block(size_t blockIndex)
+{
+    const size_t blockEnd = std::min<size_t>(_spriteCapacity, (blockIndex + 1) * SPRITE_CHECKSUM_BLOCK_SIZE);
+    for (size_t i = blockIndex * SPRITE_CHECKSUM_BLOCK_SIZE; i < blockEnd; i++)
+    {
+        rct_sprite copy;
+        sprite_checksum_make_input(i, copy);
+        if (std::memcmp(&copy, &_spriteChecksumInput[i], sizeof(copy)) != 0)
+        {
+            _spriteChecksumInput[i] = copy;
+            _spriteChecksumBlockDirty[blockIndex] = true;
+        }
+    }
+}
+
+static std::array<uint8_t, 20> sprite_checksum_hash_block(size_t blockIndex)
+{
+    using namespace Crypt;
+
+    // Blocks are hashed in parallel, every thread needs its own hash algorithm.
+    static thread_local std::unique_ptr<HashAlgorithm<20>> _blockHashAlg;
+    if (_blockHashAlg == nullptr)
+    {
+        _blockHashAlg = CreateSHA1();
+    }
+
+    _blockHashAlg->Clear();
+    const size_t blockEnd = std::min<size_t>(_spriteCapacity, (blockIndex + 1) * SPRITE_CHECKSUM_BLOCK_SIZE);
+    for (size_t i = blockIndex * SPRITE_CHECKSUM_BLOCK_SIZE; i < blockEnd; i++)
+    {
+        const auto& copy = _spriteChecksumInput[i];
+        if (sprite_checksum_is_input(copy))
+        {
+            _blockHashAlg->Update(&copy, sizeof(copy));
+        }
+    }
+    return _blockHashAlg->Finish();
+}
+
+/**
+ * Checksum of all game state relevant sprite data. The copies of all sprites are made again and compared with the
+ * previous ones in parallel, which catches every write to a sprite no matter where it was made.
+ *
+ * SpriteChecksumVersion::Blocks hashes every block of SPRITE_CHECKSUM_BLOCK_SIZE sprites and then the block hashes,
+ * only blocks that changed since they were last hashed are hashed again. SpriteChecksumVersion::Flat hashes all copies
+ * in sprite order, which is the checksum that replays recorded before the block hash was added.
+ */
+rct_sprite_checksum sprite_checksum(SpriteChecksumVersion version)
 {
     using namespace Crypt;
 
@@ -275,44 +575,32 @@ rct_sprite_checksum sprite_checksum()
             _spriteHashAlg = CreateSHA1();
         }
 
+        const size_t numBlocks = (_spriteCapacity + SPRITE_CHECKSUM_BLOCK_SIZE - 1) / SPRITE_CHECKSUM_BLOCK_SIZE;
+        JobPool::Get().ParallelFor(0, numBlocks, 1, [](size_t blockIndex) { sprite_checksum_update_block(blockIndex); });
+
         _spriteHashAlg->Clear();
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        if (version == SpriteChecksumVersion::Flat)
         {
-            // TODO create a way to copy only the specific type
-            auto sprite = get_sprite(i);
-            if (sprite->generic.sprite_identifier != SPRITE_IDENTIFIER_NULL
-                && sprite->generic.sprite_identifier != SPRITE_IDENTIFIER_MISC)
+            for (size_t i = 0; i < _spriteCapacity; i++)
             {
-                auto copy = *sprite;
-
-                // Only required for rendering/invalidation, has no meaning to the game state.
-                copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
-                copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
-
-                // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
-                while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
+                const auto& copy = _spriteChecksumInput[i];
+                if (sprite_checksum_is_input(copy))
                 {
-                    if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
-                        copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
-                    else
-                        break;
+                    _spriteHashAlg->Update(&copy, sizeof(copy));
                 }
-
-                if (copy.generic.Is<Peep>())
+            }
+        }
+        else
+        {
+            JobPool::Get().ParallelFor(0, numBlocks, 1, [](size_t blockIndex) {
+                if (_spriteChecksumBlockDirty[blockIndex])
                 {
-                    // Name is pointer and will not be the same across clients
-                    copy.peep.Name = {};
-
-                    // We set this to 0 because as soon the client selects a guest the window will remove the
-                    // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
-                    // game state.
-                    copy.peep.WindowInvalidateFlags = 0;
+                    _spriteChecksumBlockHash[blockIndex] = sprite_checksum_hash_block(blockIndex);
+                    _spriteChecksumBlockDirty[blockIndex] = false;
                 }
-
-                _spriteHashAlg->Update(&copy, sizeof(copy));
-            }
+            });
+            _spriteHashAlg->Update(_spriteChecksumBlockHash.data(), numBlocks * sizeof(_spriteChecksumBlockHash[0]));
         }
-
         checksum.raw = _spriteHashAlg->Finish();
     }
     catch (std::exception& e)
@@ -325,7 +613,7 @@ rct_sprite_checksum sprite_checksum()
 }
 #else
 
-rct_sprite_checksum sprite_checksum()
+rct_sprite_checksum sprite_checksum(SpriteChecksumVersion)
 {
     return rct_sprite_checksum{};
 }
@@ -380,6 +668,13 @@ static constexpr uint16_t MAX_MISC_SPRITES = 300;
 
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier, SPRITE_LIST linkedListIndex)
 {
+    if (gSpriteListCount[SPRITE_LIST_FREE] <= SPRITE_HEADROOM && _spriteCapacity < _spriteLimit)
+    {
+        // Grow by half of the current size so that growing is amortised.
+        auto capacity = std::min<uint32_t>(_spriteLimit, _spriteCapacity + _spriteCapacity / 2);
+        sprite_grow_capacity(static_cast<uint16_t>(capacity));
+    }
+
     if (gSpriteListCount[SPRITE_LIST_FREE] == 0)
     {
         // No free sprites.
@@ -493,6 +788,10 @@ static void move_sprite_to_list(SpriteBase* sprite, SPRITE_LIST newListIndex)
     // Decrement old list counter, increment new list counter.
     gSpriteListCount[oldListIndex]--;
     gSpriteListCount[newListIndex]++;
+
+    // The sprite became the head of its new list, which is the back of the index.
+    sprite_list_index_remove(sprite->sprite_index, oldListIndex);
+    sprite_list_index_add(sprite->sprite_index, newListIndex);
 }
 
 /**
@@ -706,6 +1005,12 @@ void SpriteBase::MoveTo(const CoordsXYZ& newLocation)
 
     SpriteSpatialMove(this, loc);
 
+    if (sprite_identifier == SPRITE_IDENTIFIER_LITTER)
+    {
+        litter_index_remove(sprite_index);
+        litter_index_insert(sprite_index, loc);
+    }
+
     if (loc.x == LOCATION_NULL)
     {
         sprite_left = LOCATION_NULL;
@@ -744,6 +1049,7 @@ void sprite_remove(SpriteBase* sprite)
         peep->SetName({});
     }
 
+    litter_index_remove(sprite->sprite_index);
     move_sprite_to_list(sprite, SPRITE_LIST_FREE);
     sprite->sprite_identifier = SPRITE_IDENTIFIER_NULL;
     _spriteFlashingList[sprite->sprite_index] = false;
@@ -758,6 +1064,81 @@ void sprite_remove(SpriteBase* sprite)
     *spriteIndex = sprite->next_in_quadrant;
 }
 
+static uint16_t litter_index_get_cell(const CoordsXY& litterPos)
+{
+    if (litterPos.x < 0 || litterPos.y < 0 || litterPos.x >= MAXIMUM_MAP_SIZE_BIG || litterPos.y >= MAXIMUM_MAP_SIZE_BIG)
+    {
+        return LITTER_INDEX_CELL_NULL;
+    }
+    return static_cast<uint16_t>(
+        (litterPos.x / LITTER_INDEX_CELL_SIZE) * LITTER_INDEX_CELLS_PER_AXIS + litterPos.y / LITTER_INDEX_CELL_SIZE);
+}
+
+static void litter_index_insert(uint16_t spriteIndex, const CoordsXY& litterPos)
+{
+    auto cellIndex = litter_index_get_cell(litterPos);
+    _litterIndexCell[spriteIndex] = cellIndex;
+    if (cellIndex != LITTER_INDEX_CELL_NULL)
+    {
+        auto& cell = _litterIndex[cellIndex];
+        cell.insert(std::upper_bound(cell.begin(), cell.end(), spriteIndex, std::greater<uint16_t>()), spriteIndex);
+    }
+}
+
+static void litter_index_remove(uint16_t spriteIndex)
+{
+    auto cellIndex = _litterIndexCell[spriteIndex];
+    if (cellIndex != LITTER_INDEX_CELL_NULL)
+    {
+        auto& cell = _litterIndex[cellIndex];
+        cell.erase(std::remove(cell.begin(), cell.end(), spriteIndex), cell.end());
+        _litterIndexCell[spriteIndex] = LITTER_INDEX_CELL_NULL;
+    }
+}
+
+/**
+ * Rebuilds the litter index from SPRITE_LIST_LITTER.
+ */
+static void reset_litter_index()
+{
+    for (auto& cell : _litterIndex)
+    {
+        cell.clear();
+    }
+    std::fill(_litterIndexCell.begin(), _litterIndexCell.end(), LITTER_INDEX_CELL_NULL);
+
+    for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
+    {
+        litter_index_insert(litter->sprite_index, { litter->x, litter->y });
+    }
+}
+
+template<typename TFunc> static void litter_index_for_each_cell(const MapRange& range, TFunc func)
+{
+    const int32_t left = std::clamp(range.GetLeft() / LITTER_INDEX_CELL_SIZE, 0, LITTER_INDEX_CELLS_PER_AXIS - 1);
+    const int32_t right = std::clamp(range.GetRight() / LITTER_INDEX_CELL_SIZE, 0, LITTER_INDEX_CELLS_PER_AXIS - 1);
+    const int32_t top = std::clamp(range.GetTop() / LITTER_INDEX_CELL_SIZE, 0, LITTER_INDEX_CELLS_PER_AXIS - 1);
+    const int32_t bottom = std::clamp(range.GetBottom() / LITTER_INDEX_CELL_SIZE, 0, LITTER_INDEX_CELLS_PER_AXIS - 1);
+    if (range.GetRight() < 0 || range.GetBottom() < 0)
+    {
+        return;
+    }
+
+    for (int32_t cellX = left; cellX <= right; cellX++)
+    {
+        for (int32_t cellY = top; cellY <= bottom; cellY++)
+        {
+            func(_litterIndex[cellX * LITTER_INDEX_CELLS_PER_AXIS + cellY]);
+        }
+    }
+}
+
+static bool litter_is_in_range(const Litter* litter, const MapRange& range)
+{
+    return litter->x >= range.GetLeft() && litter->x <= range.GetRight() && litter->y >= range.GetTop()
+        && litter->y <= range.GetBottom();
+}
+
 static bool litter_can_be_at(const CoordsXYZ& mapPos)
 {
     TileElement* tileElement;
@@ -839,19 +1220,114 @@ void litter_create(const CoordsXYZD& litterPos, int32_t type)
  */
 void litter_remove_at(const CoordsXYZ& litterPos)
 {
-    for (auto litter : EntityTileList<Litter>(litterPos))
-    {
-        if (abs(litter->z - litterPos.z) <= 16)
+    // Removing litter changes the index, collect it first. A tile is always within a single cell, so this keeps the
+    // order of the spatial index and the sprites are freed in the same order as before.
+    std::vector<Litter*> litterToRemove;
+    const auto tile = CoordsXY{ litterPos }.ToTileStart();
+    const MapRange tileRange(tile.x, tile.y, tile.x + COORDS_XY_STEP - 1, tile.y + COORDS_XY_STEP - 1);
+    litter_index_for_each_cell(tileRange, [&](const std::vector<uint16_t>& cell) {
+        for (auto spriteIndex : cell)
         {
-            if (abs(litter->x - litterPos.x) <= 8 && abs(litter->y - litterPos.y) <= 8)
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter == nullptr || !litter_is_in_range(litter, tileRange))
+                continue;
+
+            if (abs(litter->z - litterPos.z) <= 16)
             {
-                litter->Invalidate0();
-                sprite_remove(litter);
+                if (abs(litter->x - litterPos.x) <= 8 && abs(litter->y - litterPos.y) <= 8)
+                {
+                    litterToRemove.push_back(litter);
+                }
             }
         }
+    });
+
+    for (auto litter : litterToRemove)
+    {
+        litter->Invalidate0();
+        sprite_remove(litter);
     }
 }
 
+/**
+ * Finds the litter closest to the given position, a difference in height counts four times. Litter further away than
+ * maxDistance is ignored. Of litter at the same distance, the one that comes first in SPRITE_LIST_LITTER is returned.
+ */
+Litter* litter_get_nearest(const CoordsXYZ& litterPos, int32_t maxDistance)
+{
+    Litter* nearestLitter = nullptr;
+    int32_t nearestDistance = maxDistance;
+    uint32_t nearestListPosition = 0;
+
+    const MapRange range(
+        litterPos.x - maxDistance, litterPos.y - maxDistance, litterPos.x + maxDistance, litterPos.y + maxDistance);
+    litter_index_for_each_cell(range, [&](const std::vector<uint16_t>& cell) {
+        for (auto spriteIndex : cell)
+        {
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter == nullptr)
+                continue;
+
+            int32_t distance = abs(litter->x - litterPos.x) + abs(litter->y - litterPos.y) + abs(litter->z - litterPos.z) * 4;
+            if (distance > nearestDistance)
+                continue;
+
+            // EntityList visits the highest list index positions first.
+            uint32_t listPosition = _spriteListIndexPosition[spriteIndex];
+            if (nearestLitter == nullptr || distance < nearestDistance || listPosition > nearestListPosition)
+            {
+                nearestLitter = litter;
+                nearestDistance = distance;
+                nearestListPosition = listPosition;
+            }
+        }
+    });
+    return nearestLitter;
+}
+
+/**
+ * Finds the litter with the highest sprite index within the range (inclusive) that matches the predicate. For a range
+ * within a single tile this is the first matching litter of EntityTileList.
+ */
+Litter* litter_get_first_in_range(const MapRange& range, const std::function<bool(const Litter*)>& predicate)
+{
+    Litter* result = nullptr;
+    litter_index_for_each_cell(range, [&](const std::vector<uint16_t>& cell) {
+        for (auto spriteIndex : cell)
+        {
+            if (result != nullptr && spriteIndex < result->sprite_index)
+                break;
+
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter != nullptr && litter_is_in_range(litter, range) && predicate(litter))
+            {
+                result = litter;
+                break;
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * Counts the litter within the range (inclusive), only litter matching the predicate when one is given.
+ */
+int32_t litter_count_in_range(const MapRange& range, const std::function<bool(const Litter*)>& predicate)
+{
+    int32_t count = 0;
+    litter_index_for_each_cell(range, [&](const std::vector<uint16_t>& cell) {
+        for (auto spriteIndex : cell)
+        {
+            auto* litter = GetEntity<Litter>(spriteIndex);
+            if (litter != nullptr && litter_is_in_range(litter, range) && (predicate == nullptr || predicate(litter)))
+            {
+                count++;
+            }
+        }
+    });
+    return count;
+}
+
 /**
  * Loops through all sprites, finds floating objects and removes them.
  * Returns the amount of removed objects as feedback.
@@ -859,7 +1335,7 @@ void litter_remove_at(const CoordsXYZ& litterPos)
 uint16_t remove_floating_sprites()
 {
     uint16_t removed = 0;
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (uint16_t i = 0; i < _spriteCapacity; i++)
     {
         auto* entity = GetEntity(i);
         if (entity->Is<Balloon>())
@@ -899,13 +1375,13 @@ static bool sprite_should_tween(SpriteBase* sprite)
     return false;
 }
 
-static void store_sprite_locations(CoordsXYZ* sprite_locations)
+static void store_sprite_locations(std::vector<CoordsXYZ>& sprite_locations)
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (uint16_t i = 0; i < _spriteCapacity; i++)
     {
         // skip going through `get_sprite` to not get stalled on assert,
         // this can get very expensive for busy parks with uncap FPS option on
-        const rct_sprite* sprite = &_spriteList[i];
+        const rct_sprite* sprite = &_spriteBlocks[i / SPRITE_BLOCK_SIZE][i % SPRITE_BLOCK_SIZE];
         sprite_locations[i].x = sprite->generic.x;
         sprite_locations[i].y = sprite->generic.y;
         sprite_locations[i].z = sprite->generic.z;
@@ -926,7 +1402,7 @@ void sprite_position_tween_all(float alpha)
 {
     const float inv = (1.0f - alpha);
 
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (uint16_t i = 0; i < _spriteCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite_should_tween(sprite))
@@ -952,7 +1428,7 @@ void sprite_position_tween_all(float alpha)
  */
 void sprite_position_tween_restore()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (uint16_t i = 0; i < _spriteCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite_should_tween(sprite))
@@ -967,7 +1443,7 @@ void sprite_position_tween_restore()
 
 void sprite_position_tween_reset()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (uint16_t i = 0; i < _spriteCapacity; i++)
     {
         auto* sprite = GetEntity(i);
         _spritelocations1[i].x = _spritelocations2[i].x = sprite->x;
@@ -978,13 +1454,13 @@ void sprite_position_tween_reset()
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _spriteCapacity);
     _spriteFlashingList[sprite->sprite_index] = flashing;
 }
 
 bool sprite_get_flashing(SpriteBase* sprite)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _spriteCapacity);
     return _spriteFlashingList[sprite->sprite_index];
 }
 
@@ -1062,8 +1538,11 @@ static SpriteBase* find_sprite_quadrant_cycle(uint16_t sprite_idx)
 
 static bool index_is_in_list(uint16_t index, enum SPRITE_LIST sl)
 {
-    for (auto entity : EntityList(sl))
+    // Walk the linked list itself, it is being repaired so the list index can not be used.
+    using LinkedListIterator = EntityIterator<SpriteBase, &SpriteBase::next>;
+    for (auto it = LinkedListIterator(gSpriteListHead[sl]); it != LinkedListIterator(SPRITE_INDEX_NULL); ++it)
     {
+        auto entity = *it;
         if (entity->sprite_index == index)
         {
             return true;
@@ -1103,6 +1582,7 @@ int32_t check_for_sprite_list_cycles(bool fix)
                     spr->next = SPRITE_INDEX_NULL;
                     cycle_start = spr;
                 }
+                reset_sprite_list_index();
             }
             return i;
         }
@@ -1118,7 +1598,7 @@ int32_t check_for_sprite_list_cycles(bool fix)
 int32_t fix_disjoint_sprites()
 {
     // Find reachable sprites
-    bool reachable[MAX_SPRITES] = { false };
+    std::vector<bool> reachable(_spriteCapacity, false);
 
     SpriteBase* null_list_tail = nullptr;
     for (uint16_t sprite_idx = gSpriteListHead[SPRITE_LIST_FREE]; sprite_idx != SPRITE_INDEX_NULL;)
@@ -1132,7 +1612,7 @@ int32_t fix_disjoint_sprites()
     int32_t count = 0;
 
     // Find all null sprites
-    for (uint16_t sprite_idx = 0; sprite_idx < MAX_SPRITES; sprite_idx++)
+    for (uint16_t sprite_idx = 0; sprite_idx < _spriteCapacity; sprite_idx++)
     {
         auto* spr = GetEntity(sprite_idx);
         if (spr->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1151,6 +1631,11 @@ int32_t fix_disjoint_sprites()
             }
         }
     }
+
+    if (count > 0)
+    {
+        reset_sprite_list_index();
+    }
     return count;
 }
 
@@ -16,8 +16,15 @@
 #include "Fountain.h"
 #include "SpriteBase.h"
 
+#include <functional>
+#include <vector>
+
 #define SPRITE_INDEX_NULL 0xFFFF
-#define MAX_SPRITES 10000
+
+// Number of sprites a park starts with, the same as RCT2. The sprite table grows beyond this up to the sprite limit.
+constexpr const uint16_t MAX_SPRITES_DEFAULT = 10000;
+// Highest possible sprite limit, sprite indices are 16 bit with SPRITE_INDEX_NULL reserved.
+constexpr const uint16_t MAX_SPRITES_LIMIT = 65000;
 
 enum SPRITE_IDENTIFIER
 {
@@ -211,16 +218,27 @@ extern uint16_t gSpriteSpatialIndex[SPATIAL_INDEX_SIZE];
 
 extern const rct_string_id litterNames[12];
 
+uint16_t sprite_get_capacity();
+void sprite_grow_capacity(uint16_t capacity);
+uint16_t sprite_get_limit();
+void sprite_set_limit(int32_t limit);
+
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier);
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier, SPRITE_LIST linkedListIndex);
 void reset_sprite_list();
 void reset_sprite_spatial_index();
+void reset_sprite_list_index();
+void sprite_compact_list_index();
+const std::vector<uint16_t>& sprite_get_list_index(SPRITE_LIST list);
 void sprite_clear_all_unused();
 void sprite_misc_update_all();
 void sprite_set_coordinates(const CoordsXYZ& spritePos, SpriteBase* sprite);
 void sprite_remove(SpriteBase* sprite);
 void litter_create(const CoordsXYZD& litterPos, int32_t type);
 void litter_remove_at(const CoordsXYZ& litterPos);
+Litter* litter_get_nearest(const CoordsXYZ& litterPos, int32_t maxDistance);
+Litter* litter_get_first_in_range(const MapRange& range, const std::function<bool(const Litter*)>& predicate);
+int32_t litter_count_in_range(const MapRange& range, const std::function<bool(const Litter*)>& predicate = nullptr);
 uint16_t remove_floating_sprites();
 void sprite_misc_explosion_cloud_create(const CoordsXYZ& cloudPos);
 void sprite_misc_explosion_flare_create(const CoordsXYZ& flarePos);
@@ -254,7 +272,13 @@ void crashed_vehicle_particle_update(VehicleCrashParticle* particle);
 void crash_splash_create(const CoordsXYZ& splashPos);
 void crash_splash_update(CrashSplashParticle* splash);
 
-rct_sprite_checksum sprite_checksum();
+enum class SpriteChecksumVersion : uint8_t
+{
+    Flat,   // One hash over all sprites, as recorded by replays before version 7
+    Blocks, // Hash of the hashes of blocks of sprites
+};
+
+rct_sprite_checksum sprite_checksum(SpriteChecksumVersion version = SpriteChecksumVersion::Blocks);
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing);
 bool sprite_get_flashing(SpriteBase* sprite);
@@ -340,25 +364,112 @@ public:
     }
 };
 
+/**
+ * Iterates the dense index of a sprite list (see sprite_get_list_index) from the back, which is the head of the list.
+ * Visits the same sprites as following the next links. The sprite after the current one is taken when the current one
+ * is visited, and it is visited even if it leaves the list meanwhile. If the next link of a sprite does not match the
+ * index, because that sprite has left the list, the next links are followed from there on. Other sprites that leave
+ * the list before they are reached are skipped, sprites that join the list are not visited.
+ */
+template<typename T> class EntityListIterator
+{
+private:
+    // Null once the next links are followed instead
+    const std::vector<uint16_t>* Ids = nullptr;
+    // Position of NextEntityId in Ids
+    size_t Position = 0;
+    uint16_t NextEntityId = SPRITE_INDEX_NULL;
+    T* Entity = nullptr;
+
+    void TakeNextId()
+    {
+        NextEntityId = SPRITE_INDEX_NULL;
+        while (Position > 0 && NextEntityId == SPRITE_INDEX_NULL)
+        {
+            Position--;
+            NextEntityId = (*Ids)[Position];
+        }
+    }
+
+public:
+    EntityListIterator(const std::vector<uint16_t>* ids, size_t position)
+        : Ids(ids)
+        , Position(position)
+    {
+        TakeNextId();
+        ++(*this);
+    }
+    EntityListIterator& operator++()
+    {
+        Entity = nullptr;
+
+        while (NextEntityId != SPRITE_INDEX_NULL && Entity == nullptr)
+        {
+            auto baseEntity = GetEntity(NextEntityId);
+            if (!baseEntity)
+            {
+                NextEntityId = SPRITE_INDEX_NULL;
+                continue;
+            }
+            if (Ids != nullptr)
+            {
+                TakeNextId();
+                if (NextEntityId != baseEntity->next)
+                {
+                    // The sprite has left the list, its next link leads into the list it moved to.
+                    Ids = nullptr;
+                }
+            }
+            NextEntityId = baseEntity->next;
+            Entity = baseEntity->template As<T>();
+        }
+        return *this;
+    }
+
+    EntityListIterator operator++(int)
+    {
+        EntityListIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(EntityListIterator other) const
+    {
+        return Entity == other.Entity;
+    }
+    bool operator!=(EntityListIterator other) const
+    {
+        return !(*this == other);
+    }
+    T* operator*()
+    {
+        return Entity;
+    }
+    // iterator traits
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T*;
+    using reference = const T&;
+    using iterator_category = std::forward_iterator_tag;
+};
+
 template<typename T = SpriteBase> class EntityList
 {
 private:
-    uint16_t FirstEntity = SPRITE_INDEX_NULL;
-    using EntityListIterator = EntityIterator<T, &SpriteBase::next>;
+    const std::vector<uint16_t>* Ids = nullptr;
 
 public:
     EntityList(SPRITE_LIST type)
-        : FirstEntity(gSpriteListHead[type])
+        : Ids(&sprite_get_list_index(type))
     {
     }
 
-    EntityListIterator begin()
+    EntityListIterator<T> begin()
     {
-        return EntityListIterator(FirstEntity);
+        return EntityListIterator<T>(Ids, Ids->size());
     }
-    EntityListIterator end()
+    EntityListIterator<T> end()
     {
-        return EntityListIterator(SPRITE_INDEX_NULL);
+        return EntityListIterator<T>(Ids, 0);
     }
 };
 
@@ -17,6 +17,7 @@
 #include "../interface/Window.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
+#include "../ride/RideFootprint.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../windows/Intent.h"
@@ -220,6 +221,7 @@ GameActionResult::Ptr tile_inspector_remove_element_at(const CoordsXY& loc, int1
         }
 
         tile_element_remove(tileElement);
+        ride_footprint_update_tile(loc);
         map_invalidate_tile_full(loc);
 
         // Update the window
@@ -392,6 +394,7 @@ GameActionResult::Ptr tile_inspector_paste_element_at(const CoordsXY& loc, TileE
         bool lastForTile = pastedElement->IsLastForTile();
         *pastedElement = element;
         pastedElement->SetLastForTile(lastForTile);
+        ride_footprint_update_tile(loc);
 
         map_invalidate_tile_full(loc);
 
@@ -158,7 +158,7 @@ template<> bool SpriteBase::Is<Peep>() const
 
 rct_sprite* get_sprite(size_t sprite_idx)
 {
-    assert(sprite_idx < MAX_SPRITES);
+    assert(sprite_idx < MAX_SPRITES_DEFAULT);
     return &sprite_list[sprite_idx];
 }
 
@@ -0,0 +1,331 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/SpriteCache.h>
+#include <openrct2/sprites.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2::Drawing;
+
+class DrawingTests : public testing::Test
+{
+protected:
+    uint8_t _map[256]{};
+    std::vector<uint8_t> _src;
+
+    void SetUp() override
+    {
+        // Normally selected by core_init
+        remap_span_init();
+
+        std::mt19937 random(42);
+        for (auto& entry : _map)
+        {
+            entry = static_cast<uint8_t>(random());
+        }
+        _src.resize(300);
+        for (auto& colour : _src)
+        {
+            colour = static_cast<uint8_t>(random());
+        }
+    }
+
+    // Encodes rows of pixels as an RLE image, pixels of 0 are left out
+    static std::vector<uint8_t> EncodeRLE(const std::vector<std::vector<uint8_t>>& rows)
+    {
+        std::vector<uint8_t> data(rows.size() * 2);
+        for (size_t y = 0; y < rows.size(); y++)
+        {
+            data[y * 2] = static_cast<uint8_t>(data.size());
+            data[y * 2 + 1] = static_cast<uint8_t>(data.size() >> 8);
+
+            const auto& row = rows[y];
+            std::vector<std::pair<size_t, size_t>> runs;
+            for (size_t x = 0; x < row.size(); x++)
+            {
+                if (row[x] != 0 && (runs.empty() || runs.back().first + runs.back().second != x))
+                    runs.emplace_back(x, 0);
+                if (row[x] != 0)
+                    runs.back().second++;
+            }
+            if (runs.empty())
+                runs.emplace_back(0, 0);
+            for (size_t i = 0; i < runs.size(); i++)
+            {
+                data.push_back(static_cast<uint8_t>(runs[i].second | (i == runs.size() - 1 ? 0x80 : 0)));
+                data.push_back(static_cast<uint8_t>(runs[i].first));
+                data.insert(data.end(), row.begin() + runs[i].first, row.begin() + runs[i].first + runs[i].second);
+            }
+        }
+        return data;
+    }
+
+    // Images of 16x16 opaque pixels, each with its own data
+    static std::vector<std::vector<uint8_t>> CreateTestImages(std::vector<rct_g1_element>& elements, size_t count)
+    {
+        std::vector<std::vector<uint8_t>> data;
+        for (size_t i = 0; i < count; i++)
+        {
+            data.push_back(EncodeRLE(std::vector<std::vector<uint8_t>>(16, std::vector<uint8_t>(16, 1))));
+        }
+        elements.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            elements[i] = {};
+            elements[i].offset = data[i].data();
+            elements[i].width = 16;
+            elements[i].height = 16;
+            elements[i].flags = G1_FLAG_RLE_COMPRESSION;
+        }
+        return data;
+    }
+
+    void TestRemapSpan(void (*remapFn)(const uint8_t*, uint8_t*, int32_t, const uint8_t*))
+    {
+        // Cover every length around the vector widths, including a tail after full vectors
+        for (int32_t length = 0; length < static_cast<int32_t>(_src.size()); length++)
+        {
+            std::vector<uint8_t> dst(_src.size(), 0xAA);
+            remapFn(_src.data(), dst.data(), length, _map);
+            for (int32_t i = 0; i < length; i++)
+            {
+                ASSERT_EQ(dst[i], _map[_src[i]]) << "length " << length << ", index " << i;
+            }
+            ASSERT_EQ(dst[length], 0xAA);
+
+            // In place, as used for glass
+            std::vector<uint8_t> inPlace(_src.begin(), _src.begin() + length);
+            remapFn(inPlace.data(), inPlace.data(), length, _map);
+            ASSERT_TRUE(std::equal(inPlace.begin(), inPlace.end(), dst.begin()));
+        }
+    }
+};
+
+TEST_F(DrawingTests, RemapSpanScalar)
+{
+    TestRemapSpan(remap_span_scalar);
+}
+
+TEST_F(DrawingTests, RemapSpanAVX2)
+{
+    if (!avx2_available())
+    {
+        return;
+    }
+    TestRemapSpan(remap_span_avx2);
+}
+
+TEST_F(DrawingTests, CachedSpriteMatchesRLE)
+{
+    std::mt19937 random(7);
+    std::vector<std::vector<uint8_t>> rows(40, std::vector<uint8_t>(60));
+    for (auto& row : rows)
+    {
+        for (auto& colour : row)
+        {
+            colour = (random() % 3) == 0 ? 0 : static_cast<uint8_t>(random());
+        }
+    }
+    auto data = EncodeRLE(rows);
+
+    rct_g1_element g1{};
+    g1.offset = data.data();
+    g1.width = 60;
+    g1.height = 40;
+    g1.flags = G1_FLAG_RLE_COMPRESSION;
+
+    const uint32_t imageIndex = SPR_IMAGE_LIST_BEGIN + 1;
+    const PaletteMap paletteMap(_map);
+    for (int8_t zoom = 0; zoom <= 2; zoom++)
+    {
+        // Opaque, remapped and glass
+        for (auto imageType : { IMAGE_TYPE_DEFAULT, IMAGE_TYPE_REMAP, IMAGE_TYPE_TRANSPARENT })
+        {
+            const auto image = ImageId::FromUInt32(imageIndex | imageType);
+
+            rct_drawpixelinfo dpi{};
+            dpi.width = 64;
+            dpi.height = 48;
+            dpi.pitch = 3;
+            dpi.zoom_level = zoom;
+            const size_t bufferSize = ((dpi.width >> zoom) + dpi.pitch) * (dpi.height >> zoom);
+
+            // Images are only cached when they miss twice, so the first draw decodes the RLE data and the second one
+            // draws the newly cached image
+            SpriteCache::Get().Invalidate(imageIndex);
+            std::vector<uint8_t> buffers[2];
+            for (auto& buffer : buffers)
+            {
+                buffer.assign(bufferSize, 0x55);
+                dpi.bits = buffer.data();
+                DrawSpriteArgs args(&dpi, image, paletteMap, g1, 3, 2, 55, 36, buffer.data());
+                gfx_rle_sprite_to_buffer(args);
+            }
+            ASSERT_NE(SpriteCache::Get().GetOrAdd(imageIndex, g1), nullptr);
+            ASSERT_EQ(buffers[0], buffers[1]) << "zoom " << static_cast<int32_t>(zoom) << ", type " << imageType;
+        }
+    }
+}
+
+TEST_F(DrawingTests, MagnifiedRLESprite)
+{
+    std::mt19937 random(11);
+    std::vector<std::vector<uint8_t>> rows(24, std::vector<uint8_t>(40));
+    for (auto& row : rows)
+    {
+        for (auto& colour : row)
+        {
+            colour = (random() % 3) == 0 ? 0 : static_cast<uint8_t>(random());
+        }
+    }
+    auto data = EncodeRLE(rows);
+
+    rct_g1_element g1{};
+    g1.offset = data.data();
+    g1.width = 40;
+    g1.height = 24;
+    g1.flags = G1_FLAG_RLE_COMPRESSION;
+
+    const int32_t srcX = 3;
+    const int32_t srcY = 2;
+    const int32_t width = 30;
+    const int32_t height = 18;
+    const PaletteMap paletteMap(_map);
+    for (int8_t zoom = -1; zoom >= -2; zoom--)
+    {
+        // Opaque, remapped and glass
+        for (auto imageType : { IMAGE_TYPE_DEFAULT, IMAGE_TYPE_REMAP, IMAGE_TYPE_TRANSPARENT })
+        {
+            const auto image = ImageId::FromUInt32((SPR_IMAGE_LIST_BEGIN + 1) | imageType);
+            const int32_t scale = 1 << -zoom;
+
+            rct_drawpixelinfo dpi{};
+            dpi.width = 32;
+            dpi.height = 20;
+            dpi.pitch = 5;
+            dpi.zoom_level = zoom;
+            const int32_t lineWidth = dpi.width * scale + dpi.pitch;
+
+            std::vector<uint8_t> background(lineWidth * dpi.height * scale);
+            for (auto& colour : background)
+            {
+                colour = static_cast<uint8_t>(random());
+            }
+            auto buffer = background;
+            dpi.bits = buffer.data();
+            DrawSpriteArgs args(&dpi, image, paletteMap, g1, srcX, srcY, width, height, buffer.data());
+            gfx_rle_sprite_to_buffer(args);
+
+            // Every source pixel covers a square of scale x scale pixels, transparent ones and everything outside the
+            // image keep the background
+            for (int32_t y = 0; y < dpi.height * scale; y++)
+            {
+                for (int32_t x = 0; x < lineWidth; x++)
+                {
+                    const size_t index = y * lineWidth + x;
+                    uint8_t expected = background[index];
+                    if (x < width * scale && y < height * scale)
+                    {
+                        uint8_t colour = rows[srcY + y / scale][srcX + x / scale];
+                        if (colour != 0)
+                        {
+                            if (imageType == IMAGE_TYPE_DEFAULT)
+                                expected = colour;
+                            else if (imageType == IMAGE_TYPE_REMAP)
+                                expected = _map[colour];
+                            else
+                                expected = _map[background[index]];
+                        }
+                    }
+                    ASSERT_EQ(buffer[index], expected) << "zoom " << static_cast<int32_t>(zoom) << ", type " << imageType
+                                                       << ", x " << x << ", y " << y;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(DrawingTests, SpriteCacheEvictsOverBudget)
+{
+    std::vector<rct_g1_element> g1;
+    auto data = CreateTestImages(g1, 5);
+    const size_t entrySize = SpriteCache::Decode(g1[0])->GetMemoryUsage();
+
+    // Images are admitted on their second miss
+    SpriteCache cache(entrySize * 3);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + i, g1[i]), nullptr);
+        ASSERT_NE(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + i, g1[i]), nullptr);
+    }
+    auto stats = cache.GetStats();
+    ASSERT_EQ(stats.Entries, 3U);
+    ASSERT_EQ(stats.MemoryUsage, entrySize * 3);
+    ASSERT_EQ(stats.Evictions, 0U);
+
+    // The oldest image has been used since, so it gets a second chance and the next oldest one is evicted
+    ASSERT_NE(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 0, g1[0]), nullptr);
+    cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 3, g1[3]);
+    cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 3, g1[3]);
+    stats = cache.GetStats();
+    ASSERT_EQ(stats.Entries, 3U);
+    ASSERT_EQ(stats.Evictions, 1U);
+    ASSERT_LE(stats.MemoryUsage, stats.MemoryBudget);
+
+    const uint64_t hits = stats.Hits;
+    ASSERT_NE(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 0, g1[0]), nullptr);
+    ASSERT_EQ(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 1, g1[1]), nullptr);
+    ASSERT_NE(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 2, g1[2]), nullptr);
+    ASSERT_NE(cache.GetOrAdd(SPR_IMAGE_LIST_BEGIN + 3, g1[3]), nullptr);
+    ASSERT_EQ(cache.GetStats().Hits, hits + 3);
+
+    // Lowering the budget evicts down to it
+    cache.SetMemoryBudget(entrySize);
+    stats = cache.GetStats();
+    ASSERT_EQ(stats.Entries, 1U);
+    ASSERT_EQ(stats.MemoryUsage, entrySize);
+}
+
+TEST_F(DrawingTests, SpriteCacheInvalidate)
+{
+    std::vector<rct_g1_element> g1;
+    auto data = CreateTestImages(g1, 2);
+    const uint32_t imageIndex = SPR_IMAGE_LIST_BEGIN;
+
+    SpriteCache cache;
+    cache.GetOrAdd(imageIndex, g1[0]);
+    auto sprite = cache.GetOrAdd(imageIndex, g1[0]);
+    ASSERT_NE(sprite, nullptr);
+    ASSERT_EQ(sprite->Source, g1[0].offset);
+
+    // An invalidated image has to miss twice again before it is cached
+    cache.Invalidate(imageIndex);
+    ASSERT_EQ(cache.GetStats().Entries, 0U);
+    ASSERT_EQ(cache.GetStats().MemoryUsage, 0U);
+    ASSERT_EQ(cache.GetOrAdd(imageIndex, g1[0]), nullptr);
+    ASSERT_NE(cache.GetOrAdd(imageIndex, g1[0]), nullptr);
+
+    // The sprite handed out before stays valid
+    ASSERT_EQ(sprite->Width, 16);
+
+    // An image replaced without invalidating it is not served from the stale entry
+    ASSERT_EQ(cache.GetOrAdd(imageIndex, g1[1]), nullptr);
+    ASSERT_EQ(cache.GetStats().Entries, 0U);
+    sprite = cache.GetOrAdd(imageIndex, g1[1]);
+    ASSERT_NE(sprite, nullptr);
+    ASSERT_EQ(sprite->Source, g1[1].offset);
+
+    cache.Clear();
+    ASSERT_EQ(cache.GetStats().Entries, 0U);
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/DataSerialiser.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/world/Sprite.h>
+#include <algorithm>
+#include <string>
+
+using namespace OpenRCT2;
+
+static bool HasSpriteChanges(const GameStateCompareData_t& cmpData)
+{
+    return std::any_of(cmpData.spriteChanges.begin(), cmpData.spriteChanges.end(), [](const GameStateSpriteChange_t& diff) {
+        return diff.changeType != GameStateSpriteChange_t::EQUAL;
+    });
+}
+
+TEST(GameStateSnapshotDeltas, all)
+{
+    auto context = StartTestGame(TestData::GetParkPath("BigMapTest.sv6"));
+    ASSERT_NE(context, nullptr);
+
+    IGameStateSnapshots* snapshots = context->GetGameStateSnapshots();
+    snapshots->Reset();
+
+    // Spans more than one keyframe interval.
+    const uint32_t firstTick = gCurrentTicks + 20;
+    for (int i = 0; i < 40; i++)
+    {
+        AdvanceGameTicks(1, *context);
+        auto& snapshot = snapshots->CreateSnapshot();
+        snapshots->Capture(snapshot);
+        snapshots->LinkSnapshot(snapshot, gCurrentTicks, 0);
+    }
+    const uint32_t lastTick = gCurrentTicks;
+
+    const GameStateSnapshot_t* firstSnapshot = snapshots->GetLinkedSnapshot(firstTick);
+    const GameStateSnapshot_t* lastSnapshot = snapshots->GetLinkedSnapshot(lastTick);
+    ASSERT_NE(firstSnapshot, nullptr);
+    ASSERT_NE(lastSnapshot, nullptr);
+
+    // Round trip the deltas leading up to the last snapshot.
+    MemoryStream deltaBuffer;
+    {
+        DataSerialiser ds(true, deltaBuffer);
+        snapshots->SerialiseSnapshotDeltas(const_cast<GameStateSnapshot_t&>(*lastSnapshot), ds);
+    }
+    deltaBuffer.SetPosition(0);
+    DataSerialiser dsDeltas(false, deltaBuffer);
+    auto& deltaSnapshot = snapshots->CreateSnapshot();
+    snapshots->SerialiseSnapshotDeltas(deltaSnapshot, dsDeltas);
+
+    // Round trip the resolved last snapshot.
+    MemoryStream fullBuffer;
+    {
+        DataSerialiser ds(true, fullBuffer);
+        snapshots->SerialiseSnapshot(const_cast<GameStateSnapshot_t&>(*snapshots->GetLinkedSnapshot(lastTick)), ds);
+    }
+    fullBuffer.SetPosition(0);
+    DataSerialiser dsFull(false, fullBuffer);
+    auto& fullSnapshot = snapshots->CreateSnapshot();
+    snapshots->SerialiseSnapshot(fullSnapshot, dsFull);
+
+    auto& currentSnapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(currentSnapshot);
+
+    EXPECT_FALSE(HasSpriteChanges(snapshots->Compare(deltaSnapshot, currentSnapshot)));
+    EXPECT_FALSE(HasSpriteChanges(snapshots->Compare(fullSnapshot, currentSnapshot)));
+    EXPECT_TRUE(HasSpriteChanges(snapshots->Compare(*snapshots->GetLinkedSnapshot(firstTick), currentSnapshot)));
+
+    // Snapshots that share a keyframe are compared through the sprites their delta records touch, the result has to
+    // match comparing copies of them that stand on their own.
+    auto resolveSnapshot = [&](uint32_t tick) -> GameStateSnapshot_t& {
+        MemoryStream buffer;
+        {
+            DataSerialiser ds(true, buffer);
+            snapshots->SerialiseSnapshot(const_cast<GameStateSnapshot_t&>(*snapshots->GetLinkedSnapshot(tick)), ds);
+        }
+        buffer.SetPosition(0);
+        DataSerialiser ds(false, buffer);
+        auto& resolved = snapshots->CreateSnapshot();
+        snapshots->SerialiseSnapshot(resolved, ds);
+        return resolved;
+    };
+    for (uint32_t tick : { lastTick - 3, firstTick })
+    {
+        auto linkedData = snapshots->Compare(*snapshots->GetLinkedSnapshot(tick), *lastSnapshot);
+        auto resolvedData = snapshots->Compare(resolveSnapshot(tick), resolveSnapshot(lastTick));
+        EXPECT_TRUE(HasSpriteChanges(linkedData));
+        ASSERT_EQ(linkedData.spriteChanges.size(), resolvedData.spriteChanges.size());
+        for (size_t i = 0; i < linkedData.spriteChanges.size(); i++)
+        {
+            const auto& linked = linkedData.spriteChanges[i];
+            const auto& resolved = resolvedData.spriteChanges[i];
+            ASSERT_EQ(linked.changeType, resolved.changeType) << "Tick " << tick << ", sprite " << i;
+            ASSERT_EQ(linked.spriteIdentifier, resolved.spriteIdentifier) << "Tick " << tick << ", sprite " << i;
+            ASSERT_EQ(linked.diffs.size(), resolved.diffs.size()) << "Tick " << tick << ", sprite " << i;
+        }
+    }
+
+    SUCCEED();
+}
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <atomic>
+#include <gtest/gtest.h>
+#include <openrct2/core/JobPool.hpp>
+#include <thread>
+#include <vector>
+
+// Fixed so that the tests exercise the workers on any machine, the joining thread runs tasks as well.
+static constexpr size_t NumWorkers = 3;
+
+TEST(JobPoolTest, all_tasks_run)
+{
+    JobPool jobPool(NumWorkers);
+    JobPool::TaskGroup group;
+    std::atomic<size_t> counter = { 0 };
+    for (size_t i = 0; i < 10000; i++)
+    {
+        jobPool.AddTask(group, [&counter]() { counter++; });
+    }
+    jobPool.Join(group);
+    ASSERT_EQ(group.GetPending(), 0U);
+    ASSERT_EQ(counter, 10000U);
+}
+
+TEST(JobPoolTest, parallel_for)
+{
+    JobPool jobPool(NumWorkers);
+    std::vector<uint32_t> values(4321, 0);
+    jobPool.ParallelFor(0, values.size(), 64, [&values](size_t i) { values[i] += static_cast<uint32_t>(i); });
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(JobPoolTest, nested_join)
+{
+    JobPool jobPool(NumWorkers);
+    std::atomic<size_t> counter = { 0 };
+    jobPool.ParallelFor(0, 16, 1, [&jobPool, &counter](size_t) {
+        jobPool.ParallelFor(0, 100, 10, [&counter](size_t) { counter++; });
+    });
+    ASSERT_EQ(counter, 1600U);
+}
+
+TEST(JobPoolTest, report_while_waiting)
+{
+    JobPool jobPool(NumWorkers);
+    JobPool::TaskGroup group;
+    std::atomic<size_t> counter = { 0 };
+    size_t reports = 0;
+    for (size_t i = 0; i < 8; i++)
+    {
+        jobPool.AddTask(group, [&counter]() { counter++; });
+    }
+    jobPool.Join(group, [&reports]() { reports++; });
+    ASSERT_EQ(counter, 8U);
+    ASSERT_GE(reports, 1U);
+}
+
+TEST(JobPoolTest, join_runs_only_own_group)
+{
+    JobPool jobPool(NumWorkers);
+    JobPool::TaskGroup otherGroup;
+    JobPool::TaskGroup group;
+    const auto joiningThread = std::this_thread::get_id();
+    std::atomic<bool> joined = { false };
+    std::atomic<bool> otherRanInJoin = { false };
+    std::atomic<size_t> counter = { 0 };
+
+    // Tasks of another group, such as the chunks of a background save, must not delay the group being joined.
+    auto otherTask = [&joiningThread, &joined, &otherRanInJoin]() {
+        if (std::this_thread::get_id() == joiningThread && !joined)
+        {
+            otherRanInJoin = true;
+        }
+    };
+    jobPool.AddTask(otherGroup, otherTask);
+    for (size_t i = 0; i < 100; i++)
+    {
+        jobPool.AddTask(group, [&counter]() { counter++; });
+    }
+    jobPool.AddTask(otherGroup, otherTask);
+    jobPool.Join(group);
+    joined = true;
+    ASSERT_EQ(counter, 100U);
+    ASSERT_FALSE(otherRanInJoin);
+
+    jobPool.Join(otherGroup);
+    ASSERT_EQ(otherGroup.GetPending(), 0U);
+}
+
+TEST(JobPoolTest, no_workers)
+{
+    JobPool jobPool(0);
+    JobPool::TaskGroup otherGroup;
+    JobPool::TaskGroup group;
+    std::atomic<size_t> counter = { 0 };
+    jobPool.AddTask(group, [&counter]() { counter++; });
+    jobPool.AddTask(otherGroup, [&counter]() { counter++; });
+    jobPool.Join(group);
+    jobPool.Join(otherGroup);
+    ASSERT_EQ(counter, 2U);
+}
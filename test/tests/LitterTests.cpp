@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static bool IsInRange(const Litter* litter, const MapRange& range)
+{
+    return litter->x >= range.GetLeft() && litter->x <= range.GetRight() && litter->y >= range.GetTop()
+        && litter->y <= range.GetBottom();
+}
+
+// The queries as they were answered by walking the litter list.
+static Litter* BruteForceNearest(const CoordsXYZ& litterPos, int32_t maxDistance)
+{
+    Litter* nearestLitter = nullptr;
+    int32_t nearestDistance = maxDistance + 1;
+    for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
+    {
+        int32_t distance = abs(litter->x - litterPos.x) + abs(litter->y - litterPos.y) + abs(litter->z - litterPos.z) * 4;
+        if (distance < nearestDistance)
+        {
+            nearestDistance = distance;
+            nearestLitter = litter;
+        }
+    }
+    return nearestLitter;
+}
+
+static Litter* BruteForceFirstInRange(const MapRange& range, const std::function<bool(const Litter*)>& predicate)
+{
+    Litter* result = nullptr;
+    for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
+    {
+        if (IsInRange(litter, range) && predicate(litter)
+            && (result == nullptr || litter->sprite_index > result->sprite_index))
+        {
+            result = litter;
+        }
+    }
+    return result;
+}
+
+static int32_t BruteForceCountInRange(const MapRange& range, const std::function<bool(const Litter*)>& predicate)
+{
+    int32_t count = 0;
+    for (auto litter : EntityList<Litter>(SPRITE_LIST_LITTER))
+    {
+        if (IsInRange(litter, range) && (predicate == nullptr || predicate(litter)))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void CheckLitterQueries(std::mt19937& random)
+{
+    const int32_t mapExtent = gMapSizeUnits + 2 * COORDS_XY_STEP;
+    std::uniform_int_distribution<int32_t> coordinate(-COORDS_XY_STEP, mapExtent);
+    std::uniform_int_distribution<int32_t> height(0, 32 * COORDS_Z_STEP);
+    std::uniform_int_distribution<int32_t> size(0, 12 * COORDS_XY_STEP);
+    auto isOddHeight = [](const Litter* litter) { return (litter->z / COORDS_Z_STEP) % 2 != 0; };
+
+    for (int32_t i = 0; i < 500; i++)
+    {
+        const CoordsXYZ position = { coordinate(random), coordinate(random), height(random) };
+        for (int32_t maxDistance : { 0, 0x60, 0x200 })
+        {
+            ASSERT_EQ(litter_get_nearest(position, maxDistance), BruteForceNearest(position, maxDistance))
+                << "nearest to " << position.x << ", " << position.y << ", " << position.z << " within " << maxDistance;
+        }
+
+        const MapRange range(position.x, position.y, position.x + size(random), position.y + size(random));
+        ASSERT_EQ(litter_get_first_in_range(range, isOddHeight), BruteForceFirstInRange(range, isOddHeight));
+        ASSERT_EQ(litter_count_in_range(range), BruteForceCountInRange(range, nullptr));
+        ASSERT_EQ(litter_count_in_range(range, isOddHeight), BruteForceCountInRange(range, isOddHeight));
+    }
+
+    // The whole map, as the park rating counts it. Litter that is not on the map is not counted.
+    const MapRange wholeMap(0, 0, MAXIMUM_MAP_SIZE_BIG - 1, MAXIMUM_MAP_SIZE_BIG - 1);
+    ASSERT_EQ(litter_count_in_range(wholeMap), BruteForceCountInRange(wholeMap, nullptr));
+}
+
+TEST(Litter, queries_match_brute_force)
+{
+    auto context = StartTestGame(TestData::GetParkPath("BigMapTest.sv6"));
+    ASSERT_NE(context, nullptr);
+    AdvanceGameTicks(1000, *context);
+
+    // Litter piled up on the same spots as well as spread over the map and beyond its edges, so that there are ties in
+    // distance and cells that hold many items.
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int32_t> coordinate(-COORDS_XY_STEP, gMapSizeUnits + 2 * COORDS_XY_STEP);
+    std::uniform_int_distribution<int32_t> height(0, 32 * COORDS_Z_STEP);
+    std::vector<Litter*> created;
+    for (int32_t i = 0; i < 400; i++)
+    {
+        auto* litter = reinterpret_cast<Litter*>(create_sprite(SPRITE_IDENTIFIER_LITTER));
+        ASSERT_NE(litter, nullptr);
+        litter->sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+        litter->type = LITTER_TYPE_EMPTY_CAN;
+        if (i % 4 == 0 && !created.empty())
+        {
+            auto* other = created[random() % created.size()];
+            litter->MoveTo({ other->x, other->y, other->z });
+        }
+        else
+        {
+            litter->MoveTo({ coordinate(random), coordinate(random), height(random) });
+        }
+        created.push_back(litter);
+    }
+    CheckLitterQueries(random);
+
+    // Moving and removing litter keeps the index up to date.
+    for (size_t i = 0; i < created.size(); i += 3)
+    {
+        created[i]->MoveTo({ coordinate(random), coordinate(random), height(random) });
+    }
+    for (size_t i = 1; i < created.size(); i += 5)
+    {
+        sprite_remove(created[i]);
+    }
+    CheckLitterQueries(random);
+
+    // The game itself drops and sweeps litter.
+    AdvanceGameTicks(1000, *context);
+    CheckLitterQueries(random);
+}
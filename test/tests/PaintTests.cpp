@@ -0,0 +1,559 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/paint/TilePaintCache.h>
+#include <openrct2/peep/Staff.h>
+#include <openrct2/sprites.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <openrct2/world/Surface.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The original arrangement of paint structs as a linked list, paint_session_arrange has to produce the same order.
+namespace Reference
+{
+    template<uint8_t TRotation>
+    static bool CheckBoundingBox(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        switch (TRotation)
+        {
+            case 0:
+                return initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y
+                    && initialBBox.x_end >= currentBBox.x
+                    && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end
+                         && initialBBox.x < currentBBox.x_end);
+            case 1:
+                return initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y
+                    && initialBBox.x_end < currentBBox.x
+                    && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end
+                         && initialBBox.x >= currentBBox.x_end);
+            case 2:
+                return initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y
+                    && initialBBox.x_end < currentBBox.x
+                    && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end
+                         && initialBBox.x >= currentBBox.x_end);
+            default:
+                return initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y
+                    && initialBBox.x_end >= currentBBox.x
+                    && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end
+                         && initialBBox.x < currentBBox.x_end);
+        }
+    }
+
+    template<uint8_t TRotation>
+    static paint_struct* ArrangeQuadrants(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
+    {
+        paint_struct* ps;
+        paint_struct* ps_temp;
+        do
+        {
+            ps = ps_next;
+            ps_next = ps_next->next_quadrant_ps;
+            if (ps_next == nullptr)
+                return ps;
+        } while (quadrantIndex > ps_next->quadrant_index);
+
+        paint_struct* ps_cache = ps;
+
+        ps_temp = ps;
+        do
+        {
+            ps = ps->next_quadrant_ps;
+            if (ps == nullptr)
+                break;
+
+            if (ps->quadrant_index > quadrantIndex + 1)
+            {
+                ps->quadrant_flags = PAINT_QUADRANT_FLAG_BIGGER;
+            }
+            else if (ps->quadrant_index == quadrantIndex + 1)
+            {
+                ps->quadrant_flags = PAINT_QUADRANT_FLAG_NEXT | PAINT_QUADRANT_FLAG_IDENTICAL;
+            }
+            else if (ps->quadrant_index == quadrantIndex)
+            {
+                ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
+            }
+        } while (ps->quadrant_index <= quadrantIndex + 1);
+        ps = ps_temp;
+
+        while (true)
+        {
+            while (true)
+            {
+                ps_next = ps->next_quadrant_ps;
+                if (ps_next == nullptr)
+                    return ps_cache;
+                if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                    return ps_cache;
+                if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
+                    break;
+                ps = ps_next;
+            }
+
+            ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+            ps_temp = ps;
+
+            const paint_struct_bound_box& initialBBox = ps_next->bounds;
+
+            while (true)
+            {
+                ps = ps_next;
+                ps_next = ps_next->next_quadrant_ps;
+                if (ps_next == nullptr)
+                    break;
+                if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                    break;
+                if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
+                    continue;
+
+                if (CheckBoundingBox<TRotation>(initialBBox, ps_next->bounds))
+                {
+                    ps->next_quadrant_ps = ps_next->next_quadrant_ps;
+                    paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
+                    ps_temp->next_quadrant_ps = ps_next;
+                    ps_next->next_quadrant_ps = ps_temp2;
+                    ps_next = ps;
+                }
+            }
+
+            ps = ps_temp;
+        }
+    }
+
+    static paint_struct* ArrangeQuadrants(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
+    {
+        switch (rotation)
+        {
+            case 0:
+                return ArrangeQuadrants<0>(ps_next, quadrantIndex, flag);
+            case 1:
+                return ArrangeQuadrants<1>(ps_next, quadrantIndex, flag);
+            case 2:
+                return ArrangeQuadrants<2>(ps_next, quadrantIndex, flag);
+            default:
+                return ArrangeQuadrants<3>(ps_next, quadrantIndex, flag);
+        }
+    }
+
+    static void Arrange(paint_session* session)
+    {
+        paint_struct* ps = &session->PaintHead;
+        ps->next_quadrant_ps = nullptr;
+
+        uint32_t quadrantIndex = session->QuadrantBackIndex;
+        do
+        {
+            paint_struct* ps_next = session->Quadrants[quadrantIndex];
+            if (ps_next != nullptr)
+            {
+                ps->next_quadrant_ps = ps_next;
+                do
+                {
+                    ps = ps_next;
+                    ps_next = ps_next->next_quadrant_ps;
+                } while (ps_next != nullptr);
+            }
+        } while (++quadrantIndex <= session->QuadrantFrontIndex);
+
+        paint_struct* ps_cache = ArrangeQuadrants(
+            &session->PaintHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation);
+
+        quadrantIndex = session->QuadrantBackIndex;
+        while (++quadrantIndex < session->QuadrantFrontIndex)
+        {
+            ps_cache = ArrangeQuadrants(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation);
+        }
+    }
+} // namespace Reference
+
+class PaintTests : public testing::Test
+{
+protected:
+    struct Scene
+    {
+        std::unique_ptr<paint_session> Session = std::make_unique<paint_session>();
+        std::vector<paint_struct> PaintStructs;
+    };
+
+    // Builds a session with paint structs spread over a range of quadrants, small coordinates make the bounding boxes of
+    // neighbouring structs overlap often, like they do on crowded tiles.
+    static Scene CreateScene(uint32_t seed, size_t count, uint32_t numQuadrants, uint16_t maxCoordinate, uint8_t rotation)
+    {
+        std::mt19937 random(seed);
+        Scene scene;
+        scene.PaintStructs.resize(count);
+        scene.Session->CurrentRotation = rotation;
+        scene.Session->QuadrantBackIndex = 100;
+        scene.Session->QuadrantFrontIndex = 100 + numQuadrants - 1;
+        for (auto& ps : scene.PaintStructs)
+        {
+            auto& bounds = ps.bounds;
+            bounds.x = random() % maxCoordinate;
+            bounds.y = random() % maxCoordinate;
+            bounds.z = random() % maxCoordinate;
+            bounds.x_end = bounds.x + random() % 32;
+            bounds.y_end = bounds.y + random() % 32;
+            bounds.z_end = bounds.z + random() % 64;
+            ps.quadrant_index = scene.Session->QuadrantBackIndex + random() % numQuadrants;
+            ps.quadrant_flags = static_cast<uint8_t>(random());
+
+            ps.next_quadrant_ps = scene.Session->Quadrants[ps.quadrant_index];
+            scene.Session->Quadrants[ps.quadrant_index] = &ps;
+        }
+        return scene;
+    }
+
+    static std::vector<size_t> GetOrder(const Scene& scene)
+    {
+        std::vector<size_t> order;
+        for (auto ps = scene.Session->PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            order.push_back(ps - scene.PaintStructs.data());
+        }
+        return order;
+    }
+
+    // A session with a single chunk of paint entries, as used for recording a tile
+    struct RecordingSession
+    {
+        std::unique_ptr<paint_session> Session = std::make_unique<paint_session>();
+        std::unique_ptr<PaintEntryChunk> Chunk = std::make_unique<PaintEntryChunk>();
+
+        RecordingSession()
+        {
+            Session->NextFreePaintStruct = Chunk->Entries;
+            Session->EndOfPaintStructArray = Chunk->Entries + std::size(Chunk->Entries);
+        }
+
+        // Does what a successful primitive call does to the session
+        paint_entry* Allocate()
+        {
+            return Session->NextFreePaintStruct++;
+        }
+    };
+
+    static constexpr uint32_t TestImage = SPR_IMAGE_LIST_BEGIN;
+    static constexpr int32_t TestMapSize = 8;
+
+    // A flat map of grass surfaces, as map_init creates it, and images for PaintTestElements to paint
+    static void CreateTestMap()
+    {
+        for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+        {
+            auto& element = gTileElements[i];
+            element.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+            element.SetLastForTile(true);
+            element.base_height = 14;
+            element.clearance_height = 14;
+            element.AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
+        }
+        gMapSize = TestMapSize;
+        gMapSizeUnits = TestMapSize * 32 - 32;
+        gMapSizeMinus2 = TestMapSize * 32 - 2;
+        gMapSizeMaxXY = TestMapSize * 32 - 33;
+        map_update_tile_pointers();
+        gStaffDrawPatrolAreas = SPRITE_INDEX_NULL;
+
+        rct_g1_element image = {};
+        image.width = 64;
+        image.height = 32;
+        image.x_offset = -32;
+        image.y_offset = -16;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            gfx_set_g1_element(TestImage + i, &image);
+        }
+    }
+
+    // Paints each element as a root struct with a child and an attachment, the way the element paint functions do
+    static TileElement* PaintTestElements(paint_session* session, TileElement* element)
+    {
+        do
+        {
+            session->CurrentlyDrawnItem = element;
+            session->InteractionType = VIEWPORT_INTERACTION_ITEM_TERRAIN;
+            const int16_t height = element->GetBaseZ();
+            auto ps = sub_98197C(session, TestImage, 0, 0, 32, 32, 1, height, 0, 0, height);
+            if (ps != nullptr)
+            {
+                ps->flags = PAINT_STRUCT_FLAG_IS_MASKED;
+                ps->tertiary_colour = element->base_height;
+            }
+            sub_98199C(session, TestImage + 1, 0, 0, 32, 32, 1, height, 0, 0, height);
+            paint_attach_to_previous_ps(session, TestImage + 2, 0, element->AsSurface()->GetSlope());
+        } while (!(element++)->IsLastForTile());
+        return element;
+    }
+
+    // A session covering the whole test map, positioned on the given tile
+    struct PaintTestSession : RecordingSession
+    {
+        explicit PaintTestSession(const CoordsXY& mapPosition)
+        {
+            Session->DPI.x = -512;
+            Session->DPI.y = -512;
+            Session->DPI.width = 1024;
+            Session->DPI.height = 1024;
+            Session->PaintEntryChunks = Chunk.get();
+            Session->CurrentPaintEntryChunk = Chunk.get();
+            Session->NumPaintEntryChunks = 1;
+            Session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+            Session->SpritePosition = mapPosition;
+            Session->MapPosition = mapPosition;
+        }
+    };
+
+    // Every paint struct of the session in quadrant order with its children and attachments
+    static std::vector<std::string> DescribePaintStructs(const paint_session& session)
+    {
+        std::vector<std::string> result;
+        for (uint32_t quadrant = session.QuadrantBackIndex; quadrant <= session.QuadrantFrontIndex; quadrant++)
+        {
+            for (auto ps = session.Quadrants[quadrant]; ps != nullptr; ps = ps->next_quadrant_ps)
+            {
+                for (auto child = ps; child != nullptr; child = child->children)
+                {
+                    std::ostringstream line;
+                    line << quadrant << ": " << child->image_id << " " << child->x << "," << child->y << " "
+                         << child->bounds.x << "," << child->bounds.y << "," << child->bounds.z << " "
+                         << child->bounds.x_end << "," << child->bounds.y_end << "," << child->bounds.z_end
+                         << " flags " << static_cast<int32_t>(child->flags) << " colour " << child->tertiary_colour
+                         << " type " << static_cast<int32_t>(child->sprite_type) << " map " << child->map_x << ","
+                         << child->map_y << " element " << child->tileElement;
+                    for (auto attached = child->attached_ps; attached != nullptr; attached = attached->next)
+                    {
+                        line << " attached " << attached->image_id << " " << attached->x << "," << attached->y;
+                    }
+                    result.push_back(line.str());
+                }
+            }
+        }
+        return result;
+    }
+
+    static void TestArrange(uint32_t seed, size_t count, uint32_t numQuadrants, uint16_t maxCoordinate)
+    {
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            auto expected = CreateScene(seed, count, numQuadrants, maxCoordinate, rotation);
+            auto actual = CreateScene(seed, count, numQuadrants, maxCoordinate, rotation);
+            Reference::Arrange(expected.Session.get());
+            paint_session_arrange(actual.Session.get());
+
+            auto expectedOrder = GetOrder(expected);
+            ASSERT_EQ(expectedOrder.size(), count);
+            ASSERT_EQ(GetOrder(actual), expectedOrder) << "rotation " << static_cast<int32_t>(rotation);
+        }
+    }
+};
+
+TEST_F(PaintTests, ArrangeSingleStruct)
+{
+    TestArrange(1, 1, 1, 64);
+}
+
+TEST_F(PaintTests, ArrangeSparse)
+{
+    TestArrange(2, 200, 100, 1024);
+}
+
+TEST_F(PaintTests, ArrangeCrowded)
+{
+    TestArrange(3, 2000, 4, 64);
+}
+
+TEST_F(PaintTests, ArrangeManyQuadrants)
+{
+    for (uint32_t seed = 0; seed < 20; seed++)
+    {
+        TestArrange(seed, 1000, 40, 256);
+    }
+}
+
+TEST_F(PaintTests, RecorderStoresResults)
+{
+    using namespace OpenRCT2::Paint;
+    RecordingSession recording;
+    TilePaintRecorder recorder;
+
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98197C, 100, { 0, 0, 0 }, { 32, 32, 1 }, { 0, 0, 0 });
+    auto& ps = recording.Allocate()->basic;
+    recording.Session->LastRootPS = &ps;
+    recorder.Record(*recording.Session, TilePaintCommandType::AttachToPreviousPS, 101, { 0, 0, 0 });
+    auto& attached = recording.Allocate()->attached;
+    // A call that does not produce a paint struct, for example because the image does not exist
+    recorder.Record(*recording.Session, TilePaintCommandType::AttachToPreviousAttach, 102, { 0, 0, 0 });
+
+    // Paint functions change the structs after they have been created
+    ps.flags = PAINT_STRUCT_FLAG_IS_MASKED;
+    ps.tertiary_colour = 7;
+    attached.flags = PAINT_STRUCT_FLAG_IS_MASKED;
+    attached.colour_image_id = 8;
+
+    std::vector<TilePaintCommand> commands;
+    ASSERT_TRUE(recorder.Finish(*recording.Session, commands));
+    ASSERT_EQ(commands.size(), 3U);
+    EXPECT_EQ(commands[0].ResultFlags, PAINT_STRUCT_FLAG_IS_MASKED);
+    EXPECT_EQ(commands[0].ResultColour, 7U);
+    EXPECT_EQ(commands[1].ResultFlags, PAINT_STRUCT_FLAG_IS_MASKED);
+    EXPECT_EQ(commands[1].ResultColour, 8U);
+    EXPECT_EQ(commands[2].ResultFlags, 0);
+    EXPECT_EQ(commands[2].ResultColour, 0U);
+}
+
+TEST_F(PaintTests, RecorderSkipsDelegatedCalls)
+{
+    using namespace OpenRCT2::Paint;
+    RecordingSession recording;
+    TilePaintRecorder recorder;
+
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98196C, 100, { 0, 0, 0 }, { 32, 32, 1 });
+    // Without a root paint struct sub_98199C and paint_attach_to_previous_attach call their fallback, which is replayed
+    // by replaying the original call
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98199C, 101, { 0, 0, 0 }, { 32, 32, 1 }, { 0, 0, 0 });
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98197C, 101, { 0, 0, 0 }, { 32, 32, 1 }, { 0, 0, 0 });
+    recording.Allocate();
+    recorder.Record(*recording.Session, TilePaintCommandType::AttachToPreviousAttach, 102, { 0, 0, 0 });
+    recorder.Record(*recording.Session, TilePaintCommandType::AttachToPreviousPS, 102, { 0, 0, 0 });
+
+    std::vector<TilePaintCommand> commands;
+    ASSERT_TRUE(recorder.Finish(*recording.Session, commands));
+    ASSERT_EQ(commands.size(), 3U);
+    EXPECT_EQ(commands[0].Type, TilePaintCommandType::Sub98196C);
+    EXPECT_EQ(commands[1].Type, TilePaintCommandType::Sub98199C);
+    EXPECT_EQ(commands[2].Type, TilePaintCommandType::AttachToPreviousAttach);
+}
+
+TEST_F(PaintTests, RecorderRejectsLeadingChild)
+{
+    using namespace OpenRCT2::Paint;
+    RecordingSession recording;
+    TilePaintRecorder recorder;
+
+    // A child or attachment as first call would be added to whatever the previous tile painted last
+    recording.Session->LastRootPS = &recording.Allocate()->basic;
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98199C, 100, { 0, 0, 0 }, { 32, 32, 1 }, { 0, 0, 0 });
+    recorder.Record(*recording.Session, TilePaintCommandType::Sub98196C, 101, { 0, 0, 0 }, { 32, 32, 1 });
+
+    std::vector<TilePaintCommand> commands;
+    EXPECT_FALSE(recorder.Finish(*recording.Session, commands));
+}
+
+TEST_F(PaintTests, RecorderRejectsChangingImages)
+{
+    using namespace OpenRCT2::Paint;
+    for (uint32_t imageId : { static_cast<uint32_t>(SPR_TEMP), static_cast<uint32_t>(SPR_SCROLLING_TEXT_START + 3) })
+    {
+        RecordingSession recording;
+        TilePaintRecorder recorder;
+        recorder.Record(*recording.Session, TilePaintCommandType::Sub98196C, 100, { 0, 0, 0 }, { 32, 32, 1 });
+        recorder.Record(*recording.Session, TilePaintCommandType::AttachToPreviousPS, imageId | 0x20000000, { 0, 0, 0 });
+
+        std::vector<TilePaintCommand> commands;
+        EXPECT_FALSE(recorder.Finish(*recording.Session, commands)) << imageId;
+    }
+}
+
+TEST_F(PaintTests, TilePaintCacheReplaysPaintStructs)
+{
+    using namespace OpenRCT2::Paint;
+    CreateTestMap();
+    const CoordsXY position = { 3 * COORDS_XY_STEP, 3 * COORDS_XY_STEP };
+    auto firstElement = map_get_first_element_at(position);
+    ASSERT_NE(firstElement, nullptr);
+
+    PaintTestSession fresh(position);
+    PaintTestElements(fresh.Session.get(), firstElement);
+    const auto expected = DescribePaintStructs(*fresh.Session);
+    ASSERT_EQ(expected.size(), 2U);
+
+    TilePaintCache cache;
+    // The first miss of a tile is not recorded
+    PaintTestSession first(position);
+    ASSERT_FALSE(cache.Paint(first.Session.get(), firstElement, PaintTestElements));
+
+    PaintTestSession recorded(position);
+    ASSERT_TRUE(cache.Paint(recorded.Session.get(), firstElement, PaintTestElements));
+    EXPECT_EQ(DescribePaintStructs(*recorded.Session), expected);
+    EXPECT_EQ(
+        recorded.Session->NextFreePaintStruct - recorded.Chunk->Entries,
+        fresh.Session->NextFreePaintStruct - fresh.Chunk->Entries);
+
+    PaintTestSession replayed(position);
+    ASSERT_TRUE(cache.Paint(replayed.Session.get(), firstElement, PaintTestElements));
+    EXPECT_EQ(DescribePaintStructs(*replayed.Session), expected);
+    EXPECT_EQ(replayed.Session->MapPosition, fresh.Session->MapPosition);
+    EXPECT_EQ(replayed.Session->CurrentlyDrawnItem, fresh.Session->CurrentlyDrawnItem);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.Hits, 1U);
+    EXPECT_EQ(stats.Misses, 2U);
+    EXPECT_EQ(stats.Entries, 1U);
+}
+
+TEST_F(PaintTests, TilePaintCacheMissesChangedTiles)
+{
+    using namespace OpenRCT2::Paint;
+    CreateTestMap();
+    const CoordsXY position = { 3 * COORDS_XY_STEP, 3 * COORDS_XY_STEP };
+    auto firstElement = map_get_first_element_at(position);
+    ASSERT_NE(firstElement, nullptr);
+
+    TilePaintCache cache;
+    auto paintTile = [&]() {
+        PaintTestSession session(position);
+        return cache.Paint(session.Session.get(), firstElement, PaintTestElements);
+    };
+    // A tile is recorded when it misses for the second time, at the latest on the second paint
+    auto record = [&]() { return paintTile() || paintTile(); };
+
+    ASSERT_TRUE(record());
+    uint64_t hits = cache.GetStats().Hits;
+
+    // A changed element of the tile
+    firstElement->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_N_CORNER_UP);
+    EXPECT_FALSE(paintTile());
+    EXPECT_EQ(cache.GetStats().Hits, hits);
+    EXPECT_EQ(cache.GetStats().Entries, 0U);
+
+    // The new recording shows the change
+    ASSERT_TRUE(record());
+    PaintTestSession fresh(position);
+    PaintTestElements(fresh.Session.get(), firstElement);
+    PaintTestSession replayed(position);
+    ASSERT_TRUE(cache.Paint(replayed.Session.get(), firstElement, PaintTestElements));
+    EXPECT_EQ(DescribePaintStructs(*replayed.Session), DescribePaintStructs(*fresh.Session));
+    hits = cache.GetStats().Hits;
+
+    // A changed surface of a neighbouring tile
+    auto neighbour = map_get_surface_element_at(position + CoordsXY{ COORDS_XY_STEP, 0 });
+    ASSERT_NE(neighbour, nullptr);
+    neighbour->base_height += 2;
+    EXPECT_FALSE(paintTile());
+    EXPECT_EQ(cache.GetStats().Hits, hits);
+
+    // A tile that is not a neighbour does not matter
+    ASSERT_TRUE(record());
+    hits = cache.GetStats().Hits;
+    auto farTile = map_get_surface_element_at(position + CoordsXY{ 2 * COORDS_XY_STEP, 2 * COORDS_XY_STEP });
+    ASSERT_NE(farTile, nullptr);
+    farTile->base_height += 2;
+    EXPECT_TRUE(paintTile());
+    EXPECT_EQ(cache.GetStats().Hits, hits + 1);
+}
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
 
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
@@ -33,36 +34,6 @@ class PlayTests : public testing::Test
 {
 };
 
-static std::unique_ptr<IContext> localStartGame(const std::string& parkPath)
-{
-    gOpenRCT2Headless = true;
-    gOpenRCT2NoGraphics = true;
-    core_init();
-
-    auto context = CreateContext();
-    if (!context->Initialise())
-        return {};
-
-    auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
-    auto loadResult = importer->LoadSavedGame(parkPath.c_str(), false);
-    context->GetObjectManager().LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
-    importer->Import();
-
-    reset_sprite_spatial_index();
-
-    reset_all_sprite_quadrant_placements();
-    scenery_set_default_placement_configuration();
-    load_palette();
-    map_reorganise_elements();
-    sprite_position_tween_reset();
-    AutoCreateMapAnimations();
-    fix_invalid_vehicle_sprite_sizes();
-
-    gGameSpeed = 1;
-
-    return context;
-}
-
 template<class Fn> static bool updateUntil(GameState& gs, int maxSteps, Fn&& fn)
 {
     while (maxSteps-- && !fn())
@@ -88,7 +59,7 @@ TEST_F(PlayTests, SecondGuestInQueueShouldNotRideIfNoFunds)
      */
     std::string initStateFile = TestData::GetParkPath("small_park_with_ferris_wheel.sv6");
 
-    auto context = localStartGame(initStateFile);
+    auto context = StartTestGame(initStateFile);
     ASSERT_NE(context.get(), nullptr);
 
     auto gs = context->GetGameState();
@@ -149,7 +120,7 @@ TEST_F(PlayTests, CarRideWithOneCarOnlyAcceptsTwoGuests)
     // This test verifies that a car ride with one car will accept at most two guests
     std::string initStateFile = TestData::GetParkPath("small_park_car_ride_one_car.sv6");
 
-    auto context = localStartGame(initStateFile);
+    auto context = StartTestGame(initStateFile);
     ASSERT_NE(context.get(), nullptr);
 
     auto gs = context->GetGameState();
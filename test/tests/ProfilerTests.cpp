@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include <chrono>
+#include <gtest/gtest.h>
+#include <openrct2/core/Profiler.h>
+#include <string>
+
+using namespace OpenRCT2::Profiling;
+
+TEST(ProfilerTest, rolling_window)
+{
+    Reset();
+    auto start = Clock::now();
+    for (int32_t i = 1; i <= static_cast<int32_t>(WindowSize) + 100; i++)
+    {
+        Record(ProfileSection::Peeps, start, start + std::chrono::microseconds(i));
+    }
+
+    auto stats = GetStats(ProfileSection::Peeps);
+    ASSERT_EQ(stats.Samples, WindowSize);
+    ASSERT_DOUBLE_EQ(stats.Last, (WindowSize + 100) / 1000.0);
+    ASSERT_DOUBLE_EQ(stats.Max, (WindowSize + 100) / 1000.0);
+    ASSERT_GE(stats.P95, stats.P50);
+
+    // The oldest 100 samples have been dropped from the histogram as well.
+    uint32_t histogramTotal = 0;
+    for (auto count : stats.Histogram)
+    {
+        histogramTotal += count;
+    }
+    ASSERT_EQ(histogramTotal, WindowSize);
+    ASSERT_EQ(stats.Histogram[0], 0U);
+    ASSERT_EQ(stats.Histogram[1], 0U);
+}
+
+TEST(ProfilerTest, scoped_timer)
+{
+    Reset();
+    SetEnabled(false);
+    {
+        PROFILE_SCOPE(Tick);
+    }
+    ASSERT_EQ(GetStats(ProfileSection::Tick).Samples, 0U);
+
+    SetEnabled(true);
+    {
+        PROFILE_SCOPE(Tick);
+    }
+#ifdef DISABLE_PROFILER
+    ASSERT_EQ(GetStats(ProfileSection::Tick).Samples, 0U);
+#else
+    ASSERT_EQ(GetStats(ProfileSection::Tick).Samples, 1U);
+#endif
+}
+
+TEST(ProfilerTest, trace_json)
+{
+    Reset();
+    ASSERT_EQ(GetTraceJson(), "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+
+    auto start = Clock::now();
+    Record(ProfileSection::Paint, start, start + std::chrono::microseconds(1500));
+    auto json = GetTraceJson();
+    ASSERT_NE(json.find("\"name\":\"Paint\""), std::string::npos);
+    ASSERT_NE(json.find("\"cat\":\"render\""), std::string::npos);
+    ASSERT_NE(json.find("\"dur\":1500.000"), std::string::npos);
+}
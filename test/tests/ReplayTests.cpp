@@ -8,13 +8,16 @@
  *****************************************************************************/
 
 #include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
 
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/PlatformEnvironment.h>
 #include <openrct2/ReplayManager.h>
+#include <openrct2/actions/ParkSetParameterAction.hpp>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/core/File.h>
 #include <openrct2/core/FileScanner.h>
@@ -22,6 +25,7 @@
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
+#include <openrct2/world/Park.h>
 #include <string>
 
 using namespace OpenRCT2;
@@ -103,6 +107,259 @@ TEST_P(ReplayTests, RunReplay)
 #endif
 }
 
+TEST_P(ReplayTests, SeekReplay)
+{
+#ifdef PLATFORM_32BIT
+    log_warning("Replay Tests have not been performed. OpenRCT2/OpenRCT2#11279.");
+    return;
+#else
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto testData = GetParam();
+    auto replayFile = testData.filePath;
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    bool startedReplay = replayManager->StartPlayback(replayFile);
+    ASSERT_TRUE(startedReplay);
+
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+
+    // Seek forwards past the middle, then back to the first quarter and play to the end.
+    ASSERT_TRUE(replayManager->SeekPlayback(info.Ticks * 3 / 4));
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    if (replayManager->IsReplaying())
+    {
+        ASSERT_TRUE(replayManager->SeekPlayback(info.Ticks / 4));
+        ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    }
+
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        ASSERT_TRUE(replayManager->IsPlaybackStateMismatching() == false);
+    }
+#endif
+}
+
+// Opens the test park, guests walking around keep the sprites changing between keyframes.
+static void OpenTestPark(IContext& context)
+{
+    ParkSetParameterAction openPark(ParkParameter::Open);
+    GameActions::Execute(&openPark);
+    for (int32_t i = 0; i < 20; i++)
+    {
+        context.GetGameState()->GetPark().GenerateGuest();
+    }
+}
+
+static uint64_t ReadBigEndian(const std::vector<uint8_t>& bytes, size_t offset, size_t length)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        value = (value << 8) | bytes[offset + i];
+    }
+    return value;
+}
+
+static void WriteBigEndian32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value)
+{
+    for (size_t i = 0; i < 4; i++)
+    {
+        bytes[offset + i] = static_cast<uint8_t>(value >> (24 - i * 8));
+    }
+}
+
+TEST(ReplayKeyframes, SeekAcrossKeyframes)
+{
+#ifdef PLATFORM_32BIT
+    log_warning("Replay Tests have not been performed. OpenRCT2/OpenRCT2#11279.");
+    return;
+#else
+    auto context = StartTestGame(TestData::GetParkPath("small_park_with_ferris_wheel.sv6"));
+    ASSERT_NE(context, nullptr);
+
+    OpenTestPark(*context);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    // The recording spans two keyframes, the version 4 replays of the corpus have none.
+    std::string replayPath = Path::Combine(
+        context->GetPlatformEnvironment()->GetDirectoryPath(DIRBASE::USER, DIRID::REPLAY), "keyframe_test.sv6r");
+    const uint32_t replayTicks = 9000;
+    const uint32_t startTick = gCurrentTicks;
+    ASSERT_TRUE(replayManager->StartRecording(replayPath, replayTicks));
+    while (replayManager->IsRecording())
+    {
+        gs->UpdateLogic();
+    }
+
+    ASSERT_TRUE(replayManager->StartPlayback(replayPath));
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    ASSERT_EQ(info.Ticks, replayTicks);
+    ASSERT_EQ(info.NumKeyframes, 2U);
+
+    // Forwards past the last keyframe, backwards before the first one, forwards onto a keyframe and then forwards by
+    // simulating from the current tick.
+    for (uint32_t replayTick : { 8500U, 1000U, 4200U, 6000U })
+    {
+        ASSERT_TRUE(replayManager->SeekPlayback(replayTick));
+        ASSERT_TRUE(replayManager->IsReplaying());
+        ASSERT_EQ(gCurrentTicks, startTick + replayTick);
+        ASSERT_FALSE(replayManager->IsPlaybackStateMismatching()) << "after seeking to " << replayTick;
+    }
+
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    }
+    ASSERT_EQ(gCurrentTicks, startTick + replayTicks);
+
+    File::Delete(replayPath);
+#endif
+}
+
+TEST(ReplayBlocks, IncompleteAndCorruptFiles)
+{
+#ifdef PLATFORM_32BIT
+    log_warning("Replay Tests have not been performed. OpenRCT2/OpenRCT2#11279.");
+    return;
+#else
+    auto context = StartTestGame(TestData::GetParkPath("small_park_with_ferris_wheel.sv6"));
+    ASSERT_NE(context, nullptr);
+
+    OpenTestPark(*context);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    std::string replayDirectory = context->GetPlatformEnvironment()->GetDirectoryPath(DIRBASE::USER, DIRID::REPLAY);
+    std::string replayPath = Path::Combine(replayDirectory, "block_test.sv6r");
+    std::string variantPath = Path::Combine(replayDirectory, "block_test_variant.sv6r");
+    const uint32_t replayTicks = 3500;
+    ASSERT_TRUE(replayManager->StartRecording(replayPath, replayTicks));
+    while (replayManager->IsRecording())
+    {
+        gs->UpdateLogic();
+    }
+
+    // The file ends with the index, see ReplayManager::WriteBlockIndex.
+    auto bytes = File::ReadAllBytes(replayPath);
+    ASSERT_GE(bytes.size(), 12U);
+    size_t indexOffset = static_cast<size_t>(ReadBigEndian(bytes, bytes.size() - 12, 8));
+    ASSERT_EQ(ReadBigEndian(bytes, bytes.size() - 4, 4), 0x4943524FU);
+    ASSERT_LT(indexOffset, bytes.size());
+
+    struct BlockEntry
+    {
+        size_t Offset;
+        uint8_t Type;
+        uint32_t Tick;
+    };
+    std::vector<BlockEntry> blocks;
+    uint32_t countBlocks = static_cast<uint32_t>(ReadBigEndian(bytes, indexOffset, 4));
+    for (uint32_t i = 0; i < countBlocks; i++)
+    {
+        size_t entryOffset = indexOffset + 4 + i * 13;
+        blocks.push_back({ static_cast<size_t>(ReadBigEndian(bytes, entryOffset, 8)), bytes[entryOffset + 8],
+                           static_cast<uint32_t>(ReadBigEndian(bytes, entryOffset + 9, 4)) });
+    }
+
+    // Header, data every 1000 ticks and when stopping, end.
+    ASSERT_EQ(blocks.size(), 6U);
+    ASSERT_EQ(blocks.front().Type, 0);
+    ASSERT_EQ(blocks.back().Type, 2);
+    const uint32_t startTick = blocks.front().Tick;
+    const size_t lastDataOffset = blocks[blocks.size() - 2].Offset;
+    const uint32_t lastCompleteTicks = blocks[blocks.size() - 3].Tick - startTick;
+
+    auto getReplayTicks = [&](const std::vector<uint8_t>& variant, uint32_t& ticks) {
+        File::WriteAllBytes(variantPath, variant.data(), variant.size());
+        if (!replayManager->StartPlayback(variantPath))
+            return false;
+
+        ReplayRecordInfo info;
+        bool result = replayManager->GetCurrentReplayInfo(info);
+        ticks = info.Ticks;
+        return result;
+    };
+    auto playToEnd = [&]() {
+        while (replayManager->IsReplaying())
+        {
+            gs->UpdateLogic();
+            if (replayManager->IsPlaybackStateMismatching())
+                return false;
+        }
+        return true;
+    };
+    uint32_t ticks = 0;
+
+    // Round trip
+    ASSERT_TRUE(getReplayTicks(bytes, ticks));
+    ASSERT_EQ(ticks, replayTicks);
+    ASSERT_TRUE(playToEnd());
+
+    // Stopped, but the index is missing
+    ASSERT_TRUE(getReplayTicks(std::vector<uint8_t>(bytes.begin(), bytes.begin() + indexOffset), ticks));
+    ASSERT_EQ(ticks, replayTicks);
+    replayManager->StopPlayback();
+
+    // Never stopped, the file ends after a complete data block
+    ASSERT_TRUE(getReplayTicks(std::vector<uint8_t>(bytes.begin(), bytes.begin() + lastDataOffset), ticks));
+    ASSERT_EQ(ticks, lastCompleteTicks);
+    ASSERT_TRUE(playToEnd());
+
+    // Never stopped, the last data block was only partly written
+    ASSERT_TRUE(getReplayTicks(std::vector<uint8_t>(bytes.begin(), bytes.begin() + lastDataOffset + 10), ticks));
+    ASSERT_EQ(ticks, lastCompleteTicks);
+    replayManager->StopPlayback();
+
+    // Index with more blocks than the file can hold, the blocks are scanned instead
+    auto corruptCount = bytes;
+    WriteBigEndian32(corruptCount, indexOffset, 0xFFFFFFFF);
+    ASSERT_TRUE(getReplayTicks(corruptCount, ticks));
+    ASSERT_EQ(ticks, replayTicks);
+    replayManager->StopPlayback();
+
+    // Index entry pointing past the blocks
+    auto corruptOffset = bytes;
+    WriteBigEndian32(corruptOffset, indexOffset + 4 + 13, 0xFFFFFFFF);
+    ASSERT_TRUE(getReplayTicks(corruptOffset, ticks));
+    ASSERT_EQ(ticks, replayTicks);
+    replayManager->StopPlayback();
+
+    // Header block claiming an uncompressed size of 4 GiB is rejected before anything is allocated, it follows the
+    // magic, version, block type and tick.
+    auto corruptSize = bytes;
+    WriteBigEndian32(corruptSize, 4 + 2 + 1 + 4, 0xFFFFFFFF);
+    ASSERT_FALSE(getReplayTicks(corruptSize, ticks));
+
+    File::Delete(variantPath);
+    File::Delete(replayPath);
+#endif
+}
+
 static void PrintTo(const ReplayTestData& testData, std::ostream* os)
 {
     *os << testData.filePath;
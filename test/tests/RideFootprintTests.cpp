@@ -0,0 +1,319 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <gtest/gtest.h>
+#include <openrct2/Cheats.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/PlatformEnvironment.h>
+#include <openrct2/actions/MazePlaceTrackAction.hpp>
+#include <openrct2/actions/MazeSetTrackAction.hpp>
+#include <openrct2/actions/RideCreateAction.hpp>
+#include <openrct2/actions/RideDemolishAction.hpp>
+#include <openrct2/actions/TileModifyAction.hpp>
+#include <openrct2/actions/TrackPlaceAction.hpp>
+#include <openrct2/actions/TrackRemoveAction.hpp>
+#include <openrct2/core/File.h>
+#include <openrct2/core/Path.hpp>
+#include <openrct2/object/ObjectManager.h>
+#include <openrct2/object/ObjectRepository.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/ride/RideFootprint.h>
+#include <openrct2/ride/Track.h>
+#include <openrct2/scripting/ScriptEngine.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Park.h>
+#include <openrct2/world/Surface.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+template<class GA, class... Args> static GameActionResult::Ptr execute(Args&&... args)
+{
+    GA ga(std::forward<Args>(args)...);
+    return GameActions::Execute(&ga);
+}
+
+// The rides with track on the tiles in range, as they were found by looking at every tile.
+static std::bitset<MAX_RIDES> ScanRidesInRange(const MapRange& range)
+{
+    std::bitset<MAX_RIDES> result;
+    const int32_t left = std::max(range.GetLeft(), 0) / COORDS_XY_STEP;
+    const int32_t top = std::max(range.GetTop(), 0) / COORDS_XY_STEP;
+    const int32_t right = std::min(range.GetRight() / COORDS_XY_STEP, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    const int32_t bottom = std::min(range.GetBottom() / COORDS_XY_STEP, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    for (int32_t x = left; x <= right; x++)
+    {
+        for (int32_t y = top; y <= bottom; y++)
+        {
+            auto tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+            do
+            {
+                if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK && tileElement->AsTrack()->GetRideIndex() < MAX_RIDES)
+                {
+                    result[tileElement->AsTrack()->GetRideIndex()] = true;
+                }
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    return result;
+}
+
+static std::vector<MapRange> GetQueryRanges(std::mt19937& random)
+{
+    std::vector<MapRange> ranges;
+    const int32_t mapSize = gMapSize;
+    // Every tile and every cell of the grid, as well as ranges that only cover parts of cells.
+    for (int32_t x = 0; x < mapSize; x++)
+    {
+        for (int32_t y = 0; y < mapSize; y++)
+        {
+            ranges.emplace_back(
+                x * COORDS_XY_STEP, y * COORDS_XY_STEP, x * COORDS_XY_STEP + COORDS_XY_STEP - 1,
+                y * COORDS_XY_STEP + COORDS_XY_STEP - 1);
+        }
+    }
+    for (int32_t offset : { 0, 4 })
+    {
+        for (int32_t x = offset; x < mapSize; x += 8)
+        {
+            for (int32_t y = offset; y < mapSize; y += 8)
+            {
+                ranges.emplace_back(
+                    x * COORDS_XY_STEP, y * COORDS_XY_STEP, (x + 8) * COORDS_XY_STEP - 1, (y + 8) * COORDS_XY_STEP - 1);
+            }
+        }
+    }
+
+    // Ranges around guests as they look for rides, which may reach past the edges of the map.
+    std::uniform_int_distribution<int32_t> coordinate(0, gMapSizeUnits);
+    std::uniform_int_distribution<int32_t> radius(0, 40 * COORDS_XY_STEP);
+    for (int32_t i = 0; i < 500; i++)
+    {
+        const int32_t x = coordinate(random);
+        const int32_t y = coordinate(random);
+        const int32_t r = radius(random);
+        ranges.emplace_back(x - r, y - r, x + r, y + r);
+    }
+    ranges.emplace_back(0, 0, MAXIMUM_MAP_SIZE_BIG - 1, MAXIMUM_MAP_SIZE_BIG - 1);
+    return ranges;
+}
+
+// Queries the incrementally maintained grid, then rebuilds it from the map and checks that the answers are the same.
+static void CheckFootprintAgainstMap(std::mt19937& random)
+{
+    const auto ranges = GetQueryRanges(random);
+    std::vector<std::bitset<MAX_RIDES>> incremental;
+    for (const auto& range : ranges)
+    {
+        incremental.push_back(ride_footprint_get_rides_in_range(range));
+    }
+
+    ride_footprint_invalidate();
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        const auto& range = ranges[i];
+        auto rebuilt = ride_footprint_get_rides_in_range(range);
+        ASSERT_EQ(incremental[i], rebuilt) << "range " << range.GetLeft() << ", " << range.GetTop() << " to "
+                                           << range.GetRight() << ", " << range.GetBottom();
+        ASSERT_EQ(rebuilt, ScanRidesInRange(range)) << "range " << range.GetLeft() << ", " << range.GetTop() << " to "
+                                                    << range.GetRight() << ", " << range.GetBottom();
+    }
+}
+
+// Flat and dry tiles with nothing but the surface on them, spread over the map.
+static std::vector<CoordsXYZ> FindFreeTiles(size_t count)
+{
+    std::vector<CoordsXYZ> freeTiles;
+    for (int32_t x = 1; x < gMapSize - 1; x++)
+    {
+        for (int32_t y = 1; y < gMapSize - 1; y++)
+        {
+            auto loc = TileCoordsXY{ x, y }.ToCoordsXY();
+            auto tileElement = map_get_first_element_at(loc);
+            if (tileElement == nullptr || !tileElement->IsLastForTile())
+                continue;
+
+            auto surfaceElement = tileElement->AsSurface();
+            if (surfaceElement != nullptr && surfaceElement->GetSlope() == TILE_ELEMENT_SLOPE_FLAT
+                && surfaceElement->GetWaterHeight() == 0)
+            {
+                freeTiles.emplace_back(loc, surfaceElement->GetBaseZ());
+            }
+        }
+    }
+
+    std::vector<CoordsXYZ> result;
+    for (size_t i = 0; i < count && !freeTiles.empty(); i++)
+    {
+        result.push_back(freeTiles[i * freeTiles.size() / count]);
+    }
+    return result;
+}
+
+static int32_t GetTrackElementIndex(const CoordsXY& loc, ride_id_t rideIndex)
+{
+    auto tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return -1;
+
+    int32_t index = 0;
+    do
+    {
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK && tileElement->AsTrack()->GetRideIndex() == rideIndex)
+            return index;
+        index++;
+    } while (!(tileElement++)->IsLastForTile());
+    return -1;
+}
+
+static ObjectEntryIndex LoadRideObject(uint8_t rideType)
+{
+    auto items = object_repository_get_items();
+    for (size_t i = 0; i < object_repository_get_items_count(); i++)
+    {
+        const auto& item = items[i];
+        if (item.ObjectEntry.GetType() == OBJECT_TYPE_RIDE && item.RideInfo.RideType[0] == rideType)
+        {
+            auto loadedObject = object_manager_load_object(&item.ObjectEntry);
+            if (loadedObject != nullptr)
+                return object_manager_get_loaded_object_entry_index(loadedObject);
+        }
+    }
+    return OBJECT_ENTRY_INDEX_NULL;
+}
+
+TEST(RideFootprint, incremental_updates_match_rebuild)
+{
+    auto context = StartTestGame(TestData::GetParkPath("small_park_car_ride_one_car.sv6"));
+    ASSERT_NE(context, nullptr);
+    gCheatsSandboxMode = true;
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    auto rideManager = GetRideManager();
+    auto it = std::find_if(
+        rideManager.begin(), rideManager.end(), [](auto& ride) { return ride.type == RIDE_TYPE_CAR_RIDE; });
+    ASSERT_NE(it, rideManager.end());
+    const ride_id_t carRide = (*it).id;
+
+    // Builds the grid from the loaded park.
+    std::mt19937 random(1234);
+    CheckFootprintAgainstMap(random);
+
+    auto freeTiles = FindFreeTiles(8);
+    ASSERT_EQ(freeTiles.size(), 8U);
+
+    // Track place and remove
+    for (size_t i = 0; i < 3; i++)
+    {
+        auto result = execute<TrackPlaceAction>(
+            carRide, TRACK_ELEM_FLAT, CoordsXYZD{ freeTiles[i], static_cast<Direction>(i) }, 0, 0, 0, 0, false);
+        ASSERT_EQ(result->Error, GA_ERROR::OK);
+    }
+    CheckFootprintAgainstMap(random);
+    for (size_t i = 0; i < 2; i++)
+    {
+        auto result = execute<TrackRemoveAction>(
+            TRACK_ELEM_FLAT, 0, CoordsXYZD{ freeTiles[i], static_cast<Direction>(i) });
+        ASSERT_EQ(result->Error, GA_ERROR::OK);
+    }
+    CheckFootprintAgainstMap(random);
+
+    // Maze place and remove, a maze tile with all of its corner walls is removed when it is touched.
+    auto mazeObject = LoadRideObject(RIDE_TYPE_MAZE);
+    ASSERT_NE(mazeObject, OBJECT_ENTRY_INDEX_NULL);
+    auto createResult = execute<RideCreateAction>(RIDE_TYPE_MAZE, mazeObject, 0, 0);
+    ASSERT_EQ(createResult->Error, GA_ERROR::OK);
+    const ride_id_t mazeRide = static_cast<RideCreateGameActionResult*>(createResult.get())->rideIndex;
+
+    auto result = execute<MazeSetTrackAction>(
+        CoordsXYZD{ freeTiles[3], 0 }, true, mazeRide, GC_SET_MAZE_TRACK_BUILD);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    result = execute<MazePlaceTrackAction>(freeTiles[4], mazeRide, 0xFFFF);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    CheckFootprintAgainstMap(random);
+    result = execute<MazeSetTrackAction>(CoordsXYZD{ freeTiles[4], 0 }, false, mazeRide, GC_SET_MAZE_TRACK_MOVE);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    ASSERT_EQ(GetTrackElementIndex(freeTiles[4], mazeRide), -1);
+    CheckFootprintAgainstMap(random);
+
+    // Demolish
+    result = execute<RideDemolishAction>(mazeRide, RIDE_MODIFY_DEMOLISH);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    CheckFootprintAgainstMap(random);
+
+    // Tile inspector, moving the remaining piece of track to another tile.
+    const auto trackIndex = GetTrackElementIndex(freeTiles[2], carRide);
+    ASSERT_NE(trackIndex, -1);
+    const TileElement trackElement = map_get_first_element_at(freeTiles[2])[trackIndex];
+    result = execute<TileModifyAction>(freeTiles[5], TileModifyType::AnyPaste, 0, 0, trackElement);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    CheckFootprintAgainstMap(random);
+    result = execute<TileModifyAction>(freeTiles[2], TileModifyType::AnyRemove, trackIndex);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    CheckFootprintAgainstMap(random);
+
+#ifdef ENABLE_SCRIPTING
+    // Scripting, turning a new element into track and removing the pasted track again.
+    const TileCoordsXY scriptTile{ freeTiles[6] };
+    const TileCoordsXY pastedTile{ freeTiles[5] };
+    const std::string script = "var tile = map.getTile(" + std::to_string(scriptTile.x) + ", "
+        + std::to_string(scriptTile.y) + ");" + "var element = tile.insertElement(tile.numElements);"
+        + "element.type = 'track';" + "element.ride = " + std::to_string(carRide) + ";" + "map.getTile("
+        + std::to_string(pastedTile.x) + ", " + std::to_string(pastedTile.y) + ").removeElement("
+        + std::to_string(GetTrackElementIndex(freeTiles[5], carRide)) + ");";
+    auto& scriptEngine = context->GetScriptEngine();
+    auto evaluated = scriptEngine.Eval(script);
+    scriptEngine.Update();
+    evaluated.get();
+    ASSERT_NE(GetTrackElementIndex(freeTiles[6], carRide), -1);
+    ASSERT_EQ(GetTrackElementIndex(freeTiles[5], carRide), -1);
+    CheckFootprintAgainstMap(random);
+#endif
+
+    // Demolishing a ride that still has track in the park.
+    result = execute<RideDemolishAction>(carRide, RIDE_MODIFY_DEMOLISH);
+    ASSERT_EQ(result->Error, GA_ERROR::OK);
+    CheckFootprintAgainstMap(random);
+}
+
+TEST(RideFootprint, s4_import_rebuilds_grid)
+{
+    auto context = StartTestGame(TestData::GetParkPath("small_park_car_ride_one_car.sv6"));
+    ASSERT_NE(context, nullptr);
+
+    // Builds the grid from the loaded park, the import has to replace it.
+    std::mt19937 random(1234);
+    CheckFootprintAgainstMap(random);
+
+    // The test data has no RCT1 parks, so this uses Forest Frontiers when RCT1 is installed.
+    auto env = context->GetPlatformEnvironment();
+    if (env->GetDirectoryPath(DIRBASE::RCT1).empty())
+        return;
+    auto path = Path::Combine(env->GetDirectoryPath(DIRBASE::RCT1, DIRID::SCENARIO), "SC0.SC4");
+    if (!File::Exists(path))
+        return;
+
+    auto importer = ParkImporter::CreateS4();
+    auto loadResult = importer->LoadScenario(path.c_str());
+    context->GetObjectManager().LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
+    importer->Import();
+    CheckFootprintAgainstMap(random);
+}
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
 
 #include <gtest/gtest.h>
 #include <openrct2/Cheats.h>
@@ -15,10 +16,12 @@
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkFile.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/config/Config.h>
 #include <openrct2/core/File.h>
+#include <openrct2/core/IStream.hpp>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
@@ -29,14 +32,19 @@
 #include <openrct2/ride/Ride.h>
 #include <openrct2/world/Park.h>
 #include <openrct2/world/Sprite.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
 struct GameState_t
 {
-    rct_sprite sprites[MAX_SPRITES];
+    std::vector<rct_sprite> sprites;
 };
 
 static bool LoadFileToBuffer(MemoryStream& stream, const std::string& filePath)
@@ -102,10 +110,35 @@ static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context)
     return true;
 }
 
+static bool ExportParkFile(MemoryStream& stream, std::unique_ptr<IContext>& context)
+{
+    auto& objManager = context->GetObjectManager();
+
+    auto exporter = std::make_unique<S6Exporter>();
+    exporter->ExportObjectsList = objManager.GetPackableObjects();
+    exporter->Export();
+    ParkFileExporter(*exporter).SaveGame(&stream);
+
+    return true;
+}
+
+// Creates a context and imports BigMapTest.sv6, which is left in importBuffer.
+static std::unique_ptr<IContext> LoadTestPark(MemoryStream& importBuffer)
+{
+    auto context = CreateTestContext();
+    if (context == nullptr || !LoadFileToBuffer(importBuffer, TestData::GetParkPath("BigMapTest.sv6"))
+        || !ImportSave(importBuffer, context, false))
+    {
+        return {};
+    }
+    return context;
+}
+
 static std::unique_ptr<GameState_t> GetGameState(std::unique_ptr<IContext>& context)
 {
     std::unique_ptr<GameState_t> res = std::make_unique<GameState_t>();
-    for (size_t spriteIdx = 0; spriteIdx < MAX_SPRITES; spriteIdx++)
+    res->sprites.resize(sprite_get_capacity());
+    for (size_t spriteIdx = 0; spriteIdx < res->sprites.size(); spriteIdx++)
     {
         rct_sprite* sprite = get_sprite(spriteIdx);
         if (sprite == nullptr)
@@ -457,7 +490,8 @@ static void CompareStates(
             (unsigned long long)importBuffer.GetLength(), (unsigned long long)exportBuffer.GetLength());
     }
 
-    for (size_t spriteIdx = 0; spriteIdx < MAX_SPRITES; ++spriteIdx)
+    ASSERT_EQ(importedState->sprites.size(), exportedState->sprites.size());
+    for (size_t spriteIdx = 0; spriteIdx < importedState->sprites.size(); ++spriteIdx)
     {
         if (importedState->sprites[spriteIdx].generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
             && exportedState->sprites[spriteIdx].generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -566,3 +600,265 @@ TEST(S6ImportExportAdvanceTicks, all)
 
     SUCCEED();
 }
+
+static void CompareEntityListsWithLinkedLists()
+{
+    for (int32_t i = 0; i < SPRITE_LIST_COUNT; i++)
+    {
+        std::vector<uint16_t> linkedList;
+        for (uint16_t spriteIndex = gSpriteListHead[i]; spriteIndex != SPRITE_INDEX_NULL;)
+        {
+            linkedList.push_back(spriteIndex);
+            spriteIndex = GetEntity(spriteIndex)->next;
+            ASSERT_LE(linkedList.size(), sprite_get_capacity());
+        }
+
+        std::vector<uint16_t> entityList;
+        for (auto entity : EntityList(static_cast<SPRITE_LIST>(i)))
+        {
+            entityList.push_back(entity->sprite_index);
+        }
+
+        ASSERT_EQ(entityList, linkedList) << "Sprite list " << i;
+    }
+}
+
+TEST(S6ImportExportEntityLists, all)
+{
+    MemoryStream importBuffer;
+
+    std::unique_ptr<IContext> context = LoadTestPark(importBuffer);
+    ASSERT_NE(context, nullptr);
+    CompareEntityListsWithLinkedLists();
+
+    // Sprites are created, moved between lists and removed while the game runs.
+    AdvanceGameTicks(1000, context);
+    CompareEntityListsWithLinkedLists();
+    sprite_compact_list_index();
+    CompareEntityListsWithLinkedLists();
+
+    SUCCEED();
+}
+
+// Follows the next links of the litter list like EntityList did before it iterated the dense index.
+template<typename T> class LinkedLitterList
+{
+private:
+    using Iterator = EntityIterator<T, &SpriteBase::next>;
+
+public:
+    Iterator begin()
+    {
+        return Iterator(gSpriteListHead[SPRITE_LIST_LITTER]);
+    }
+    Iterator end()
+    {
+        return Iterator(SPRITE_INDEX_NULL);
+    }
+};
+
+/**
+ * Creates a fresh litter list and iterates it, calling func(position, sprite, listOrder) for every sprite that is
+ * visited. Returns the list positions of the visited sprites, sprites that are not part of the litter list are
+ * at position 16.
+ */
+template<typename T, typename TFunc> static std::vector<size_t> VisitLitterList(bool followLinks, TFunc&& func)
+{
+    reset_sprite_list();
+    std::vector<uint16_t> listOrder;
+    for (int32_t i = 0; i < 16; i++)
+    {
+        auto* sprite = create_sprite(SPRITE_IDENTIFIER_LITTER);
+        sprite->generic.sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+        listOrder.insert(listOrder.begin(), sprite->generic.sprite_index);
+    }
+
+    std::vector<size_t> visited;
+    auto visit = [&](SpriteBase* sprite) {
+        size_t position = std::find(listOrder.begin(), listOrder.end(), sprite->sprite_index) - listOrder.begin();
+        visited.push_back(position);
+        func(position, sprite, listOrder);
+    };
+    if (followLinks)
+    {
+        for (auto sprite : LinkedLitterList<T>())
+        {
+            visit(sprite);
+        }
+    }
+    else
+    {
+        for (auto sprite : EntityList<T>(SPRITE_LIST_LITTER))
+        {
+            visit(sprite);
+        }
+    }
+    return visited;
+}
+
+TEST(S6ImportExportEntityLists, remove_while_iterating)
+{
+    std::vector<size_t> allPositions(16);
+    std::iota(allPositions.begin(), allPositions.end(), 0);
+
+    // Removing the visited sprite
+    auto removeCurrent = [](size_t, SpriteBase* sprite, const std::vector<uint16_t>&) { sprite_remove(sprite); };
+    ASSERT_EQ(VisitLitterList<Litter>(false, removeCurrent), allPositions);
+    ASSERT_EQ(gSpriteListCount[SPRITE_LIST_LITTER], 0);
+    ASSERT_EQ(VisitLitterList<Litter>(true, removeCurrent), allPositions);
+
+    // Removing a sprite further down the list
+    auto removeLater = [](size_t position, SpriteBase*, const std::vector<uint16_t>& listOrder) {
+        if (position % 4 == 0)
+        {
+            sprite_remove(GetEntity(listOrder[position + 2]));
+        }
+    };
+    std::vector<size_t> withoutLater = { 0, 1, 3, 4, 5, 7, 8, 9, 11, 12, 13, 15 };
+    ASSERT_EQ(VisitLitterList<Litter>(false, removeLater), withoutLater);
+    ASSERT_EQ(VisitLitterList<Litter>(true, removeLater), withoutLater);
+
+    // Removing the sprite that comes next, it has already been taken from the list so it is still visited, but it is
+    // no longer litter. Iteration then continues with the free list the removed sprite has moved to.
+    auto removeNext = [](size_t position, SpriteBase*, const std::vector<uint16_t>& listOrder) {
+        if (position % 2 == 0 && position + 1 < listOrder.size())
+        {
+            sprite_remove(GetEntity(listOrder[position + 1]));
+        }
+    };
+    ASSERT_EQ(VisitLitterList<Litter>(false, removeNext), std::vector<size_t>{ 0 });
+    ASSERT_EQ(VisitLitterList<Litter>(true, removeNext), std::vector<size_t>{ 0 });
+    auto indexVisited = VisitLitterList<SpriteBase>(false, removeNext);
+    ASSERT_EQ(std::vector<size_t>(indexVisited.begin(), indexVisited.begin() + 3), (std::vector<size_t>{ 0, 1, 16 }));
+    ASSERT_EQ(indexVisited, VisitLitterList<SpriteBase>(true, removeNext));
+
+    // Sprites created while iterating are not visited
+    auto createLitter = [](size_t, SpriteBase*, const std::vector<uint16_t>&) {
+        auto* sprite = create_sprite(SPRITE_IDENTIFIER_LITTER);
+        sprite->generic.sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+    };
+    ASSERT_EQ(VisitLitterList<Litter>(false, createLitter), allPositions);
+    ASSERT_EQ(gSpriteListCount[SPRITE_LIST_LITTER], 32);
+}
+
+TEST(S6ImportExportSpriteExtension, all)
+{
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<GameState_t> importedState;
+    std::unique_ptr<GameState_t> exportedState;
+
+    // Load the park and fill it with sprites beyond the RCT2 sprite limit.
+    {
+        std::unique_ptr<IContext> context = LoadTestPark(importBuffer);
+        ASSERT_NE(context, nullptr);
+        ASSERT_EQ(sprite_get_capacity(), RCT2_MAX_SPRITES);
+
+        sprite_set_limit(20000);
+        ASSERT_EQ(sprite_get_limit(), 20000);
+
+        uint16_t lastSpriteIndex = 0;
+        while (lastSpriteIndex < RCT2_MAX_SPRITES + 100)
+        {
+            auto* litter = reinterpret_cast<Litter*>(create_sprite(SPRITE_IDENTIFIER_LITTER));
+            ASSERT_NE(litter, nullptr);
+            litter->sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+            litter->type = LITTER_TYPE_EMPTY_CAN;
+            lastSpriteIndex = litter->sprite_index;
+        }
+        ASSERT_GT(sprite_get_capacity(), RCT2_MAX_SPRITES);
+        ASSERT_LE(sprite_get_capacity(), 20000);
+
+        importedState = GetGameState(context);
+        ASSERT_NE(importedState, nullptr);
+
+        ASSERT_TRUE(ExportSave(exportBuffer, context));
+    }
+
+    // Import the exported version.
+    {
+        std::unique_ptr<IContext> context = CreateTestContext();
+        ASSERT_NE(context, nullptr);
+
+        ASSERT_TRUE(ImportSave(exportBuffer, context, true));
+        ASSERT_EQ(sprite_get_limit(), 20000);
+
+        exportedState = GetGameState(context);
+        ASSERT_NE(exportedState, nullptr);
+    }
+
+    CompareStates(importBuffer, exportBuffer, importedState, exportedState);
+
+    SUCCEED();
+}
+
+TEST(S6ImportExportParkFile, all)
+{
+    MemoryStream importBuffer;
+    MemoryStream sv6Buffer;
+    MemoryStream parkBuffer;
+
+    std::unique_ptr<GameState_t> importedState;
+    std::unique_ptr<GameState_t> exportedState;
+
+    // Load initial park data and save it in both formats.
+    {
+        std::unique_ptr<IContext> context = LoadTestPark(importBuffer);
+        ASSERT_NE(context, nullptr);
+        importedState = GetGameState(context);
+        ASSERT_NE(importedState, nullptr);
+
+        ASSERT_TRUE(ExportSave(sv6Buffer, context));
+        ASSERT_TRUE(ExportParkFile(parkBuffer, context));
+    }
+
+    parkBuffer.SetPosition(0);
+    ASSERT_TRUE(ParkFileReader::IsParkFile(&parkBuffer));
+    ASSERT_LT(parkBuffer.GetLength(), sv6Buffer.GetLength());
+
+    // Import the park file version.
+    {
+        std::unique_ptr<IContext> context = CreateTestContext();
+        ASSERT_NE(context, nullptr);
+
+        ASSERT_TRUE(ImportSave(parkBuffer, context, true));
+
+        exportedState = GetGameState(context);
+        ASSERT_NE(exportedState, nullptr);
+    }
+
+    CompareStates(importBuffer, parkBuffer, importedState, exportedState);
+
+    SUCCEED();
+}
+
+TEST(S6ImportExportParkFile, section_bounds)
+{
+    std::vector<uint8_t> sectionData(4096);
+    std::iota(sectionData.begin(), sectionData.end(), 0);
+
+    MemoryStream parkBuffer;
+    ParkFileWriter writer;
+    writer.AddSection(ParkFileSection::General, 1, sectionData.data(), sectionData.size());
+    writer.Write(&parkBuffer);
+
+    // Patches the only section entry of the park file and tries to read the section back.
+    auto readPatched = [&parkBuffer](size_t fieldOffset, uint64_t value) {
+        // Patch a copy so that every check starts from the unmodified park file.
+        auto bytes = static_cast<const uint8_t*>(parkBuffer.GetData());
+        std::vector<uint8_t> patchedBytes(bytes, bytes + parkBuffer.GetLength());
+        std::memcpy(patchedBytes.data() + sizeof(ParkFileHeader) + fieldOffset, &value, sizeof(value));
+        MemoryStream patched(patchedBytes.data(), patchedBytes.size());
+        ParkFileReader reader(&patched);
+        reader.ReadSection(ParkFileSection::General);
+    };
+
+    parkBuffer.SetPosition(0);
+    ASSERT_EQ(ParkFileReader(&parkBuffer).ReadSection(ParkFileSection::General), sectionData);
+
+    // A length no compressed section of this size can inflate to is rejected before it is allocated.
+    EXPECT_THROW(readPatched(offsetof(ParkFileSectionEntry, Length), UINT64_MAX / 2), IOException);
+    EXPECT_THROW(readPatched(offsetof(ParkFileSectionEntry, CompressedLength), UINT64_MAX), IOException);
+    EXPECT_THROW(readPatched(offsetof(ParkFileSectionEntry, Offset), UINT64_MAX), IOException);
+}
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+#include "helpers/ContextHelpers.hpp"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/Crypt.h>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/world/Sprite.h>
+#include <string>
+
+using namespace OpenRCT2;
+
+#ifndef DISABLE_NETWORK
+// Copies a sprite as it goes into the checksum, returns false if the sprite is not part of the checksum.
+static bool MakeChecksumInput(uint16_t spriteIndex, rct_sprite& copy)
+{
+    copy = *get_sprite(spriteIndex);
+    if (copy.generic.sprite_identifier == SPRITE_IDENTIFIER_NULL || copy.generic.sprite_identifier == SPRITE_IDENTIFIER_MISC)
+    {
+        return false;
+    }
+
+    copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
+    copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
+    while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
+    {
+        if (nextSprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
+            break;
+        copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
+    }
+    if (copy.generic.Is<Peep>())
+    {
+        copy.peep.Name = {};
+        copy.peep.WindowInvalidateFlags = 0;
+    }
+    return true;
+}
+
+// The sprite checksum as computed by copying every sprite into one hash.
+static rct_sprite_checksum FlatSpriteChecksum()
+{
+    auto hashAlg = Crypt::CreateSHA1();
+    for (uint16_t i = 0; i < sprite_get_capacity(); i++)
+    {
+        rct_sprite copy;
+        if (MakeChecksumInput(i, copy))
+        {
+            hashAlg->Update(&copy, sizeof(copy));
+        }
+    }
+
+    rct_sprite_checksum checksum;
+    checksum.raw = hashAlg->Finish();
+    return checksum;
+}
+
+// The sprite checksum as computed by hashing the hashes of every block of 256 sprites.
+static rct_sprite_checksum BlockSpriteChecksum()
+{
+    constexpr uint16_t blockSize = 256;
+    auto hashAlg = Crypt::CreateSHA1();
+    auto blockHashAlg = Crypt::CreateSHA1();
+    for (uint16_t blockStart = 0; blockStart < sprite_get_capacity(); blockStart += blockSize)
+    {
+        blockHashAlg->Clear();
+        for (uint16_t i = blockStart; i < blockStart + blockSize && i < sprite_get_capacity(); i++)
+        {
+            rct_sprite copy;
+            if (MakeChecksumInput(i, copy))
+            {
+                blockHashAlg->Update(&copy, sizeof(copy));
+            }
+        }
+        auto blockHash = blockHashAlg->Finish();
+        hashAlg->Update(blockHash.data(), blockHash.size());
+    }
+
+    rct_sprite_checksum checksum;
+    checksum.raw = hashAlg->Finish();
+    return checksum;
+}
+#endif
+
+TEST(SpriteChecksum, incremental)
+{
+    auto context = StartTestGame(TestData::GetParkPath("BigMapTest.sv6"));
+    ASSERT_NE(context, nullptr);
+
+    // Only blocks with modified sprites are hashed again, the result must match hashing every sprite. The flat
+    // checksum must stay the hash that replays recorded before the block checksum was added.
+    for (int32_t i = 0; i < 100; i++)
+    {
+        AdvanceGameTicks(10, *context);
+        auto incremental = sprite_checksum();
+#ifndef DISABLE_NETWORK
+        ASSERT_EQ(incremental.ToString(), BlockSpriteChecksum().ToString()) << "Tick " << gCurrentTicks;
+        ASSERT_EQ(sprite_checksum(SpriteChecksumVersion::Flat).ToString(), FlatSpriteChecksum().ToString())
+            << "Tick " << gCurrentTicks;
+        ASSERT_EQ(sprite_checksum().ToString(), incremental.ToString()) << "Tick " << gCurrentTicks;
+#endif
+    }
+
+    // Fields written directly rather than through the sprite functions are noticed as well.
+    auto peep = *EntityList<Peep>(SPRITE_LIST_PEEP).begin();
+    ASSERT_NE(peep, nullptr);
+    auto before = sprite_checksum();
+    peep->Energy++;
+    auto after = sprite_checksum();
+    ASSERT_NE(before.ToString(), after.ToString());
+#ifndef DISABLE_NETWORK
+    ASSERT_EQ(after.ToString(), BlockSpriteChecksum().ToString());
+#endif
+
+    SUCCEED();
+}
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/object/ObjectManager.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Scenery.h>
+#include <openrct2/world/Sprite.h>
+#include <string>
+
+/**
+ * Creates a headless context, returns nullptr if it can not be initialised.
+ */
+inline std::unique_ptr<OpenRCT2::IContext> CreateTestContext()
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = OpenRCT2::CreateContext();
+    if (!context->Initialise())
+        return {};
+    return context;
+}
+
+/**
+ * Creates a headless context and loads the saved game at parkPath into it, the same way the game does.
+ */
+inline std::unique_ptr<OpenRCT2::IContext> StartTestGame(const std::string& parkPath)
+{
+    auto context = CreateTestContext();
+    if (context == nullptr)
+        return {};
+
+    auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+    auto loadResult = importer->LoadSavedGame(parkPath.c_str(), false);
+    context->GetObjectManager().LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
+    importer->Import();
+
+    reset_sprite_spatial_index();
+
+    reset_all_sprite_quadrant_placements();
+    scenery_set_default_placement_configuration();
+    load_palette();
+    map_reorganise_elements();
+    sprite_position_tween_reset();
+    AutoCreateMapAnimations();
+    fix_invalid_vehicle_sprite_sizes();
+
+    gGameSpeed = 1;
+
+    return context;
+}
+
+inline void AdvanceGameTicks(uint32_t ticks, OpenRCT2::IContext& context)
+{
+    auto* gameState = context.GetGameState();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        gameState->UpdateLogic();
+    }
+}
@@ -10,7 +10,9 @@
 #include <gtest/gtest.h>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/rct12/SawyerChunkReader.h>
+#include <openrct2/rct12/SawyerChunkWriter.h>
 #include <openrct2/util/SawyerCoding.h>
+#include <vector>
 
 constexpr size_t BUFFER_SIZE = 0x600000;
 
@@ -81,6 +83,39 @@ TEST_F(SawyerCodingTest, write_read_chunk_rotate)
     test_encode_decode(CHUNK_ENCODING_ROTATE);
 }
 
+TEST_F(SawyerCodingTest, write_chunks_matches_write_chunk)
+{
+    // Large chunks of repeating data, like the tile elements of a save, next to small random ones
+    std::vector<uint8_t> largeData(0x300000);
+    for (size_t i = 0; i < largeData.size(); i++)
+    {
+        largeData[i] = static_cast<uint8_t>((i / 37) ^ (i % 7 == 0 ? randomdata[i % sizeof(randomdata)] : 0));
+    }
+
+    std::vector<SawyerChunkSource> chunks;
+    for (auto encoding : { CHUNK_ENCODING_NONE, CHUNK_ENCODING_RLE, CHUNK_ENCODING_RLECOMPRESSED, CHUNK_ENCODING_ROTATE })
+    {
+        chunks.push_back({ randomdata, sizeof(randomdata), static_cast<SAWYER_ENCODING>(encoding) });
+        chunks.push_back({ largeData.data(), largeData.size(), static_cast<SAWYER_ENCODING>(encoding) });
+    }
+
+    MemoryStream serialStream;
+    SawyerChunkWriter serialWriter(&serialStream);
+    for (const auto& chunk : chunks)
+    {
+        serialWriter.WriteChunk(chunk.Data, chunk.Length, chunk.Encoding);
+    }
+
+    MemoryStream concurrentStream;
+    SawyerChunkWriter concurrentWriter(&concurrentStream);
+    size_t lastReport = 0;
+    concurrentWriter.WriteChunks(chunks, [&lastReport](size_t encodedLength) { lastReport = encodedLength; });
+
+    ASSERT_EQ(concurrentStream.GetLength(), serialStream.GetLength());
+    ASSERT_EQ(std::memcmp(concurrentStream.GetData(), serialStream.GetData(), serialStream.GetLength()), 0);
+    ASSERT_EQ(lastReport, 4 * (sizeof(randomdata) + largeData.size()));
+}
+
 // Note we only check if provided data decompresses to the same data, not if it compresses the same.
 // The reason for that is we may improve encoding at some point, but the test won't be affected,
 // as we already do a decode test and rountrip (encode + decode), which validates all uses.